@@ -784,14 +784,6 @@ SOURCE=..\Common\Triggers\Trigger_ReSpawning.h
 # End Source File
 # Begin Source File
 
-SOURCE=.\triggers\Trigger_SoundNotify.cpp
-# End Source File
-# Begin Source File
-
-SOURCE=.\triggers\Trigger_SoundNotify.h
-# End Source File
-# Begin Source File
-
 SOURCE=.\triggers\Trigger_WeaponGiver.cpp
 # End Source File
 # Begin Source File
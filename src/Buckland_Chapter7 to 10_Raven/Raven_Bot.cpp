@@ -27,28 +27,29 @@
 Raven_Bot::Raven_Bot(Raven_Game* world, Vector2D pos, std::string nameTeam):
 
   MovingEntity(pos,
-               script->GetDouble("Bot_Scale"),
+               script->Params().Bot_Scale,
                Vector2D(0,0),
-               script->GetDouble("Bot_MaxSpeed"),
+               script->Params().Bot_MaxSpeed,
                Vector2D(1,0),
-               script->GetDouble("Bot_Mass"),
-               Vector2D(script->GetDouble("Bot_Scale"),script->GetDouble("Bot_Scale")),
-               script->GetDouble("Bot_MaxHeadTurnRate"),
-               script->GetDouble("Bot_MaxForce")),
+               script->Params().Bot_Mass,
+               Vector2D(script->Params().Bot_Scale,script->Params().Bot_Scale),
+               script->Params().Bot_MaxHeadTurnRate,
+               script->Params().Bot_MaxForce),
                  
-                 m_iMaxHealth(script->GetInt("Bot_MaxHealth")),
-                 m_iHealth(script->GetInt("Bot_MaxHealth")),
+                 m_iMaxHealth(script->Params().Bot_MaxHealth),
+                 m_iHealth(script->Params().Bot_MaxHealth),
                  m_pPathPlanner(NULL),
                  m_pSteering(NULL),
                  m_pWorld(world),
                  m_pBrain(NULL),
-                 m_iNumUpdatesHitPersistant((int)(FrameRate * script->GetDouble("HitFlashTime"))),
+                 m_iNumUpdatesHitPersistant((int)(FrameRate * script->Params().HitFlashTime)),
                  m_bHit(false),
                  m_iScore(0),
                  m_Status(spawning),
                  m_bPossessed(false),
+                 m_iSlot(-1),
 				 m_sNameTeam(nameTeam),  // Nom de la team du bot
-                 m_dFieldOfView(DegsToRads(script->GetDouble("Bot_FOV"))),
+                 m_dFieldOfView(DegsToRads(script->Params().Bot_FOV)),
 				 m_pRavenBotLeader(0) // Leader
            
 {
@@ -71,11 +72,11 @@ Raven_Bot::Raven_Bot(Raven_Game* world, Vector2D pos, std::string nameTeam):
   m_pSteering = new Raven_Steering(world, this);
 
   //create the regulators
-  m_pWeaponSelectionRegulator = new Regulator(script->GetDouble("Bot_WeaponSelectionFrequency"));
-  m_pGoalArbitrationRegulator =  new Regulator(script->GetDouble("Bot_GoalAppraisalUpdateFreq"));
-  m_pTargetSelectionRegulator = new Regulator(script->GetDouble("Bot_TargetingUpdateFreq"));
-  m_pTriggerTestRegulator = new Regulator(script->GetDouble("Bot_TriggerUpdateFreq"));
-  m_pVisionUpdateRegulator = new Regulator(script->GetDouble("Bot_VisionUpdateFreq"));
+  m_pWeaponSelectionRegulator = new Regulator(script->Params().Bot_WeaponSelectionFrequency);
+  m_pGoalArbitrationRegulator =  new Regulator(script->Params().Bot_GoalAppraisalUpdateFreq);
+  m_pTargetSelectionRegulator = new Regulator(script->Params().Bot_TargetingUpdateFreq);
+  m_pTriggerTestRegulator = new Regulator(script->Params().Bot_TriggerUpdateFreq);
+  m_pVisionUpdateRegulator = new Regulator(script->Params().Bot_VisionUpdateFreq);
 
   //create the goal queue
   m_pBrain = new Goal_Think(this);
@@ -84,11 +85,35 @@ Raven_Bot::Raven_Bot(Raven_Game* world, Vector2D pos, std::string nameTeam):
   m_pTargSys = new Raven_TargetingSystem(this);
 
   m_pWeaponSys = new Raven_WeaponSystem(this,
-                                        script->GetDouble("Bot_ReactionTime"),
-                                        script->GetDouble("Bot_AimAccuracy"),
-                                        script->GetDouble("Bot_AimPersistance"));
+                                        script->Params().Bot_ReactionTime,
+                                        script->Params().Bot_AimAccuracy,
+                                        script->Params().Bot_AimPersistance);
 
-  m_pSensoryMem = new Raven_SensoryMemory(this, script->GetDouble("Bot_MemorySpan"));
+  m_pSensoryMem = new Raven_SensoryMemory(this, script->Params().Bot_MemorySpan);
+}
+
+//---------------------------- ApplyParams ------------------------------------
+//-----------------------------------------------------------------------------
+void Raven_Bot::ApplyParams(const Raven_Params& params)
+{
+  SetMaxTurnRate(params.Bot_MaxHeadTurnRate);
+  SetMaxForce(params.Bot_MaxForce);
+
+  m_dFieldOfView = DegsToRads(params.Bot_FOV);
+
+  m_pWeaponSelectionRegulator->SetFrequency(params.Bot_WeaponSelectionFrequency);
+  m_pGoalArbitrationRegulator->SetFrequency(params.Bot_GoalAppraisalUpdateFreq);
+  m_pTargetSelectionRegulator->SetFrequency(params.Bot_TargetingUpdateFreq);
+  m_pTriggerTestRegulator->SetFrequency(params.Bot_TriggerUpdateFreq);
+  m_pVisionUpdateRegulator->SetFrequency(params.Bot_VisionUpdateFreq);
+
+  m_pWeaponSys->SetAimParams(params.Bot_ReactionTime,
+                             params.Bot_AimAccuracy,
+                             params.Bot_AimPersistance);
+
+  m_pSensoryMem->SetMemorySpan(params.Bot_MemorySpan);
+
+  m_pSteering->ApplyParams(params);
 }
 
 //-------------------------------- dtor ---------------------------------------
@@ -342,30 +367,6 @@ bool Raven_Bot::HandleMessage(const Telegram& msg)
 
     return true;
 
-  case Msg_GunshotSound:
-
-    //add the source of this sound to the bot's percepts
-    GetSensoryMem()->UpdateWithSoundSource((Raven_Bot*)msg.ExtraInfo);
-
-    return true;
-
-  case Msg_UserHasRemovedBot:
-    {
-
-      Raven_Bot* pRemovedBot = (Raven_Bot*)msg.ExtraInfo;
-
-      GetSensoryMem()->RemoveBotFromMemory(pRemovedBot);
-
-      //if the removed bot is the target, make sure the target is cleared
-      if (pRemovedBot == GetTargetSys()->GetTarget())
-      {
-        GetTargetSys()->ClearTarget();
-      }
-
-      return true;
-    }
-
-
   case Msg_YouHitMe: // Indique  un leader qu'il a touch une cible
   {
 	  if (m_bPossessed)
@@ -475,7 +476,7 @@ void Raven_Bot::ReduceHealth(unsigned int val)
 
   m_bHit = true;
 
-  m_iNumUpdatesHitPersistant = (int)(FrameRate * script->GetDouble("HitFlashTime"));
+  m_iNumUpdatesHitPersistant = (int)(FrameRate * script->Params().HitFlashTime);
 }
 
 //--------------------------- Possess -----------------------------------------
@@ -690,7 +691,7 @@ void Raven_Bot::SetUpVertexBuffer()
                                      Vector2D(-3,-8)};
 
   m_dBoundingRadius = 0.0;
-  double scale = script->GetDouble("Bot_Scale");
+  double scale = script->Params().Bot_Scale;
   
   for (int vtx=0; vtx<NumBotVerts; ++vtx)
   {
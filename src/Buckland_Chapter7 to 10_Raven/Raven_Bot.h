@@ -30,6 +30,7 @@ class Raven_Bot;
 class Goal_Think;
 class Raven_WeaponSystem;
 class Raven_SensoryMemory;
+struct Raven_Params;
 
 
 
@@ -111,6 +112,11 @@ protected:
   //set to true when a human player takes over control of the bot
   bool                               m_bPossessed;
 
+  //a small index, unique among the bots currently in the game, assigned by
+  //Raven_Game when the bot is added. Other bots use it to index their
+  //per-opponent data. (-1 until assigned)
+  int                                m_iSlot;
+
   // Nom de la team du bot pour reconnaitres ses confreres, s'il en a une, sinon il est vide
   std::string						 m_sNameTeam;
 
@@ -156,6 +162,13 @@ public:
   void         Render();
   void         Update();
   bool         HandleMessage(const Telegram& msg);
+
+  //hands the bot the tunable parameters from a reloaded Params.ini: its
+  //turn rate, steering force and field of view, how often it thinks, aims
+  //and looks around, its aiming skill, memory span and steering weights.
+  //(Its max speed is switched between values by its goals, which read
+  //them when they do so)
+  void         ApplyParams(const Raven_Params& params);
   void         Write(std::ostream&  os)const{/*not implemented*/}
   void         Read (std::ifstream& is){/*not implemented*/}
 
@@ -177,6 +190,12 @@ public:
   double        FieldOfView()const{return m_dFieldOfView;}
 
   bool          isPossessed()const{return m_bPossessed;}
+
+  //true for a short time after the bot has been hit
+  bool          isHit()const{return m_bHit;}
+
+  int           Slot()const{return m_iSlot;}
+  void          SetSlot(int slot){m_iSlot = slot;}
   bool          isDead()const{return m_Status == dead;}
   bool          isAlive()const{return m_Status == alive;}
   bool          isSpawning()const{return m_Status == spawning;}
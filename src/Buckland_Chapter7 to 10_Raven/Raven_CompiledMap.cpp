@@ -0,0 +1,338 @@
+#include "Raven_CompiledMap.h"
+
+#include <windows.h>
+#include <cstring>
+
+
+//the first bytes of every compiled map
+static const char CompiledMapMagic[4] = {'R', 'V', 'M', 'C'};
+
+static size_t Align8(size_t n){return (n + 7) & ~(size_t)7;}
+
+
+//------------------------------- ctor ----------------------------------------
+//-----------------------------------------------------------------------------
+Raven_CompiledMap::Raven_CompiledMap():m_pView(NULL),
+                                       m_hFile(INVALID_HANDLE_VALUE),
+                                       m_hMapping(NULL),
+                                       m_pHeader(NULL),
+                                       m_pNodes(NULL),
+                                       m_pEdgeOffsets(NULL),
+                                       m_pEdges(NULL),
+                                       m_pPathCosts(NULL),
+                                       m_pRoutes(NULL)
+{}
+
+//-------------------------- CompiledFileName ---------------------------------
+//-----------------------------------------------------------------------------
+std::string Raven_CompiledMap::CompiledFileName(const std::string& MapFile)
+{
+  return MapFile + ".bin";
+}
+
+//------------------------------- Layout --------------------------------------
+//-----------------------------------------------------------------------------
+size_t Raven_CompiledMap::Layout(int     NumNodes,
+                                 int     NumEdges,
+                                 size_t  CostsSize,
+                                 size_t  RoutesSize,
+                                 size_t& NodesAt,
+                                 size_t& OffsetsAt,
+                                 size_t& EdgesAt,
+                                 size_t& CostsAt,
+                                 size_t& RoutesAt)
+{
+  NodesAt   = Align8(sizeof(Header));
+  OffsetsAt = Align8(NodesAt   + NumNodes * sizeof(NodeRecord));
+  EdgesAt   = Align8(OffsetsAt + (NumNodes+1) * sizeof(int));
+  CostsAt   = Align8(EdgesAt   + NumEdges * sizeof(EdgeRecord));
+  RoutesAt  = Align8(CostsAt   + CostsSize);
+
+  return RoutesAt + RoutesSize;
+}
+
+//--------------------------- HashSourceFile ----------------------------------
+//
+//  FNV-1a over the bytes of the text map
+//-----------------------------------------------------------------------------
+bool Raven_CompiledMap::HashSourceFile(const std::string& MapFile,
+                                       unsigned int&      size,
+                                       unsigned int&      hash)
+{
+  std::ifstream in(MapFile.c_str(), std::ios::binary);
+
+  if (!in) return false;
+
+  std::vector<char> buffer((std::istreambuf_iterator<char>(in)),
+                            std::istreambuf_iterator<char>());
+
+  size = (unsigned int)buffer.size();
+  hash = 2166136261u;
+
+  for (unsigned int i=0; i<buffer.size(); ++i)
+  {
+    hash = (hash ^ (unsigned char)buffer[i]) * 16777619u;
+  }
+
+  return true;
+}
+
+//-------------------------------- Open ---------------------------------------
+//-----------------------------------------------------------------------------
+bool Raven_CompiledMap::Open(const std::string& MapFile)
+{
+  Close();
+
+  unsigned int SourceSize, SourceHash;
+
+  if (!HashSourceFile(MapFile, SourceSize, SourceHash)) return false;
+
+  std::string FileName = CompiledFileName(MapFile);
+
+  m_hFile = CreateFileA(FileName.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL,
+                        OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+
+  if (m_hFile == INVALID_HANDLE_VALUE) return false;
+
+  DWORD FileSize = GetFileSize(m_hFile, NULL);
+
+  if (FileSize == INVALID_FILE_SIZE || FileSize < sizeof(Header))
+  {
+    Close(); return false;
+  }
+
+  m_hMapping = CreateFileMappingA(m_hFile, NULL, PAGE_READONLY, 0, 0, NULL);
+
+  if (!m_hMapping)
+  {
+    Close(); return false;
+  }
+
+  m_pView = MapViewOfFile(m_hMapping, FILE_MAP_READ, 0, 0, 0);
+
+  if (!m_pView)
+  {
+    Close(); return false;
+  }
+
+  const char* base = (const char*)m_pView;
+
+  m_pHeader = (const Header*)base;
+
+  //make sure the file is a compiled map of this version, built from the
+  //map as it is now
+  if (memcmp(m_pHeader->Magic, CompiledMapMagic, sizeof(CompiledMapMagic)) != 0 ||
+      m_pHeader->Version    != Version    ||
+      m_pHeader->SourceSize != SourceSize ||
+      m_pHeader->SourceHash != SourceHash ||
+      m_pHeader->NumNodes < 0 || m_pHeader->NumEdges < 0)
+  {
+    Close(); return false;
+  }
+
+  typedef Raven_Map::PathCosts PathCosts;
+
+  size_t CostsSize = 0;
+
+  if (m_pHeader->HasPathCosts)
+  {
+    if ((m_pHeader->PathCostLayout != PathCosts::full &&
+         m_pHeader->PathCostLayout != PathCosts::triangular) ||
+        (m_pHeader->PathCostPrecision != PathCosts::double_precision &&
+         m_pHeader->PathCostPrecision != PathCosts::single_precision))
+    {
+      Close(); return false;
+    }
+
+    CostsSize = PathCosts::StoredSize(m_pHeader->NumNodes,
+                                      PathCostLayout(),
+                                      PathCostPrecision());
+  }
+
+  size_t RoutesSize = 0;
+
+  if (m_pHeader->HasRoutes)
+  {
+    RoutesSize = (size_t)m_pHeader->NumNodes * m_pHeader->NumNodes * sizeof(unsigned short);
+  }
+
+  size_t NodesAt, OffsetsAt, EdgesAt, CostsAt, RoutesAt;
+
+  if (Layout(m_pHeader->NumNodes, m_pHeader->NumEdges, CostsSize, RoutesSize,
+             NodesAt, OffsetsAt, EdgesAt, CostsAt, RoutesAt) != FileSize)
+  {
+    Close(); return false;
+  }
+
+  m_pNodes       = (const NodeRecord*)(base + NodesAt);
+  m_pEdgeOffsets = (const int*)(base + OffsetsAt);
+  m_pEdges       = (const EdgeRecord*)(base + EdgesAt);
+  m_pPathCosts   = m_pHeader->HasPathCosts ? (const void*)(base + CostsAt) : NULL;
+  m_pRoutes      = m_pHeader->HasRoutes ? (const unsigned short*)(base + RoutesAt) : NULL;
+
+  return true;
+}
+
+//-------------------------------- Close --------------------------------------
+//-----------------------------------------------------------------------------
+void Raven_CompiledMap::Close()
+{
+  if (m_pView)    UnmapViewOfFile(m_pView);
+  if (m_hMapping) CloseHandle(m_hMapping);
+  if (m_hFile != INVALID_HANDLE_VALUE) CloseHandle(m_hFile);
+
+  m_pView    = NULL;
+  m_hMapping = NULL;
+  m_hFile    = INVALID_HANDLE_VALUE;
+
+  m_pHeader      = NULL;
+  m_pNodes       = NULL;
+  m_pEdgeOffsets = NULL;
+  m_pEdges       = NULL;
+  m_pPathCosts   = NULL;
+  m_pRoutes      = NULL;
+}
+
+//-------------------------------- Write --------------------------------------
+//-----------------------------------------------------------------------------
+bool Raven_CompiledMap::Write(const std::string&                MapFile,
+                              const Raven_Map::NavGraph&        graph,
+                              const Raven_Map::PathCosts&       PathCosts,
+                              const Raven_Map::Routes&          routes,
+                              int                               SizeX,
+                              int                               SizeY,
+                              int                               EntityOffset)
+{
+  typedef Raven_Map::NavGraph NavGraph;
+
+  Header header;
+
+  memset(&header, 0, sizeof(header));
+  memcpy(header.Magic, CompiledMapMagic, sizeof(CompiledMapMagic));
+
+  header.Version      = Version;
+  header.NumNodes     = graph.NumNodes();
+  header.NumEdges     = graph.NumEdges();
+  header.SizeX        = SizeX;
+  header.SizeY        = SizeY;
+  header.EntityOffset = EntityOffset;
+  header.HasPathCosts = PathCosts.StoredCosts() ? 1 : 0;
+
+  header.PathCostLayout    = PathCosts.Layout();
+  header.PathCostPrecision = PathCosts.Precision();
+
+  header.HasRoutes    = routes.Entries() ? 1 : 0;
+
+  if (!HashSourceFile(MapFile, header.SourceSize, header.SourceHash)) return false;
+
+  size_t CostsSize = 0;
+
+  if (header.HasPathCosts)
+  {
+    CostsSize = Raven_Map::PathCosts::StoredSize(header.NumNodes,
+                                                 PathCosts.Layout(),
+                                                 PathCosts.Precision());
+  }
+
+  size_t RoutesSize = 0;
+
+  if (header.HasRoutes)
+  {
+    RoutesSize = (size_t)header.NumNodes * header.NumNodes * sizeof(unsigned short);
+  }
+
+  size_t NodesAt, OffsetsAt, EdgesAt, CostsAt, RoutesAt;
+  size_t FileSize = Layout(header.NumNodes, header.NumEdges, CostsSize, RoutesSize,
+                           NodesAt, OffsetsAt, EdgesAt, CostsAt, RoutesAt);
+
+  //build the image in memory and write it in one go
+  std::vector<char> image(FileSize, 0);
+  char* base = &image[0];
+
+  memcpy(base, &header, sizeof(header));
+
+  NodeRecord* nodes   = (NodeRecord*)(base + NodesAt);
+  int*        offsets = (int*)(base + OffsetsAt);
+  EdgeRecord* edges   = (EdgeRecord*)(base + EdgesAt);
+
+  int NumEdgesWritten = 0;
+
+  for (int n=0; n<header.NumNodes; ++n)
+  {
+    const NavGraph::NodeType& node = graph.GetNode(n);
+
+    nodes[n].x     = node.Pos().x;
+    nodes[n].y     = node.Pos().y;
+    nodes[n].Index = node.Index();
+
+    offsets[n] = NumEdgesWritten;
+
+    NavGraph::ConstEdgeIterator EdgeItr(graph, n);
+    for (const NavGraph::EdgeType* pE=EdgeItr.begin(); !EdgeItr.end(); pE=EdgeItr.next())
+    {
+      EdgeRecord& e = edges[NumEdgesWritten++];
+
+      e.Cost                   = pE->Cost();
+      e.To                     = pE->To();
+      e.Flags                  = pE->Flags();
+      e.IDofIntersectingEntity = pE->IDofIntersectingEntity();
+    }
+  }
+
+  offsets[header.NumNodes] = NumEdgesWritten;
+
+  assert (NumEdgesWritten == header.NumEdges && "<Raven_CompiledMap::Write>: edge count mismatch");
+
+  if (header.HasPathCosts)
+  {
+    memcpy(base + CostsAt, PathCosts.StoredCosts(), CostsSize);
+  }
+
+  if (header.HasRoutes)
+  {
+    memcpy(base + RoutesAt, routes.Entries(), RoutesSize);
+  }
+
+  std::ofstream out(CompiledFileName(MapFile).c_str(), std::ios::binary);
+
+  if (!out) return false;
+
+  out.write(base, FileSize);
+
+  return out.good();
+}
+
+//--------------------------- CreateNavGraph ----------------------------------
+//-----------------------------------------------------------------------------
+void Raven_CompiledMap::CreateNavGraph(Raven_Map::NavGraph& graph)const
+{
+  assert (m_pHeader && graph.NumNodes() == 0 &&
+          "<Raven_CompiledMap::CreateNavGraph>: no compiled map or graph not empty");
+
+  const int NumNodes = m_pHeader->NumNodes;
+
+  //every node is added with its slot's index first. Those that were inactive
+  //in the compiled graph are then removed again (they have no edges yet)
+  for (int n=0; n<NumNodes; ++n)
+  {
+    graph.AddNode(Raven_Map::GraphNode(n, Vector2D(m_pNodes[n].x, m_pNodes[n].y)));
+  }
+
+  for (int n=0; n<NumNodes; ++n)
+  {
+    if (m_pNodes[n].Index == invalid_node_index) graph.RemoveNode(n);
+  }
+
+  //the edge lists are copied exactly, preserving their order
+  for (int n=0; n<NumNodes; ++n)
+  {
+    for (int e=m_pEdgeOffsets[n]; e<m_pEdgeOffsets[n+1]; ++e)
+    {
+      graph.AppendEdge(NavGraphEdge(n,
+                                    m_pEdges[e].To,
+                                    m_pEdges[e].Cost,
+                                    m_pEdges[e].Flags,
+                                    m_pEdges[e].IDofIntersectingEntity));
+    }
+  }
+}
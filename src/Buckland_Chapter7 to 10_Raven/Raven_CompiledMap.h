@@ -0,0 +1,177 @@
+#ifndef RAVEN_COMPILEDMAP_H
+#define RAVEN_COMPILEDMAP_H
+#pragma warning (disable:4786)
+//-----------------------------------------------------------------------------
+//
+//  Name:   Raven_CompiledMap.h
+//
+//  Desc:   the compiled form of a Raven map file. Loading a text map means
+//          parsing its navgraph and then running a Dijkstra search from
+//          every node to build the path cost table and the routing table.
+//          The results are written to a binary file next to the map
+//          (<map>.bin) which later loads memory-map instead.
+//
+//          The compiled file is keyed on the size and a hash of the text
+//          map, so editing the map simply causes it to be rebuilt. The
+//          entities (walls, doors, triggers, spawn points) are cheap to
+//          create and are still read from the text map, starting at the
+//          offset recorded in the compiled file.
+//
+//          Layout (native byte order, each section 8 byte aligned):
+//
+//            Header
+//            NodeRecord   nodes[NumNodes]
+//            int          edge offsets[NumNodes+1]  (CSR: node n's edges
+//                                                    are [off[n], off[n+1]))
+//            EdgeRecord   edges[NumEdges]
+//            path costs                             (only if HasPathCosts)
+//            unsigned short next hops[NumNodes*NumNodes]
+//                                                   (only if HasRoutes)
+//
+//          The path costs are written as the table holds them (see
+//          PathCostTable::StoredCosts), in the layout and precision recorded
+//          in the header, so a triangular table of floats takes a quarter of
+//          the space of a full one of doubles. They are left out when the map
+//          was loaded with an on demand cost table. A load wanting a
+//          different layout converts the costs, unless they were stored as
+//          floats and doubles are wanted, in which case the table is
+//          rebuilt and the map compiled again. The next hops are the
+//          routing table's entries (see NextHopTable::Entries), left out
+//          when the map had too many nodes for one to be built
+//
+//-----------------------------------------------------------------------------
+#include <string>
+#include <vector>
+#include <fstream>
+
+#include "Raven_Map.h"
+
+
+class Raven_CompiledMap
+{
+public:
+
+  enum {Version = 4};
+
+  struct Header
+  {
+    char          Magic[4];
+    int           Version;
+    unsigned int  SourceSize;
+    unsigned int  SourceHash;
+    int           NumNodes;
+    int           NumEdges;
+    int           SizeX;
+    int           SizeY;
+    int           EntityOffset;
+    int           HasPathCosts;
+    int           PathCostLayout;
+    int           PathCostPrecision;
+    int           HasRoutes;
+    int           Pad;
+  };
+
+  struct NodeRecord
+  {
+    double  x;
+    double  y;
+    int     Index;
+    int     Pad;
+  };
+
+  struct EdgeRecord
+  {
+    double  Cost;
+    int     To;
+    int     Flags;
+    int     IDofIntersectingEntity;
+    int     Pad;
+  };
+
+private:
+
+  //the mapping of the compiled file (null if none is open)
+  void*              m_pView;
+  void*              m_hFile;
+  void*              m_hMapping;
+
+  //pointers to the sections of the mapped file
+  const Header*      m_pHeader;
+  const NodeRecord*  m_pNodes;
+  const int*         m_pEdgeOffsets;
+  const EdgeRecord*  m_pEdges;
+  const void*        m_pPathCosts;
+  const unsigned short* m_pRoutes;
+
+  //the size of the file needed to hold a map of the given dimensions, and
+  //the offsets of its sections
+  static size_t      Layout(int NumNodes, int NumEdges, size_t CostsSize,
+                            size_t RoutesSize,
+                            size_t& NodesAt, size_t& OffsetsAt,
+                            size_t& EdgesAt, size_t& CostsAt,
+                            size_t& RoutesAt);
+
+  //reads the text map and hashes it
+  static bool        HashSourceFile(const std::string& MapFile,
+                                    unsigned int&      size,
+                                    unsigned int&      hash);
+
+  Raven_CompiledMap(const Raven_CompiledMap&);
+  Raven_CompiledMap& operator=(const Raven_CompiledMap&);
+
+public:
+
+  Raven_CompiledMap();
+  ~Raven_CompiledMap(){Close();}
+
+  //the name of the compiled file for the given map
+  static std::string CompiledFileName(const std::string& MapFile);
+
+  //maps the compiled file for the map. Returns false if there isn't one or
+  //if it is out of date with respect to the text map
+  bool Open(const std::string& MapFile);
+
+  void Close();
+
+  //writes the compiled form of a map that has just been loaded from text.
+  //The path costs are only written if the table is complete, and the
+  //routes only if they were built
+  static bool Write(const std::string&                MapFile,
+                    const Raven_Map::NavGraph&        graph,
+                    const Raven_Map::PathCosts&       PathCosts,
+                    const Raven_Map::Routes&          routes,
+                    int                               SizeX,
+                    int                               SizeY,
+                    int                               EntityOffset);
+
+  //rebuilds the navgraph held in the compiled file into graph (which must
+  //be empty)
+  void CreateNavGraph(Raven_Map::NavGraph& graph)const;
+
+
+  int           NumNodes()const{return m_pHeader->NumNodes;}
+  int           SizeX()const{return m_pHeader->SizeX;}
+  int           SizeY()const{return m_pHeader->SizeY;}
+  int           EntityOffset()const{return m_pHeader->EntityOffset;}
+
+  //the stored path costs (see PathCostTable::StoredCosts) and how they are
+  //held, or NULL if the file doesn't hold any
+  const void*   PathCosts()const{return m_pPathCosts;}
+
+  Raven_Map::PathCosts::layout    PathCostLayout()const
+  {
+    return (Raven_Map::PathCosts::layout)m_pHeader->PathCostLayout;
+  }
+
+  Raven_Map::PathCosts::precision PathCostPrecision()const
+  {
+    return (Raven_Map::PathCosts::precision)m_pHeader->PathCostPrecision;
+  }
+
+  //the stored routing table (see NextHopTable::Entries), or NULL if the
+  //file doesn't hold one
+  const unsigned short* Routes()const{return m_pRoutes;}
+};
+
+
+#endif
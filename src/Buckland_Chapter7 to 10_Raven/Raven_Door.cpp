@@ -13,6 +13,7 @@ Raven_Door::Raven_Door(Raven_Map* pMap,
 
                                   BaseGameEntity(GetValueFromStream<int>(is)),
                                   m_Status(closed),
+                                  m_pMap(pMap),
                                   m_iNumTicksStayOpen(60)                   //MGC!
 {
   Read(is);
@@ -23,8 +24,8 @@ Raven_Door::Raven_Door(Raven_Map* pMap,
   Vector2D perp = m_vtoP2Norm.Perp();
   
   //create the walls that make up the door's geometry
-  m_pWall1 = pMap->AddWall(m_vP1+perp, m_vP2+perp);
-  m_pWall2 = pMap->AddWall(m_vP2-perp, m_vP1-perp);
+  m_pWall1 = pMap->AddWall(m_vP1+perp, m_vP2+perp, &m_iWall1);
+  m_pWall2 = pMap->AddWall(m_vP2-perp, m_vP1-perp, &m_iWall2);
 }
 
 //---------------------------- dtor -------------------------------------------
@@ -70,6 +71,9 @@ void Raven_Door::ChangePosition(Vector2D newP1, Vector2D newP2)
 
   m_pWall2->SetFrom(m_vP2 - m_vtoP2Norm.Perp());
   m_pWall2->SetTo(m_vP1 - m_vtoP2Norm.Perp());
+
+  m_pMap->UpdateWall(m_iWall1);
+  m_pMap->UpdateWall(m_iWall2);
 }
 
 //---------------------------- Open -------------------------------------------
@@ -83,6 +87,9 @@ void Raven_Door::Open()
 
       m_iNumTicksCurrentlyOpen = m_iNumTicksStayOpen;
 
+      //any paths cached through the door were found with it shut
+      m_pMap->DoorStatusChanged(ID(), true);
+
       return;
       
     }
@@ -106,6 +113,9 @@ void Raven_Door::Close()
     if (m_dCurrentSize == m_dSize)
     {
       m_Status = closed;
+
+      m_pMap->DoorStatusChanged(ID(), false);
+
       return;
       
     }
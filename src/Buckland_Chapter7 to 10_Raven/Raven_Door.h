@@ -33,11 +33,18 @@ protected:
 
   door_status                m_Status;
 
+  //the map owning the door's walls. It is told whenever they move
+  Raven_Map*                 m_pMap;
+
   //a sliding door is created from two walls, back to back.These walls must
   //be added to a map's geometry in order for an agent to detect them
   Wall2D*                    m_pWall1;
   Wall2D*                    m_pWall2;
 
+  //and where the map keeps them, so it can be told when they move
+  int                        m_iWall1;
+  int                        m_iWall2;
+
   //a container of the id's of the triggers able to open this door
   std::vector<unsigned int>  m_Switches;
 
@@ -15,6 +15,7 @@
 #include "Raven_SensoryMemory.h"
 #include "Raven_WeaponSystem.h"
 #include "messaging/MessageDispatcher.h"
+#include "misc/FrameCounter.h"
 #include "Raven_Messages.h"
 #include "GraveMarkers.h"
 
@@ -43,13 +44,17 @@
 Raven_Game::Raven_Game():m_pSelectedBot(NULL),
                          m_bPaused(false),
                          m_bRemoveABot(false),
+                         m_iNextBotSlot(0),
                          m_pMap(NULL),
                          m_pPathManager(NULL),
                          m_pGraveMarkers(NULL),
 						 cursorPos(Vector2D(0, 0))
 {
   //load in the default map
-  LoadMap(script->GetString("StartMap"));
+  LoadMap(script->Params().StartMap);
+
+  //pick up any edits made to Params.ini while the game is running
+  script->StartWatching();
 
   // chaque dbut d'un nouveau jeu. r-initilisaliser le dataset d'entrainement
 
@@ -63,6 +68,8 @@ Raven_Game::Raven_Game():m_pSelectedBot(NULL),
 //-----------------------------------------------------------------------------
 Raven_Game::~Raven_Game()
 {
+  script->StopWatching();
+
   Clear();
   delete m_pPathManager;
   delete m_pMap;
@@ -107,6 +114,8 @@ void Raven_Game::Clear()
   //clear the containers
   m_Projectiles.clear();
   m_Bots.clear();
+  m_FreeBotSlots.clear();
+  m_iNextBotSlot = 0;
 
   m_pSelectedBot = NULL;
 
@@ -136,11 +145,31 @@ void Raven_Game::TrainThread() {
 //-----------------------------------------------------------------------------
 void Raven_Game::Update()
 { 
+  //install any parameters reloaded since the last update-step and hand
+  //them to the bots already in the game
+  if (script->UpdateParams())
+  {
+    const Raven_Params& params = script->Params();
+
+    std::list<Raven_Bot*>::iterator curBot = m_Bots.begin();
+    for (curBot; curBot != m_Bots.end(); ++curBot)
+    {
+      (*curBot)->ApplyParams(params);
+    }
+
+    debug_con << "Params.ini reloaded" << "";
+  }
+
   //don't update if the user has paused the game
   if (m_bPaused) return;
 
   m_pGraveMarkers->Update();
 
+  //advance the update-step count and deliver any delayed telegrams that
+  //have fallen due
+  TickCounter->Update();
+  Dispatcher->DispatchDelayedMessages();
+
   //get any player keyboard input
   GetPlayerInput();
   
@@ -154,6 +183,19 @@ void Raven_Game::Update()
     (*curDoor)->Update();
   }
 
+  //any incremental path searches through doors that have opened or shut
+  //need repairing
+  if (!m_pMap->GetChangedDoors().empty())
+  {
+    std::list<Raven_Bot*>::iterator curBot = m_Bots.begin();
+    for (curBot; curBot != m_Bots.end(); ++curBot)
+    {
+      (*curBot)->GetPathPlanner()->DoorsChanged(m_pMap->GetChangedDoors());
+    }
+
+    m_pMap->ClearChangedDoors();
+  }
+
   //update any current projectiles
   std::list<Raven_Projectile*>::iterator curW = m_Projectiles.begin();
   while (curW != m_Projectiles.end())
@@ -252,6 +294,9 @@ void Raven_Game::Update()
 	}
   }
 
+  //let the bots hear any shots fired this update-step
+  m_pMap->PropagateSounds(m_Bots);
+
   //update the triggers
   m_pMap->UpdateTriggerSystem(m_Bots);
 
@@ -263,7 +308,10 @@ void Raven_Game::Update()
     {
       Raven_Bot* pBot = m_Bots.back();
       if (pBot == m_pSelectedBot)m_pSelectedBot=0;
-      NotifyAllBotsOfRemoval(pBot);
+      m_FreeBotSlots.push_back(pBot->Slot());
+
+      //deleting the bot removes it from the entity manager. Any handles the
+      //other bots hold to it (targets, memory records) stop resolving
       delete m_Bots.back();
       m_Bots.remove(pBot);
       pBot = 0;
@@ -383,6 +431,17 @@ void Raven_Game::AddBots(unsigned int NumBotsToAdd, bool isLearningBot)
 	   debug_con << "Instanciation d'un bot apprenant" << rb->ID() << "";
 	}
 
+    //give the bot a slot, reusing one freed by a removed bot if possible
+    if (m_FreeBotSlots.empty())
+    {
+      rb->SetSlot(m_iNextBotSlot++);
+    }
+    else
+    {
+      rb->SetSlot(m_FreeBotSlots.back());
+      m_FreeBotSlots.pop_back();
+    }
+
     //switch the default steering behaviors on
     rb->GetSteering()->WallAvoidanceOn();
     rb->GetSteering()->SeparationOn();
@@ -399,25 +458,6 @@ void Raven_Game::AddBots(unsigned int NumBotsToAdd, bool isLearningBot)
   }
 }
 
-//---------------------------- NotifyAllBotsOfRemoval -------------------------
-//
-//  when a bot is removed from the game by a user all remianing bots
-//  must be notifies so that they can remove any references to that bot from
-//  their memory
-//-----------------------------------------------------------------------------
-void Raven_Game::NotifyAllBotsOfRemoval(Raven_Bot* pRemovedBot)const
-{
-    std::list<Raven_Bot*>::const_iterator curBot = m_Bots.begin();
-    for (curBot; curBot != m_Bots.end(); ++curBot)
-    {
-      Dispatcher->DispatchMsg(SEND_MSG_IMMEDIATELY,
-                              SENDER_ID_IRRELEVANT,
-                              (*curBot)->ID(),
-                              Msg_UserHasRemovedBot,
-                              pRemovedBot);
-
-    }
-}
 //-------------------------------RemoveBot ------------------------------------
 //
 //  removes the last bot to be added from the game
@@ -553,24 +593,32 @@ bool Raven_Game::LoadMap(const std::string& filename)
   //clear any current bots and projectiles
   Clear();
   
-  //out with the old
+  //out with the old. (The path manager goes first, as its worker threads
+  //may still be reading the map)
+  delete m_pPathManager;
   delete m_pMap;
   delete m_pGraveMarkers;
-  delete m_pPathManager;
 
   //in with the new
-  m_pGraveMarkers = new GraveMarkers(script->GetDouble("GraveLifetime"));
-  m_pPathManager = new PathManager<Raven_PathPlanner>(script->GetInt("MaxSearchCyclesPerUpdateStep"));
+  m_pGraveMarkers = new GraveMarkers(script->Params().GraveLifetime);
+  m_pPathManager = new PathManager<Raven_PathPlanner>(script->Params().MaxSearchCyclesPerUpdateStep,
+                                                      script->Params().SearchBudgetMicroseconds,
+                                                      script->Params().SearchCyclesPerSlice,
+                                                      script->Params().SearchPriorityAgingRate,
+                                                      script->Params().PathWorkerThreads);
   m_pMap = new Raven_Map();
 
   //make sure the entity manager is reset
   EntityMgr->Reset();
 
+  //and that no telegrams addressed to the old entities are left queued
+  Dispatcher->Clear();
+
 
   //load the new map data
   if (m_pMap->LoadMap(filename))
   { 
-	  AddBots(script->GetInt("NumBots"), false);
+	  AddBots(script->Params().NumBots, false);
   
     return true;
   }
@@ -728,7 +776,7 @@ void Raven_Game::ChangeWeaponOfPossessedBot(unsigned int weapon)const
 //------------------------------------------------------------------------------
 bool Raven_Game::isLOSOkay(Vector2D A, Vector2D B)const
 {
-  return !doWallsObstructLineSegment(A, B, m_pMap->GetWalls());
+  return !doWallsObstructLineSegment(A, B, m_pMap->GetWallTable());
 }
 
 //------------------------- isPathObstructed ----------------------------------
@@ -752,7 +800,7 @@ bool Raven_Game::isPathObstructed(Vector2D A,
     curPos += ToB * 0.5 * BoundingRadius;
     
     //test all walls against the new position
-    if (doWallsIntersectCircle(m_pMap->GetWalls(), curPos, BoundingRadius))
+    if (doWallsIntersectCircle(m_pMap->GetWallTable(), curPos, BoundingRadius))
     {
       return true;
     }
@@ -788,7 +836,7 @@ Raven_Game::GetAllBotsInFOV(const Raven_Bot* pBot)const
       //visible add it to the vector
       if (!doWallsObstructLineSegment(pBot->Pos(),
                               (*curBot)->Pos(),
-                              m_pMap->GetWalls()))
+                              m_pMap->GetWallTable()))
       {
         VisibleBots.push_back(*curBot);
       }
@@ -817,7 +865,7 @@ Raven_Game::isSecondVisibleToFirst(const Raven_Bot* pFirst,
       //If the bot is visible add it to the vector
       if (!doWallsObstructLineSegment(pFirst->Pos(),
                                       pSecond->Pos(),
-                                      m_pMap->GetWalls()))
+                                      m_pMap->GetWallTable()))
       {
         return true;
       }
@@ -46,6 +46,11 @@ private:
   //a list of all the bots that are inhabiting the map
   std::list<Raven_Bot*>            m_Bots;
 
+  //bot slots released by removed bots, reused before new ones are handed
+  //out. This keeps the slot numbers dense. (see Raven_Bot::Slot)
+  std::vector<int>                 m_FreeBotSlots;
+  int                              m_iNextBotSlot;
+
   //the user may select a bot to control manually. This is a pointer to that
   //bot
   Raven_Bot*                       m_pSelectedBot;
@@ -80,11 +85,6 @@ private:
   //if unsuccessful 
   bool AttemptToAddBot(Raven_Bot* pBot);
 
-  //when a bot is removed from the game by a user all remaining bots
-  //must be notified so that they can remove any references to that bot from
-  //their memory
-  void NotifyAllBotsOfRemoval(Raven_Bot* pRemovedBot)const;
-
 
   CData m_TrainingSet; //jeu d'apprentissage
 
@@ -10,7 +10,9 @@
 #include "triggers/Trigger_HealthGiver.h"
 #include "triggers/Trigger_WeaponGiver.h"
 #include "triggers/Trigger_OnButtonSendMsg.h"
-#include "triggers/Trigger_SoundNotify.h"
+#include "Raven_SensoryMemory.h"
+#include "Raven_CompiledMap.h"
+#include "navigation/EdgeCostPolicies.h"
 
 #include "Raven_UserOptions.h"
 
@@ -23,6 +25,7 @@
 //-----------------------------------------------------------------------------
 Raven_Map::Raven_Map():m_pNavGraph(NULL),
                        m_pSpacePartition(NULL),
+                       m_pBotSpacePartition(NULL),
                        m_iSizeY(0),
                        m_iSizeX(0),
                        m_dCellSpaceNeighborhoodRange(0)
@@ -61,13 +64,40 @@ void Raven_Map::Clear()
   }
 
   m_Walls.clear();
+  m_WallTable.Clear();
   m_SpawnPoints.clear();
   
-  //delete the navgraph
+  //delete the navgraph (and the path costs, hierarchy and frozen graph,
+  //which refer to it)
+  m_PathCosts.Clear();
+  m_Hierarchy.Clear();
+  m_PathCache.Clear();
+  m_FlowFields.Clear();
+  m_Landmarks.Clear();
+  m_Routes.Clear();
+
+  Heuristic_ALT<FrozenNavGraph>::SetLandmarks(NULL);
+  EdgeCost_Doors<NavGraph::EdgeType>::SetDoorCosts(NULL);
+
+  m_DoorCosts.clear();
+  m_DoorNodes.clear();
+  m_ChangedDoors.clear();
+
+  m_ItemFields.clear();
+  m_TeamItems.clear();
+  m_FrozenGraph.Clear();
+
   delete m_pNavGraph;   
 
   //delete the partioning info
+  m_NodeLookup.Clear();
+
   delete m_pSpacePartition;
+
+  m_SoundEvents.clear();
+
+  delete m_pBotSpacePartition;
+  m_pBotSpacePartition = NULL;
 }
 
 
@@ -75,18 +105,34 @@ void Raven_Map::Clear()
 //-----------------------------------------------------------------------------
 void Raven_Map::AddWall(std::ifstream& in)
 {
-  m_Walls.push_back(new Wall2D(in));
+  Wall2D* w = new Wall2D(in);
+
+  m_Walls.push_back(w);
+  m_WallTable.Add(*w);
 }
 
-Wall2D* Raven_Map::AddWall(Vector2D from, Vector2D to)
+Wall2D* Raven_Map::AddWall(Vector2D from, Vector2D to, int* pIndex)
 {
   Wall2D* w = new Wall2D(from, to);
 
+  if (pIndex) *pIndex = (int)m_Walls.size();
+
   m_Walls.push_back(w);
+  m_WallTable.Add(*w);
 
   return w;
 }
 
+//----------------------------- UpdateWall ------------------------------------
+//-----------------------------------------------------------------------------
+void Raven_Map::UpdateWall(int WallIndex)
+{
+  assert (WallIndex >= 0 && WallIndex < (int)m_Walls.size() &&
+          "<Raven_Map::UpdateWall>: unknown wall");
+
+  m_WallTable.Set(WallIndex, *m_Walls[WallIndex]);
+}
+
 //--------------------------- AddDoor -----------------------------------------
 //-----------------------------------------------------------------------------
 void Raven_Map::AddDoor(std::ifstream& in)
@@ -180,16 +226,29 @@ bool Raven_Map::LoadMap(const std::string& filename)
 
   BaseGameEntity::ResetNextValidID();
 
+  //if the map has been compiled the navgraph and the path cost table can be
+  //taken straight from the compiled file (see Raven_CompiledMap.h)
+  Raven_CompiledMap compiled;
+
+  bool bCompiled = compiled.Open(filename);
+
   //first of all read and create the navgraph. This must be done before
   //the entities are read from the map file because many of the entities
   //will be linked to a graph node (the graph node will own a pointer
   //to an instance of the entity)
   m_pNavGraph = new NavGraph(false);
   
-  m_pNavGraph->Load(in);
+  if (bCompiled)
+  {
+    compiled.CreateNavGraph(*m_pNavGraph);
+  }
+  else
+  {
+    m_pNavGraph->Load(in);
+  }
 
 #ifdef LOG_CREATIONAL_STUFF
-    debug_con << "NavGraph for " << filename << " loaded okay" << "";
+    debug_con << "NavGraph for " << filename << " loaded okay" << (bCompiled ? " (compiled)" : "") << "";
 #endif
 
   //determine the average distance between graph nodes so that we can
@@ -205,8 +264,25 @@ bool Raven_Map::LoadMap(const std::string& filename)
 #endif
 
 
-  //load in the map size and adjust the client window accordingly
-  in >> m_iSizeX >> m_iSizeY;
+  //load in the map size and adjust the client window accordingly. The
+  //entity definitions follow
+  int EntityOffset;
+
+  if (bCompiled)
+  {
+    m_iSizeX = compiled.SizeX();
+    m_iSizeY = compiled.SizeY();
+
+    EntityOffset = compiled.EntityOffset();
+
+    in.seekg(EntityOffset);
+  }
+  else
+  {
+    in >> m_iSizeX >> m_iSizeY;
+
+    EntityOffset = (int)in.tellg();
+  }
 
 #ifdef LOG_CREATIONAL_STUFF
     debug_con << "Partitioning navgraph nodes..." << "";
@@ -215,6 +291,14 @@ bool Raven_Map::LoadMap(const std::string& filename)
   //partition the graph nodes
   PartitionNavGraph();
 
+  //the lookup grid's cells are half the neighborhood range across, so each
+  //holds only a few candidates
+  m_NodeLookup.Build(*m_pNavGraph,
+                     m_iSizeX,
+                     m_iSizeY,
+                     m_dCellSpaceNeighborhoodRange * 0.5,
+                     m_dCellSpaceNeighborhoodRange);
+
 
   //get the handle to the game window and resize the client area to accommodate
   //the map
@@ -297,13 +381,193 @@ bool Raven_Map::LoadMap(const std::string& filename)
     debug_con << filename << " loaded okay" << "";
 #endif
 
-   //calculate the cost lookup table
-  m_PathCosts = CreateAllPairsCostsTable(*m_pNavGraph);
+  //the navgraph is complete, so take the snapshot the searches use
+  m_FrozenGraph.Build(*m_pNavGraph);
+
+  m_PathCache.SetCapacity(Maximum(script->Params().PathCacheSize, 0));
+
+  m_FlowFields.SetGraph(&m_FrozenGraph,
+                        Maximum(script->Params().FlowFieldCacheSize, 0),
+                        script->Params().FlowFieldMinRequests);
+
+  SetUpDoorCosts();
+
+  CreateItemFields();
+
+  if (script->Params().NumLandmarks > 0)
+  {
+    m_Landmarks.Build(m_FrozenGraph, script->Params().NumLandmarks);
+
+    Heuristic_ALT<FrozenNavGraph>::SetLandmarks(&m_Landmarks);
+  }
+
+  //the routing table is copied from the compiled map if it holds one, and
+  //otherwise built by searching from every node in parallel
+  bool bRoutesCompiled = false;
+
+  if (m_FrozenGraph.NumNodes() <= script->Params().NextHopTableMaxNodes)
+  {
+    if (bCompiled && compiled.Routes())
+    {
+      bRoutesCompiled = m_Routes.Assign(m_FrozenGraph, compiled.Routes());
+    }
+
+    else if (m_Routes.Build(m_FrozenGraph))
+    {
+      debug_con << "Routing table built (" << m_Routes.SizeInBytes() / 1024 << "KB)" << "";
+    }
+  }
+
+  if (m_FrozenGraph.NumActiveNodes() >= script->Params().HPAMinNodes)
+  {
+    m_Hierarchy.Build(m_FrozenGraph, script->Params().HPAClusterSize);
+
+    debug_con << "Navgraph split into " << m_Hierarchy.NumClusters() << " clusters with "
+              << m_Hierarchy.NumAbstractEdges() << " abstract edges" << "";
+  }
+
+  //calculate the cost lookup table (or copy it from the compiled map) and
+  //compile the map if necessary so the next load is quicker. A compiled map
+  //is rewritten if the table is complete but isn't held in it as it is now,
+  //or if the routing table had to be built
+  bool bCostsCompiled = CreatePathCosts(bCompiled ? &compiled : NULL);
+
+  bool bWriteCompiled = !bCompiled ||
+                        (m_Routes.isBuilt() && !bRoutesCompiled) ||
+                        (m_PathCosts.isComplete() &&
+                         (!bCostsCompiled                                      ||
+                          compiled.PathCostLayout()    != m_PathCosts.Layout() ||
+                          compiled.PathCostPrecision() != m_PathCosts.Precision()));
+
+  compiled.Close();
+  in.close();
+
+  if (bWriteCompiled &&
+      !Raven_CompiledMap::Write(filename, *m_pNavGraph, m_PathCosts, m_Routes,
+                                m_iSizeX, m_iSizeY, EntityOffset))
+  {
+#ifdef LOG_CREATIONAL_STUFF
+    debug_con << "Unable to write " << Raven_CompiledMap::CompiledFileName(filename) << "";
+#endif
+  }
 
   return true;
 }
 
 
+//--------------------------- SetUpDoorCosts ----------------------------------
+//
+//  the doors all start shut
+//-----------------------------------------------------------------------------
+void Raven_Map::SetUpDoorCosts()
+{
+  const double ClosedDoorCost = Maximum(script->Params().ClosedDoorCost, 0.0);
+
+  for (int n=0; n<m_FrozenGraph.NumNodes(); ++n)
+  {
+    FrozenNavGraph::ConstEdgeIterator EdgeItr(m_FrozenGraph, n);
+    for (const NavGraphEdge* pE=EdgeItr.begin(); !EdgeItr.end(); pE=EdgeItr.next())
+    {
+      if (!(pE->Flags() & NavGraphEdge::goes_through_door)) continue;
+
+      int door = pE->IDofIntersectingEntity();
+
+      if (door < 0) continue;
+
+      //each edge is stored both ways, so this records both its ends
+      m_DoorNodes[door].push_back(n);
+
+      if (door >= (int)m_DoorCosts.size()) m_DoorCosts.resize(door+1, 0.0);
+
+      m_DoorCosts[door] = ClosedDoorCost;
+    }
+  }
+
+  EdgeCost_Doors<NavGraph::EdgeType>::SetDoorCosts(&m_DoorCosts);
+}
+
+//-------------------------- DoorStatusChanged --------------------------------
+//-----------------------------------------------------------------------------
+void Raven_Map::DoorStatusChanged(int DoorID, bool bOpen)
+{
+  //any paths cached through the door were found with it in the other state
+  m_PathCache.InvalidateDoor(DoorID);
+
+  if (DoorID < 0 || DoorID >= (int)m_DoorCosts.size()) return;
+
+  m_DoorCosts[DoorID] = bOpen ? 0.0 : Maximum(script->Params().ClosedDoorCost, 0.0);
+
+  m_ChangedDoors.push_back(DoorID);
+}
+
+//----------------------------- GetDoorNodes ----------------------------------
+//-----------------------------------------------------------------------------
+const std::vector<int>& Raven_Map::GetDoorNodes(int DoorID)const
+{
+  static const std::vector<int> NoNodes;
+
+  std::map<int, std::vector<int> >::const_iterator it = m_DoorNodes.find(DoorID);
+
+  return it == m_DoorNodes.end() ? NoNodes : it->second;
+}
+
+
+//--------------------------- CreatePathCosts ---------------------------------
+//-----------------------------------------------------------------------------
+bool Raven_Map::CreatePathCosts(const Raven_CompiledMap* compiled)
+{
+  const Raven_Params& params = script->Params();
+
+  PathCosts::layout layout = PathCosts::full;
+
+  switch (params.PathCostStorage)
+  {
+  case 1:
+
+    //the triangular table relies on the costs being symmetrical
+    if (!m_FrozenGraph.isDigraph()) layout = PathCosts::triangular;
+
+    break;
+
+  case 2:
+
+    layout = PathCosts::on_demand; break;
+  }
+
+  PathCosts::precision precision = params.PathCostSinglePrecision ?
+                                   PathCosts::single_precision :
+                                   PathCosts::double_precision;
+
+  size_t CacheBudget = (size_t)Maximum(params.PathCostCacheKB, 0) * 1024;
+
+  //costs compiled as floats aren't used for a table of doubles
+  bool bUseCompiled = compiled && compiled->PathCosts() &&
+                      (compiled->PathCostPrecision() == PathCosts::double_precision ||
+                       precision == PathCosts::single_precision);
+
+  if (bUseCompiled)
+  {
+    m_PathCosts.Assign(m_FrozenGraph,
+                       compiled->PathCosts(),
+                       compiled->PathCostLayout(),
+                       compiled->PathCostPrecision(),
+                       layout,
+                       precision,
+                       CacheBudget);
+  }
+  else
+  {
+    m_PathCosts.Build(m_FrozenGraph, layout, precision, CacheBudget);
+  }
+
+  debug_con << "Path cost table uses " << (int)(m_PathCosts.MemoryUsed() / 1024)
+            << "KB (a full table of doubles would use "
+            << (int)(m_PathCosts.FullTableMemory() / 1024) << "KB)" << "";
+
+  return bUseCompiled;
+}
+
+
 
 
 
@@ -319,7 +583,7 @@ Raven_Map::CalculateCostToTravelBetweenNodes(int nd1, int nd2)const
           nd2>=0 && nd2<m_pNavGraph->NumNodes() &&
           "<Raven_Map::CostBetweenNodes>: invalid index");
 
-  return m_PathCosts[nd1][nd2];
+  return m_PathCosts.Cost(nd1, nd2);
 }
 
 
@@ -331,10 +595,20 @@ void Raven_Map::PartitionNavGraph()
 {
   if (m_pSpacePartition) delete m_pSpacePartition;
 
+  //the nodes are looked for within the neighborhood range, so that's the
+  //size of cell to use unless the cell counts are given
+  int NumCellsX, NumCellsY;
+
+  ChooseCellSpaceDimensions(m_iSizeX, m_iSizeY, m_dCellSpaceNeighborhoodRange,
+                            NumCellsX, NumCellsY);
+
+  if (script->Params().NumCellsX > 0) NumCellsX = script->Params().NumCellsX;
+  if (script->Params().NumCellsY > 0) NumCellsY = script->Params().NumCellsY;
+
   m_pSpacePartition = new CellSpacePartition<NavGraph::NodeType*>(m_iSizeX,
                                                                   m_iSizeY,
-                                                                  script->GetInt("NumCellsX"),
-                                                                  script->GetInt("NumCellsY"),
+                                                                  NumCellsX,
+                                                                  NumCellsY,
                                                                   m_pNavGraph->NumNodes());
 
   //add the graph nodes to the space partition
@@ -345,13 +619,92 @@ void Raven_Map::PartitionNavGraph()
   }   
 }
 
-//---------------------------- AddSoundTrigger --------------------------------
+//---------------------------- AddSoundEvent ----------------------------------
 //
-//  given the bot that has made a sound, this method adds a SoundMade trigger
+//  given the bot that has made a sound, this method queues the sound so that
+//  it can be delivered to any bots within range
 //-----------------------------------------------------------------------------
-void Raven_Map::AddSoundTrigger(Raven_Bot* pSoundSource, double range)
+void Raven_Map::AddSoundEvent(Raven_Bot* pSoundSource, double range)
 {
-  m_TriggerSystem.Register(new Trigger_SoundNotify(pSoundSource, range));
+  m_SoundEvents.push_back(SoundEvent(pSoundSource, pSoundSource->Pos(), range));
+}
+
+//---------------------------- PropagateSounds --------------------------------
+//
+//  each queued sound is resolved once: the bots are partitioned, the cells
+//  within range of the sound are queried and every living bot that overlaps
+//  the sound's radius has the source recorded in its sensory memory
+//-----------------------------------------------------------------------------
+void Raven_Map::PropagateSounds(const std::list<Raven_Bot*>& bots)
+{
+  if (m_SoundEvents.empty()) return;
+
+  double MaxBotRadius = 0.0;
+  double MaxRange     = 0.0;
+
+  std::list<Raven_Bot*>::const_iterator curBot = bots.begin();
+  for (curBot; curBot != bots.end(); ++curBot)
+  {
+    MaxBotRadius = Maximum(MaxBotRadius, (*curBot)->BRadius());
+  }
+
+  std::vector<SoundEvent>::const_iterator curSound = m_SoundEvents.begin();
+  for (curSound; curSound != m_SoundEvents.end(); ++curSound)
+  {
+    MaxRange = Maximum(MaxRange, curSound->dRange);
+  }
+
+  //the partition is made the first time a sound is heard, with cells sized
+  //for the loudest sound (unless the cell counts are given). It keeps its
+  //storage from then on, so refilling it doesn't allocate
+  if (!m_pBotSpacePartition)
+  {
+    int NumCellsX, NumCellsY;
+
+    ChooseCellSpaceDimensions(m_iSizeX, m_iSizeY, Maximum(MaxRange, 4*MaxBotRadius) + 1,
+                              NumCellsX, NumCellsY);
+
+    if (script->Params().NumCellsX > 0) NumCellsX = script->Params().NumCellsX;
+    if (script->Params().NumCellsY > 0) NumCellsY = script->Params().NumCellsY;
+
+    m_pBotSpacePartition = new CellSpacePartition<Raven_Bot*>(m_iSizeX,
+                                                              m_iSizeY,
+                                                              NumCellsX,
+                                                              NumCellsY,
+                                                              (int)bots.size());
+  }
+  else
+  {
+    m_pBotSpacePartition->EmptyCells();
+  }
+
+  for (curBot = bots.begin(); curBot != bots.end(); ++curBot)
+  {
+    if ((*curBot)->isAlive())
+    {
+      m_pBotSpacePartition->AddEntity(*curBot);
+    }
+  }
+
+  for (curSound = m_SoundEvents.begin(); curSound != m_SoundEvents.end(); ++curSound)
+  {
+    const SoundEvent& sound = *curSound;
+
+    m_pBotSpacePartition->ForEachNeighbor(sound.vPos,
+                                          sound.dRange + MaxBotRadius,
+                                          [&sound](Raven_Bot* pBot)
+    {
+      //same test as a circular trigger region of the sound's range
+      double range = sound.dRange + pBot->BRadius();
+
+      if (Vec2DDistanceSq(pBot->Pos(), sound.vPos) < range*range)
+      {
+        pBot->GetSensoryMem()->UpdateWithSoundSource(sound.pSource);
+      }
+    });
+  }
+
+  m_SoundEvents.clear();
 }
 
 //----------------------- UpdateTriggerSystem ---------------------------------
@@ -362,6 +715,75 @@ void Raven_Map::AddSoundTrigger(Raven_Bot* pSoundSource, double range)
 void Raven_Map::UpdateTriggerSystem(std::list<Raven_Bot*>& bots)
 {
   m_TriggerSystem.Update(bots);
+
+  UpdateItemFields();
+}
+
+//--------------------------- CreateItemFields --------------------------------
+//
+//  an item is a trigger its navgraph node points to
+//-----------------------------------------------------------------------------
+void Raven_Map::CreateItemFields()
+{
+  TriggerSystem::TriggerList::const_iterator it;
+  for (it = GetTriggers().begin(); it != GetTriggers().end(); ++it)
+  {
+    if ((*it)->GraphNodeIndex() < 0 || (*it)->IsInATeam()) continue;
+
+    if (m_pNavGraph->GetNode((*it)->GraphNodeIndex()).ExtraInfo() != *it) continue;
+
+    ItemField& field = m_ItemFields[(*it)->EntityType()];
+
+    if (!field.isBuilt()) field.Build(m_FrozenGraph);
+  }
+
+  UpdateItemFields();
+}
+
+//--------------------------- UpdateItemFields --------------------------------
+//
+//  the items' active states are compared with the fields each update-step.
+//  Only the items that have changed cost anything
+//-----------------------------------------------------------------------------
+void Raven_Map::UpdateItemFields()
+{
+  if (m_ItemFields.empty()) return;
+
+  TriggerSystem::TriggerList::const_iterator it;
+  for (it = GetTriggers().begin(); it != GetTriggers().end(); ++it)
+  {
+    int nd = (*it)->GraphNodeIndex();
+
+    if (nd < 0 || (*it)->IsInATeam()) continue;
+
+    std::map<unsigned int, ItemField>::iterator field = m_ItemFields.find((*it)->EntityType());
+
+    if (field == m_ItemFields.end()) continue;
+
+    //(a team's item may since have been put on the same node, in which case
+    //a search would find that instead)
+    bool bActive = (*it)->isActive() && m_pNavGraph->GetNode(nd).ExtraInfo() == *it;
+
+    if (bActive == field->second.isSource(nd)) continue;
+
+    if (bActive)
+    {
+      field->second.AddSource(nd);
+    }
+    else
+    {
+      field->second.RemoveSource(nd);
+    }
+  }
+}
+
+//----------------------------- GetItemField ----------------------------------
+//-----------------------------------------------------------------------------
+const Raven_Map::ItemField* Raven_Map::GetItemField(unsigned int ItemType)const
+{
+  std::map<unsigned int, ItemField>::const_iterator it = m_ItemFields.find(ItemType);
+
+  return it == m_ItemFields.end() ? NULL : &it->second;
 }
 
 //------------------------- GetRandomNodeLocation -----------------------------
@@ -437,6 +859,8 @@ void Raven_Map::AddTeamWeapon_Giver(int type_of_weapon, std::string nameTeam, Ve
 
 	node.SetExtraInfo(wg);
 
+	m_TeamItems.push_back(wg);
+
 	//register the entity 
 	EntityMgr->RegisterEntity(wg);
 }
\ No newline at end of file
@@ -16,17 +16,29 @@
 #include <vector>
 #include <string>
 #include <list>
+#include <map>
 #include "graph/SparseGraph.h"
 #include "2d/Wall2D.h"
+#include "2d/WallTable2D.h"
 #include "triggers/Trigger.h"
 #include "Raven_Bot.h"
 #include "Graph/GraphEdgeTypes.h"
 #include "Graph/GraphNodeTypes.h"
 #include "misc/CellSpacePartition.h"
+#include "Graph/FrozenGraph.h"
+#include "Graph/PathCostTable.h"
+#include "Graph/HierarchicalGraph.h"
+#include "Graph/LandmarkTable.h"
+#include "Graph/NodeLookupGrid.h"
+#include "Graph/DistanceField.h"
+#include "Graph/NextHopTable.h"
 #include "triggers/TriggerSystem.h"
+#include "navigation/PathCache.h"
+#include "navigation/FlowFieldCache.h"
 
 class BaseGameEntity;
 class Raven_Door;
+class Raven_CompiledMap;
 
 
 class Raven_Map
@@ -36,6 +48,14 @@ public:
   typedef NavGraphNode<Trigger<Raven_Bot>*>         GraphNode;
   typedef SparseGraph<GraphNode, NavGraphEdge>      NavGraph;
   typedef CellSpacePartition<NavGraph::NodeType*>   CellSpace;
+  typedef FrozenGraph<NavGraph>                     FrozenNavGraph;
+  typedef PathCostTable<FrozenNavGraph>             PathCosts;
+  typedef HierarchicalGraph<FrozenNavGraph>         NavHierarchy;
+  typedef LandmarkTable<FrozenNavGraph>             Landmarks;
+  typedef NodeLookupGrid<NavGraph>                  NodeLookup;
+  typedef DistanceField<FrozenNavGraph>             ItemField;
+  typedef FlowFieldCache<FrozenNavGraph>            FlowFields;
+  typedef NextHopTable<FrozenNavGraph>              Routes;
 
   typedef Trigger<Raven_Bot>                        TriggerType;
   typedef TriggerSystem<TriggerType>                TriggerSystem;
@@ -45,6 +65,10 @@ private:
   //the walls that comprise the current map's architecture. 
   std::vector<Wall2D*>                m_Walls;
 
+  //a packed copy of the walls above, used by the batch intersection tests.
+  //Entry i always mirrors m_Walls[i]
+  WallTable2D                        m_WallTable;
+
   //trigger are objects that define a region of space. When a raven bot
   //enters that area, it 'triggers' an event. That event may be anything
   //from increasing a bot's health to opening a door or requesting a lift.
@@ -60,6 +84,22 @@ private:
   //this map's accompanying navigation graph
   NavGraph*                          m_pNavGraph;  
 
+  //a compact read-only copy of the navgraph's edges that the graph searches
+  //run on (see FrozenGraph.h). It is rebuilt whenever a map is loaded
+  FrozenNavGraph                     m_FrozenGraph;
+
+  //the clustered abstraction of the frozen graph used to plan paths on
+  //large maps (see HierarchicalGraph.h). Only built if the navgraph has at
+  //least HPAMinNodes nodes
+  NavHierarchy                       m_Hierarchy;
+
+  //the landmark costs used by the A* heuristic (see Heuristic_ALT)
+  Landmarks                          m_Landmarks;
+
+  //the first step of the shortest path between every pair of nodes. Only
+  //built if the navgraph has no more than NextHopTableMaxNodes nodes
+  Routes                             m_Routes;
+
   //the graph nodes will be partitioned enabling fast lookup
   CellSpace*                        m_pSpacePartition;
 
@@ -67,14 +107,81 @@ private:
   //neighbors 
   double                             m_dCellSpaceNeighborhoodRange;
 
+  //the candidate nodes near each position, for finding the closest node a
+  //bot can walk to (see NodeLookupGrid.h)
+  NodeLookup                         m_NodeLookup;
+
   int m_iSizeX;
   int m_iSizeY;
   
   void  PartitionNavGraph();
 
   //this will hold a pre-calculated lookup table of the cost to travel from
-  //one node to any other.
-  std::vector<std::vector<double> >  m_PathCosts;
+  //one node to any other. How it is stored is set by the PathCost
+  //parameters in Params.ini
+  PathCosts                          m_PathCosts;
+
+  //sets up m_PathCosts for the current navgraph, from the costs held by the
+  //compiled map if it has any good enough (see Raven_CompiledMap.h).
+  //Returns true if they were used
+  bool  CreatePathCosts(const Raven_CompiledMap* compiled);
+
+  //the paths found by the bots' planners, kept for reuse by the next bot
+  //wanting the same one
+  PathCache                          m_PathCache;
+
+  //the flow fields for the destinations many bots are heading for
+  FlowFields                         m_FlowFields;
+
+  //a sound made by a bot (a weapon discharge for example). Sounds are queued
+  //as they are made and resolved in one batch by PropagateSounds
+  struct SoundEvent
+  {
+    Raven_Bot* pSource;
+    Vector2D   vPos;
+    double     dRange;
+
+    SoundEvent(Raven_Bot* source, Vector2D pos, double range):pSource(source),
+                                                               vPos(pos),
+                                                               dRange(range)
+    {}
+  };
+
+  std::vector<SoundEvent>            m_SoundEvents;
+
+  //the living bots are partitioned whenever there are sounds to propagate
+  //so that each sound only needs to test the bots close to it
+  CellSpacePartition<Raven_Bot*>*    m_pBotSpacePartition;
+
+  //the extra cost of going through each door, indexed by door ID. It is
+  //ClosedDoorCost while the door is shut and zero while it is open (see
+  //EdgeCost_Doors)
+  std::vector<double>                m_DoorCosts;
+
+  //the nodes at either end of the edges through each door, by door ID
+  std::map<int, std::vector<int> >   m_DoorNodes;
+
+  //the doors that have opened or shut since ClearChangedDoors was last
+  //called, so the bots' incremental searches can be repaired
+  std::vector<int>                   m_ChangedDoors;
+
+  //fills in m_DoorNodes and m_DoorCosts from the frozen graph
+  void  SetUpDoorCosts();
+
+  //for each type of item on the map, the cost from every node to the
+  //nearest active item of that type (see DistanceField.h). Items that
+  //belong to a team are left out
+  std::map<unsigned int, ItemField>  m_ItemFields;
+
+  //the items that belong to a team
+  std::vector<TriggerType*>          m_TeamItems;
+
+  //creates a field for each type of item the map holds
+  void  CreateItemFields();
+
+  //adds the items that have become active to their fields and removes
+  //those that have become inactive
+  void  UpdateItemFields();
 
 
     //stream constructors for loading from a file
@@ -98,13 +205,41 @@ public:
   bool LoadMap(const std::string& FileName); 
 
   //adds a wall and returns a pointer to that wall. (this method can be
-  //used by objects such as doors to add walls to the environment)
-  Wall2D* AddWall(Vector2D from, Vector2D to);
+  //used by objects such as doors to add walls to the environment). If
+  //pIndex is given the wall's index, needed by UpdateWall, is written to it
+  Wall2D* AddWall(Vector2D from, Vector2D to, int* pIndex = NULL);
+
+  //must be called after the wall at WallIndex (as given by AddWall) has been
+  //moved so that the packed wall table stays in step with it
+  void    UpdateWall(int WallIndex);
 
-  void    AddSoundTrigger(Raven_Bot* pSoundSource, double range);
+  //queues a sound made by pSoundSource that can be heard by any bot within
+  //range. It is delivered at the next call to PropagateSounds
+  void    AddSoundEvent(Raven_Bot* pSoundSource, double range);
+
+  //delivers all the queued sounds straight into the sensory memory of the
+  //bots in range, then empties the queue
+  void    PropagateSounds(const std::list<Raven_Bot*>& bots);
 
   double   CalculateCostToTravelBetweenNodes(int nd1, int nd2)const;
 
+  const PathCosts&                   GetPathCosts()const{return m_PathCosts;}
+
+  PathCache&                         GetPathCache(){return m_PathCache;}
+  FlowFields&                        GetFlowFields(){return m_FlowFields;}
+
+  //called by a door when it has finished opening or closing
+  void    DoorStatusChanged(int DoorID, bool bOpen);
+
+  const std::vector<int>&            GetDoorNodes(int DoorID)const;
+
+  //returns NULL if the map has no items of the type, other than any that
+  //belong to a team
+  const ItemField*                   GetItemField(unsigned int ItemType)const;
+  const std::vector<TriggerType*>&   GetTeamItems()const{return m_TeamItems;}
+  const std::vector<int>&            GetChangedDoors()const{return m_ChangedDoors;}
+  void                               ClearChangedDoors(){m_ChangedDoors.clear();}
+
   //returns the position of a graph node selected at random
   Vector2D GetRandomNodeLocation()const;
   
@@ -113,10 +248,21 @@ public:
 
   const Raven_Map::TriggerSystem::TriggerList&  GetTriggers()const{return m_TriggerSystem.GetTriggers();}
   const std::vector<Wall2D*>&        GetWalls()const{return m_Walls;}
+  const WallTable2D&                 GetWallTable()const{return m_WallTable;}
   NavGraph&                          GetNavGraph()const{return *m_pNavGraph;}
+  const FrozenNavGraph&              GetFrozenNavGraph()const{return m_FrozenGraph;}
+
+  const Landmarks&                   GetLandmarks()const{return m_Landmarks;}
+
+  //returns NULL if the map is too large for a routing table
+  const Routes*                      GetRoutes()const{return m_Routes.isBuilt() ? &m_Routes : NULL;}
+
+  //returns NULL if the map is too small to be planned hierarchically
+  const NavHierarchy*                GetNavHierarchy()const{return m_Hierarchy.NumClusters() ? &m_Hierarchy : NULL;}
   std::vector<Raven_Door*>&          GetDoors(){return m_Doors;}
   const std::vector<Vector2D>&       GetSpawnPoints()const{return m_SpawnPoints;}
   CellSpace* const                   GetCellSpace()const{return m_pSpacePartition;}
+  const NodeLookup&                  GetNodeLookup()const{return m_NodeLookup;}
   Vector2D                           GetRandomSpawnPoint(){return m_SpawnPoints[RandInt(0,m_SpawnPoints.size()-1)];}
   int                                GetSizeX()const{return m_iSizeX;}
   int                                GetSizeY()const{return m_iSizeY;}
@@ -19,8 +19,6 @@ enum message_type
 	Msg_YouGotMeYouSOB,
 	Msg_GoalQueueEmpty,
 	Msg_OpenSesame,
-	Msg_GunshotSound,
-	Msg_UserHasRemovedBot,
 	Msg_YouHitMe, // Message utilis par le leader pour dfinir une cible
 	Msg_TargetToAttack, // Dfinie la cible  attaquer par le leader
 	Msg_EncircleEnemy // Stratgie d'encerclement d'une cible dfinie
@@ -55,14 +53,6 @@ inline std::string MessageToString(int msg)
 
     return "Msg_OpenSesame";
 
-  case Msg_GunshotSound:
-
-    return "Msg_GunshotSound";
-
-  case Msg_UserHasRemovedBot:
-
-    return "Msg_UserHasRemovedBot";
-
   case Msg_YouHitMe:
 
 	  return "Msg_YouHitMe";
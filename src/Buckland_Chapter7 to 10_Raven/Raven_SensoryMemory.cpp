@@ -3,6 +3,7 @@
 #include "time/crudetimer.h"
 #include "misc/cgdi.h"
 #include "misc/Stream_Utility_Functions.h"
+#include "game/EntityManager.h"
 
 //------------------------------- ctor ----------------------------------------
 //-----------------------------------------------------------------------------
@@ -14,14 +15,48 @@
 
 //--------------------- MakeNewRecordIfNotAlreadyPresent ----------------------
 
-void Raven_SensoryMemory::MakeNewRecordIfNotAlreadyPresent(Raven_Bot* pOpponent)
+MemoryRecord& Raven_SensoryMemory::MakeNewRecordIfNotAlreadyPresent(Raven_Bot* pOpponent)
 {
-  //else check to see if this Opponent already exists in the memory. If it doesn't,
-  //create a new record
-  if (m_MemoryMap.find(pOpponent) == m_MemoryMap.end())
+  assert (pOpponent->Slot() >= 0 && "<Raven_SensoryMemory>: bot has no slot");
+
+  unsigned int slot = pOpponent->Slot();
+
+  if (slot >= m_MemoryMap.size())
+  {
+    m_MemoryMap.resize(slot+1);
+  }
+
+  //check to see if this Opponent already exists in the memory. If it doesn't,
+  //(or the slot last belonged to a bot that has since been removed) create a
+  //new record
+  MemoryRecord& record = m_MemoryMap[slot];
+
+  if (record.Opponent != pOpponent->Handle() || record.pOpponent != pOpponent)
+  {
+    record = MemoryRecord();
+    record.pOpponent = pOpponent;
+    record.Opponent  = pOpponent->Handle();
+  }
+
+  return record;
+}
+
+//------------------------------ GetRecord ------------------------------------
+//-----------------------------------------------------------------------------
+const MemoryRecord* Raven_SensoryMemory::GetRecord(const Raven_Bot* pOpponent)const
+{
+  if (!pOpponent) return 0;
+
+  unsigned int slot = pOpponent->Slot();
+
+  if (slot < m_MemoryMap.size() &&
+      m_MemoryMap[slot].pOpponent == pOpponent &&
+      m_MemoryMap[slot].Opponent  == pOpponent->Handle())
   {
-    m_MemoryMap[pOpponent] = MemoryRecord();
+    return &m_MemoryMap[slot];
   }
+
+  return 0;
 }
 
 //------------------------ RemoveBotFromMemory --------------------------------
@@ -30,11 +65,9 @@ void Raven_SensoryMemory::MakeNewRecordIfNotAlreadyPresent(Raven_Bot* pOpponent)
 //-----------------------------------------------------------------------------
 void Raven_SensoryMemory::RemoveBotFromMemory(Raven_Bot* pBot)
 {
-  MemoryMap::iterator record = m_MemoryMap.find(pBot);
-  
-  if (record != m_MemoryMap.end())
+  if (GetRecord(pBot))
   {
-    m_MemoryMap.erase(record);
+    m_MemoryMap[pBot->Slot()] = MemoryRecord();
   }
 }
   
@@ -51,9 +84,7 @@ void Raven_SensoryMemory::UpdateWithSoundSource(Raven_Bot* pNoiseMaker)
   {
     //if the bot is already part of the memory then update its data, else
     //create a new memory record and add it to the memory
-    MakeNewRecordIfNotAlreadyPresent(pNoiseMaker);
-
-    MemoryRecord& info = m_MemoryMap[pNoiseMaker];
+    MemoryRecord& info = MakeNewRecordIfNotAlreadyPresent(pNoiseMaker);
 
     //test if there is LOS between bots 
     if (m_pOwner->GetWorld()->isLOSOkay(m_pOwner->Pos(), pNoiseMaker->Pos()))
@@ -90,11 +121,9 @@ void Raven_SensoryMemory::UpdateVision()
     //make sure the bot being examined is not this bot
     if (m_pOwner != *curBot)
     {
-      //make sure it is part of the memory map
-      MakeNewRecordIfNotAlreadyPresent(*curBot);
-
-      //get a reference to this bot's data
-      MemoryRecord& info = m_MemoryMap[*curBot];
+      //make sure it is part of the memory map and get a reference to
+      //this bot's data
+      MemoryRecord& info = MakeNewRecordIfNotAlreadyPresent(*curBot);
 
       //test if there is LOS between bots 
       if (m_pOwner->GetWorld()->isLOSOkay(m_pOwner->Pos(), (*curBot)->Pos()))
@@ -139,25 +168,28 @@ void Raven_SensoryMemory::UpdateVision()
 //
 //  returns a list of the bots that have been sensed recently
 //-----------------------------------------------------------------------------
-std::list<Raven_Bot*> 
+const std::vector<Raven_Bot*>&
 Raven_SensoryMemory::GetListOfRecentlySensedOpponents()const
 {
   //this will store all the opponents the bot can remember
-  std::list<Raven_Bot*> opponents;
+  m_RecentlySensed.clear();
 
   double CurrentTime = Clock->GetCurrentTime();
 
   MemoryMap::const_iterator curRecord = m_MemoryMap.begin();
   for (curRecord; curRecord!=m_MemoryMap.end(); ++curRecord)
   {
-    //if this bot has been updated in the memory recently, add to list
-    if ( (CurrentTime - curRecord->second.fTimeLastSensed) <= m_dMemorySpan)
+    //if this bot has been updated in the memory recently (and is still in
+    //the game), add to list
+    if (curRecord->pOpponent &&
+        (CurrentTime - curRecord->fTimeLastSensed) <= m_dMemorySpan &&
+        EntityMgr->isValid(curRecord->Opponent))
     {
-      opponents.push_back(curRecord->first);
+      m_RecentlySensed.push_back(curRecord->pOpponent);
     }
   }
 
-  return opponents;
+  return m_RecentlySensed;
 }
 
 //----------------------------- isOpponentShootable --------------------------------
@@ -167,11 +199,11 @@ Raven_SensoryMemory::GetListOfRecentlySensedOpponents()const
 //-----------------------------------------------------------------------------
 bool Raven_SensoryMemory::isOpponentShootable(Raven_Bot* pOpponent)const
 {
-  MemoryMap::const_iterator it = m_MemoryMap.find(pOpponent);
+  const MemoryRecord* it = GetRecord(pOpponent);
  
-  if (it != m_MemoryMap.end())
+  if (it)
   {
-    return it->second.bShootable;
+    return it->bShootable;
   }
 
   return false;
@@ -183,11 +215,11 @@ bool Raven_SensoryMemory::isOpponentShootable(Raven_Bot* pOpponent)const
 //-----------------------------------------------------------------------------
 bool  Raven_SensoryMemory::isOpponentWithinFOV(Raven_Bot* pOpponent)const
 {
-  MemoryMap::const_iterator it = m_MemoryMap.find(pOpponent);
+  const MemoryRecord* it = GetRecord(pOpponent);
  
-  if (it != m_MemoryMap.end())
+  if (it)
   {
-    return it->second.bWithinFOV;
+    return it->bWithinFOV;
   }
 
   return false;
@@ -199,11 +231,11 @@ bool  Raven_SensoryMemory::isOpponentWithinFOV(Raven_Bot* pOpponent)const
 //-----------------------------------------------------------------------------
 Vector2D  Raven_SensoryMemory::GetLastRecordedPositionOfOpponent(Raven_Bot* pOpponent)const
 {
-  MemoryMap::const_iterator it = m_MemoryMap.find(pOpponent);
+  const MemoryRecord* it = GetRecord(pOpponent);
  
-  if (it != m_MemoryMap.end())
+  if (it)
   {
-    return it->second.vLastSensedPosition;
+    return it->vLastSensedPosition;
   }
 
   throw std::runtime_error("< Raven_SensoryMemory::GetLastRecordedPositionOfOpponent>: Attempting to get position of unrecorded bot");
@@ -215,11 +247,11 @@ Vector2D  Raven_SensoryMemory::GetLastRecordedPositionOfOpponent(Raven_Bot* pOpp
 //-----------------------------------------------------------------------------
 double  Raven_SensoryMemory::GetTimeOpponentHasBeenVisible(Raven_Bot* pOpponent)const
 {
-  MemoryMap::const_iterator it = m_MemoryMap.find(pOpponent);
+  const MemoryRecord* it = GetRecord(pOpponent);
  
-  if (it != m_MemoryMap.end() && it->second.bWithinFOV)
+  if (it && it->bWithinFOV)
   {
-    return Clock->GetCurrentTime() - it->second.fTimeBecameVisible;
+    return Clock->GetCurrentTime() - it->fTimeBecameVisible;
   }
 
   return 0;
@@ -232,11 +264,11 @@ double  Raven_SensoryMemory::GetTimeOpponentHasBeenVisible(Raven_Bot* pOpponent)
 //-----------------------------------------------------------------------------
 double Raven_SensoryMemory::GetTimeOpponentHasBeenOutOfView(Raven_Bot* pOpponent)const
 {
-  MemoryMap::const_iterator it = m_MemoryMap.find(pOpponent);
+  const MemoryRecord* it = GetRecord(pOpponent);
  
-  if (it != m_MemoryMap.end())
+  if (it)
   {
-    return Clock->GetCurrentTime() - it->second.fTimeLastVisible;
+    return Clock->GetCurrentTime() - it->fTimeLastVisible;
   }
 
   return MaxDouble;
@@ -248,11 +280,11 @@ double Raven_SensoryMemory::GetTimeOpponentHasBeenOutOfView(Raven_Bot* pOpponent
 //-----------------------------------------------------------------------------
 double  Raven_SensoryMemory::GetTimeSinceLastSensed(Raven_Bot* pOpponent)const
 {
-  MemoryMap::const_iterator it = m_MemoryMap.find(pOpponent);
+  const MemoryRecord* it = GetRecord(pOpponent);
  
-  if (it != m_MemoryMap.end() && it->second.bWithinFOV)
+  if (it && it->bWithinFOV)
   {
-    return Clock->GetCurrentTime() - it->second.fTimeLastSensed;
+    return Clock->GetCurrentTime() - it->fTimeLastSensed;
   }
 
   return 0;
@@ -264,8 +296,8 @@ double  Raven_SensoryMemory::GetTimeSinceLastSensed(Raven_Bot* pOpponent)const
 //-----------------------------------------------------------------------------
 void  Raven_SensoryMemory::RenderBoxesAroundRecentlySensed()const
 {
-  std::list<Raven_Bot*> opponents = GetListOfRecentlySensedOpponents();
-  std::list<Raven_Bot*>::const_iterator it;
+  const std::vector<Raven_Bot*>& opponents = GetListOfRecentlySensedOpponents();
+  std::vector<Raven_Bot*>::const_iterator it;
   for (it = opponents.begin(); it != opponents.end(); ++it)
   {
     gdi->OrangePen();
@@ -10,9 +10,9 @@
 //  Desc:
 //
 //-----------------------------------------------------------------------------
-#include <map>
-#include <list>
+#include <vector>
 #include "2d/vector2d.h"
+#include "game/EntityHandle.h"
 
 class Raven_Bot;
 
@@ -20,6 +20,12 @@ class Raven_Bot;
 class MemoryRecord
 {
 public:
+
+  //the opponent this record describes, or null if the slot is unused.
+  //The pointer must only be followed once Opponent has been validated
+  //with the EntityManager (the opponent may since have been removed)
+  Raven_Bot*   pOpponent;
+  EntityHandle Opponent;
   
   //records the time the opponent was last sensed (seen or heard). This
   //is used to determine if a bot can 'remember' this record or not. 
@@ -48,7 +54,8 @@ public:
   bool        bShootable;
   
 
-  MemoryRecord():fTimeLastSensed(-999),
+  MemoryRecord():pOpponent(0),
+            fTimeLastSensed(-999),
             fTimeBecameVisible(-999),
             fTimeLastVisible(0),
             bWithinFOV(false),
@@ -62,7 +69,9 @@ class Raven_SensoryMemory
 {
 private:
 
-  typedef std::map<Raven_Bot*, MemoryRecord> MemoryMap;
+  //records are indexed by the opponent's bot slot (see Raven_Bot::Slot) so
+  //a lookup is a bounds check and an array access
+  typedef std::vector<MemoryRecord> MemoryMap;
 
 private:
   
@@ -74,25 +83,35 @@ private:
   //whenever the opponent is encountered. (when it is seen or heard)
   MemoryMap  m_MemoryMap;
 
+  //scratch buffer returned by GetListOfRecentlySensedOpponents. It is
+  //refilled on every call so no allocation is made once it has grown
+  mutable std::vector<Raven_Bot*> m_RecentlySensed;
+
   //a bot has a memory span equivalent to this value. When a bot requests a 
   //list of all recently sensed opponents this value is used to determine if 
   //the bot is able to remember an opponent or not.
   double      m_dMemorySpan;
 
   //this methods checks to see if there is an existing record for pBot. If
-  //not a new MemoryRecord record is made and added to the memory map.(called
-  //by UpdateWithSoundSource & UpdateVision)
-  void       MakeNewRecordIfNotAlreadyPresent(Raven_Bot* pBot);
+  //not a new MemoryRecord record is made and added to the memory map.
+  //Returns the record. (called by UpdateWithSoundSource & UpdateVision)
+  MemoryRecord&       MakeNewRecordIfNotAlreadyPresent(Raven_Bot* pBot);
+
+  //returns the record for pBot or null if there isn't one
+  const MemoryRecord* GetRecord(const Raven_Bot* pBot)const;
 
 public:
 
   Raven_SensoryMemory(Raven_Bot* owner, double MemorySpan);
 
+  void     SetMemorySpan(double MemorySpan){m_dMemorySpan = MemorySpan;}
+
   //this method is used to update the memory map whenever an opponent makes
   //a noise
   void     UpdateWithSoundSource(Raven_Bot* pNoiseMaker);
 
-  //this removes a bot's record from memory
+  //this removes a bot's record from memory. (Records of bots removed from
+  //the game are discarded automatically)
   void     RemoveBotFromMemory(Raven_Bot* pBot);
 
   //this method iterates through all the opponents in the game world and 
@@ -107,8 +126,9 @@ public:
   double    GetTimeOpponentHasBeenOutOfView(Raven_Bot* pOpponent)const;
 
   //this method returns a list of all the opponents that have had their
-  //records updated within the last m_dMemorySpan seconds.
-  std::list<Raven_Bot*> GetListOfRecentlySensedOpponents()const;
+  //records updated within the last m_dMemorySpan seconds. The reference is
+  //only valid until the next call.
+  const std::vector<Raven_Bot*>& GetListOfRecentlySensedOpponents()const;
 
   void     RenderBoxesAroundRecentlySensed()const;
 
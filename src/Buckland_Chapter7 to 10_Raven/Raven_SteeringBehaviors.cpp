@@ -25,11 +25,6 @@ Raven_Steering::Raven_Steering(Raven_Game* world, Raven_Bot* agent):
              m_pWorld(world),
              m_pRaven_Bot(agent),
              m_iFlags(0),
-             m_dWeightSeparation(script->GetDouble("SeparationWeight")),
-             m_dWeightWander(script->GetDouble("WanderWeight")),
-             m_dWeightWallAvoidance(script->GetDouble("WallAvoidanceWeight")),
-             m_dViewDistance(script->GetDouble("ViewDistance")),
-             m_dWallDetectionFeelerLength(script->GetDouble("WallDetectionFeelerLength")),
              m_Feelers(3),
              m_Deceleration(normal),
              m_pTargetAgent1(NULL),
@@ -37,14 +32,14 @@ Raven_Steering::Raven_Steering(Raven_Game* world, Raven_Bot* agent):
              m_dWanderDistance(WanderDist),
              m_dWanderJitter(WanderJitterPerSec),
              m_dWanderRadius(WanderRad),
-             m_dWeightSeek(script->GetDouble("SeekWeight")),
-             m_dWeightArrive(script->GetDouble("ArriveWeight")),
              m_bCellSpaceOn(false),
              m_SummingMethod(prioritized)
              
 
 
 {
+  ApplyParams(script->Params());
+
   //stuff for the wander behavior
   double theta = RandFloat() * TwoPi;
 
@@ -57,6 +52,20 @@ Raven_Steering::Raven_Steering(Raven_Game* world, Raven_Bot* agent):
 //---------------------------------dtor ----------------------------------
 Raven_Steering::~Raven_Steering(){}
 
+//----------------------------- ApplyParams ------------------------------
+//------------------------------------------------------------------------
+void Raven_Steering::ApplyParams(const Raven_Params& params)
+{
+  m_dWeightSeparation          = params.SeparationWeight;
+  m_dWeightWander              = params.WanderWeight;
+  m_dWeightWallAvoidance       = params.WallAvoidanceWeight;
+  m_dWeightSeek                = params.SeekWeight;
+  m_dWeightArrive              = params.ArriveWeight;
+
+  m_dViewDistance              = params.ViewDistance;
+  m_dWallDetectionFeelerLength = params.WallDetectionFeelerLength;
+}
+
 
 /////////////////////////////////////////////////////////////////////////////// CALCULATE METHODS 
 
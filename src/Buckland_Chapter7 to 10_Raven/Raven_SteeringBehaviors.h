@@ -21,6 +21,7 @@ class Raven_Bot;
 class Wall2D;
 class BaseGameEntity;
 class Raven_Game;
+struct Raven_Params;
 
 
 
@@ -179,6 +180,9 @@ public:
 
   virtual ~Raven_Steering();
 
+  //reads the behavior weights and the view and feeler distances from params
+  void     ApplyParams(const Raven_Params& params);
+
   //calculates and sums the steering forces from any active behaviors
   Vector2D Calculate();
 
@@ -1,15 +1,27 @@
 #include "Raven_TargetingSystem.h"
 #include "Raven_Bot.h"
 #include "Raven_SensoryMemory.h"
+#include "game/EntityManager.h"
 
 
 
 //-------------------------------- ctor ---------------------------------------
 //-----------------------------------------------------------------------------
-Raven_TargetingSystem::Raven_TargetingSystem(Raven_Bot* owner):m_pOwner(owner),
-                                                               m_pCurrentTarget(0)
+Raven_TargetingSystem::Raven_TargetingSystem(Raven_Bot* owner):m_pOwner(owner)
 {}
 
+//--------------------------- Get/SetTarget -----------------------------------
+//-----------------------------------------------------------------------------
+Raven_Bot* Raven_TargetingSystem::GetTarget()const
+{
+  return (Raven_Bot*)EntityMgr->GetEntityFromHandle(m_CurrentTarget);
+}
+
+void Raven_TargetingSystem::SetTarget(Raven_Bot* bot)
+{
+  m_CurrentTarget = bot ? bot->Handle() : EntityHandle();
+}
+
 
 
 //----------------------------- Update ----------------------------------------
@@ -18,13 +30,13 @@ Raven_TargetingSystem::Raven_TargetingSystem(Raven_Bot* owner):m_pOwner(owner),
 void Raven_TargetingSystem::Update()
 {
   double ClosestDistSoFar = MaxDouble;
-  m_pCurrentTarget       = 0;
+  ClearTarget();
 
   //grab a list of all the opponents the owner can sense
-  std::list<Raven_Bot*> SensedBots;
-  SensedBots = m_pOwner->GetSensoryMem()->GetListOfRecentlySensedOpponents();
+  const std::vector<Raven_Bot*>& SensedBots =
+                          m_pOwner->GetSensoryMem()->GetListOfRecentlySensedOpponents();
   
-  std::list<Raven_Bot*>::const_iterator curBot = SensedBots.begin();
+  std::vector<Raven_Bot*>::const_iterator curBot = SensedBots.begin();
   for (curBot; curBot != SensedBots.end(); ++curBot)
   {
     //make sure the bot is alive and that it is not the owner and he is not in our team
@@ -35,7 +47,7 @@ void Raven_TargetingSystem::Update()
       if (dist < ClosestDistSoFar)
       {
         ClosestDistSoFar = dist;
-        m_pCurrentTarget = *curBot;
+        SetTarget(*curBot);
       }
     }
   }
@@ -44,13 +56,13 @@ void Raven_TargetingSystem::Update()
 void Raven_TargetingSystem::UpdatePossessed(Vector2D CursorPos) {
 
 	double ClosestDistSoFar = MaxDouble;
-	m_pCurrentTarget = 0;
+	ClearTarget();
 
 	//grab a list of all the opponents the owner can sense
-	std::list<Raven_Bot*> SensedBots;
-	SensedBots = m_pOwner->GetSensoryMem()->GetListOfRecentlySensedOpponents();
+	const std::vector<Raven_Bot*>& SensedBots =
+	                        m_pOwner->GetSensoryMem()->GetListOfRecentlySensedOpponents();
 
-	std::list<Raven_Bot*>::const_iterator curBot = SensedBots.begin();
+	std::vector<Raven_Bot*>::const_iterator curBot = SensedBots.begin();
 	for (curBot; curBot != SensedBots.end(); ++curBot)
 	{
 		//make sure the bot is alive and that it is not the owner
@@ -63,7 +75,7 @@ void Raven_TargetingSystem::UpdatePossessed(Vector2D CursorPos) {
 				if (dist < ClosestDistSoFar)
 				{
 					ClosestDistSoFar = dist;
-					m_pCurrentTarget = *curBot;
+					SetTarget(*curBot);
 				}
 
 			}
@@ -77,27 +89,27 @@ void Raven_TargetingSystem::UpdatePossessed(Vector2D CursorPos) {
 
 bool Raven_TargetingSystem::isTargetWithinFOV()const
 {
-  return m_pOwner->GetSensoryMem()->isOpponentWithinFOV(m_pCurrentTarget);
+  return m_pOwner->GetSensoryMem()->isOpponentWithinFOV(GetTarget());
 }
 
 bool Raven_TargetingSystem::isTargetShootable()const
 {
-  return m_pOwner->GetSensoryMem()->isOpponentShootable(m_pCurrentTarget);
+  return m_pOwner->GetSensoryMem()->isOpponentShootable(GetTarget());
 }
 
 Vector2D Raven_TargetingSystem::GetLastRecordedPosition()const
 {
-  return m_pOwner->GetSensoryMem()->GetLastRecordedPositionOfOpponent(m_pCurrentTarget);
+  return m_pOwner->GetSensoryMem()->GetLastRecordedPositionOfOpponent(GetTarget());
 }
 
 double Raven_TargetingSystem::GetTimeTargetHasBeenVisible()const
 {
-  return m_pOwner->GetSensoryMem()->GetTimeOpponentHasBeenVisible(m_pCurrentTarget);
+  return m_pOwner->GetSensoryMem()->GetTimeOpponentHasBeenVisible(GetTarget());
 }
 
 double Raven_TargetingSystem::GetTimeTargetHasBeenOutOfView()const
 {
-  return m_pOwner->GetSensoryMem()->GetTimeOpponentHasBeenOutOfView(m_pCurrentTarget);
+  return m_pOwner->GetSensoryMem()->GetTimeOpponentHasBeenOutOfView(GetTarget());
 }
 
 
@@ -11,6 +11,7 @@
 //          perceptive memory.
 //-----------------------------------------------------------------------------
 #include "2d/Vector2D.h"
+#include "game/EntityHandle.h"
 #include <list>
 
 
@@ -26,8 +27,10 @@ private:
   //the owner of this system
   Raven_Bot*  m_pOwner;
 
-  //the current target (this will be null if there is no target assigned)
-  Raven_Bot*  m_pCurrentTarget;
+  //the current target (this will be null if there is no target assigned).
+  //A handle is kept so the target resolves to null once it has been
+  //removed from the game
+  EntityHandle m_CurrentTarget;
 
 
 public:
@@ -35,14 +38,14 @@ public:
   Raven_TargetingSystem(Raven_Bot* owner);
 
   //each time this method is called the opponents in the owner's sensory 
-  //memory are examined and the closest  is assigned to m_pCurrentTarget.
+  //memory are examined and the closest  is assigned as the current target.
   //if there are no opponents that have had their memory records updated
   //within the memory span of the owner then the current target is set
   //to null
   void       Update();
 
   //returns true if there is a currently assigned target
-  bool       isTargetPresent()const{return m_pCurrentTarget != 0;}
+  bool       isTargetPresent()const{return GetTarget() != 0;}
 
   //returns true if the target is within the field of view of the owner
   bool       isTargetWithinFOV()const;
@@ -62,13 +65,13 @@ public:
   double      GetTimeTargetHasBeenOutOfView()const;
 
   // Dfinie la target
-  void		 SetTarget(Raven_Bot* bot) { m_pCurrentTarget = bot; }
+  void		 SetTarget(Raven_Bot* bot);
   
   //returns a pointer to the target. null if no target current.
-  Raven_Bot* GetTarget()const{return m_pCurrentTarget;}
+  Raven_Bot* GetTarget()const;
 
   //sets the target pointer to null
-  void       ClearTarget(){m_pCurrentTarget=0;}
+  void       ClearTarget(){m_CurrentTarget = EntityHandle();}
 
   // Permet de savoir si un ennemi est dans la mme team que le bot de cette classe
   bool		 IsInTheSameTeam(std::string opponentNameTeam)const;
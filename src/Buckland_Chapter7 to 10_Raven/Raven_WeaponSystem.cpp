@@ -28,6 +28,25 @@ Raven_WeaponSystem::Raven_WeaponSystem(Raven_Bot* owner,
   InitializeFuzzyModuleWeaponSystem();
 }
 
+//--------------------------- SetAimParams ------------------------------------
+//-----------------------------------------------------------------------------
+void Raven_WeaponSystem::SetAimParams(double ReactionTime,
+                                      double AimAccuracy,
+                                      double AimPersistance)
+{
+  m_dAimAccuracy    = AimAccuracy;
+  m_dAimPersistance = AimPersistance;
+
+  if (m_dReactionTime != ReactionTime)
+  {
+    m_dReactionTime = ReactionTime;
+
+    m_FuzzyModule.Clear();
+
+    InitializeFuzzyModuleWeaponSystem();
+  }
+}
+
 //------------------------- dtor ----------------------------------------------
 //-----------------------------------------------------------------------------
 Raven_WeaponSystem::~Raven_WeaponSystem()
@@ -115,6 +115,12 @@ public:
 
   double         ReactionTime()const{return m_dReactionTime;}
 
+  //changes the bot's aiming skill (the fuzzy rules depend on the reaction
+  //time so they are rebuilt)
+  void          SetAimParams(double ReactionTime,
+                             double AimAccuracy,
+                             double AimPersistance);
+
   void          RenderCurrentWeapon()const;
   void          RenderDesirabilities()const;
 };
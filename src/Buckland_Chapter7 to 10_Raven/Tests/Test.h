@@ -0,0 +1,65 @@
+#ifndef RAVEN_TEST_H
+#define RAVEN_TEST_H
+#pragma warning (disable:4786)
+//-----------------------------------------------------------------------------
+//
+//  Name:   Test.h
+//
+//  Desc:   a minimal harness for the tests of Raven's navigation and
+//          messaging containers. Each Test_*.cpp file defines its tests
+//          with TEST(name) and its benchmarks with BENCHMARK(name), which
+//          register themselves with the runner in TestMain.cpp, and checks
+//          its results with TEST_CHECK and TEST_CHECK_CLOSE. A failed check
+//          is reported and the test carries on.
+//
+//          RavenTests runs every test and returns the number that failed.
+//          Run with the argument "bench" it runs the benchmarks instead.
+//-----------------------------------------------------------------------------
+#include <vector>
+#include <cmath>
+
+
+typedef void (*TestFunction)();
+
+struct TestCase
+{
+  const char*   Name;
+  TestFunction  Function;
+  bool          bIsBenchmark;
+};
+
+//the registered tests, in no particular order
+std::vector<TestCase>& TestCases();
+
+//records a failed check
+void ReportFailure(const char* check, const char* file, int line);
+
+//adds a test to TestCases when the program starts
+struct TestRegistrar
+{
+  TestRegistrar(const char* name, TestFunction function, bool bIsBenchmark)
+  {
+    TestCase test = {name, function, bIsBenchmark};
+
+    TestCases().push_back(test);
+  }
+};
+
+
+#define TEST_REGISTER(name, bench)                                           \
+  static void Test_##name();                                                 \
+  static TestRegistrar Registrar_##name(#name, Test_##name, bench);          \
+  static void Test_##name()
+
+#define TEST(name)       TEST_REGISTER(name, false)
+#define BENCHMARK(name)  TEST_REGISTER(name, true)
+
+#define TEST_CHECK(x)                                                        \
+  if (!(x)) ReportFailure(#x, __FILE__, __LINE__)
+
+#define TEST_CHECK_CLOSE(a, b)                                               \
+  if (!(std::fabs((double)(a) - (double)(b)) < 1e-6))                        \
+    ReportFailure(#a " == " #b, __FILE__, __LINE__)
+
+
+#endif
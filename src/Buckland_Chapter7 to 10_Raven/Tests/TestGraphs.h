@@ -0,0 +1,118 @@
+#ifndef RAVEN_TEST_GRAPHS_H
+#define RAVEN_TEST_GRAPHS_H
+#pragma warning (disable:4786)
+//-----------------------------------------------------------------------------
+//
+//  Name:   TestGraphs.h
+//
+//  Desc:   the navgraphs the tests are run on: the navgraph of one of the
+//          maps in the maps folder, and grids (optionally with walls) large
+//          enough to need the containers meant for big maps.
+//
+//          The tests are run from the Tests folder, so the maps are found
+//          in ../maps.
+//-----------------------------------------------------------------------------
+#include <vector>
+#include <string>
+
+#include "Graph/SparseGraph.h"
+#include "Graph/GraphNodeTypes.h"
+#include "Graph/GraphEdgeTypes.h"
+#include "Graph/FrozenGraph.h"
+#include "graph/NodeTypeEnumerations.h"
+
+
+typedef SparseGraph<NavGraphNode<void*>, NavGraphEdge>  TestNavGraph;
+typedef FrozenGraph<TestNavGraph>                       TestFrozenGraph;
+
+
+//-------------------------------- LoadMapGraph -------------------------------
+//
+//  loads the navgraph of a map (which comes first in the map file). Returns
+//  false if the map can't be read
+//-----------------------------------------------------------------------------
+inline bool LoadMapGraph(TestNavGraph& G, const std::string& MapName)
+{
+  return G.Load(("../maps/" + MapName).c_str());
+}
+
+//------------------------------- CreateWallGrid ------------------------------
+//
+//  adds a Width by Height grid of nodes Spacing apart, each joined to the
+//  nodes to its right and below. Blocked(x, y) says whether the edge from
+//  node x,y to the node below it is left out, which lets a test put walls
+//  in the grid
+//-----------------------------------------------------------------------------
+template <class blocked_func>
+void CreateWallGrid(TestNavGraph& G,
+                    int           Width,
+                    int           Height,
+                    double        Spacing,
+                    blocked_func  Blocked)
+{
+  for (int y=0; y<Height; ++y)
+  {
+    for (int x=0; x<Width; ++x)
+    {
+      G.AddNode(NavGraphNode<void*>(G.GetNextFreeNodeIndex(),
+                                    Vector2D(x*Spacing, y*Spacing)));
+    }
+  }
+
+  for (int y=0; y<Height; ++y)
+  {
+    for (int x=0; x<Width; ++x)
+    {
+      int nd = y*Width + x;
+
+      if (x+1 < Width)
+      {
+        G.AddEdge(NavGraphEdge(nd, nd+1, Spacing));
+      }
+
+      if (y+1 < Height && !Blocked(x, y))
+      {
+        G.AddEdge(NavGraphEdge(nd, nd+Width, Spacing));
+      }
+    }
+  }
+}
+
+//--------------------------------- CreateMaze --------------------------------
+//
+//  a Size by Size grid split by walls every twelve rows into long corridors,
+//  joined at alternate ends with the odd gap in between, so the shortest
+//  paths wind back and forth and the straight line distance is a poor guide
+//  to them
+//-----------------------------------------------------------------------------
+inline void CreateMaze(TestNavGraph& G, int Size)
+{
+  CreateWallGrid(G, Size, Size, 10,
+    [Size](int x, int y)
+    {
+      if (y % 12 != 6) return false;
+
+      bool bEndGap = ((y/12) % 2 == 0) ? x >= Size-3 : x < 3;
+      bool bMidGap = (x % 40 == 20) && ((y/12) % 3 == 0);
+
+      return !bEndGap && !bMidGap;
+    });
+}
+
+//--------------------------------- ValidNodes --------------------------------
+//-----------------------------------------------------------------------------
+template <class graph_type>
+std::vector<int> ValidNodes(const graph_type& G)
+{
+  std::vector<int> nodes;
+
+  for (int nd=0; nd<G.NumNodes(); ++nd)
+  {
+    if (G.GetNode(nd).Index() != invalid_node_index) nodes.push_back(nd);
+  }
+
+  return nodes;
+}
+
+
+#endif
@@ -0,0 +1,74 @@
+#include "Test.h"
+
+#include <iostream>
+#include <string>
+
+#include "misc/Cgdi.h"
+
+
+//the containers under test don't draw anything
+Cgdi* Cgdi::Instance(){return NULL;}
+
+
+//the failures of the test being run
+static int NumFailures = 0;
+
+//------------------------------- TestCases -----------------------------------
+//-----------------------------------------------------------------------------
+std::vector<TestCase>& TestCases()
+{
+  static std::vector<TestCase> tests;
+
+  return tests;
+}
+
+//----------------------------- ReportFailure ---------------------------------
+//-----------------------------------------------------------------------------
+void ReportFailure(const char* check, const char* file, int line)
+{
+  std::cout << file << "(" << line << "): check failed: " << check << std::endl;
+
+  ++NumFailures;
+}
+
+//--------------------------------- main --------------------------------------
+//
+//  runs the tests, or the benchmarks if the first argument is "bench", and
+//  returns the number of tests that failed
+//-----------------------------------------------------------------------------
+int main(int argc, char* argv[])
+{
+  bool bBenchmarks = (argc > 1) && (std::string(argv[1]) == "bench");
+
+  int NumRun    = 0;
+  int NumFailed = 0;
+
+  for (unsigned int t=0; t<TestCases().size(); ++t)
+  {
+    const TestCase& test = TestCases()[t];
+
+    if (test.bIsBenchmark != bBenchmarks) continue;
+
+    NumFailures = 0;
+
+    test.Function();
+
+    ++NumRun;
+
+    if (NumFailures > 0)
+    {
+      std::cout << test.Name << " FAILED (" << NumFailures << " checks)" << std::endl;
+
+      ++NumFailed;
+    }
+    else if (!bBenchmarks)
+    {
+      std::cout << test.Name << " passed" << std::endl;
+    }
+  }
+
+  std::cout << NumRun - NumFailed << " of " << NumRun << (bBenchmarks ? " benchmarks" : " tests")
+            << " passed" << std::endl;
+
+  return NumFailed;
+}
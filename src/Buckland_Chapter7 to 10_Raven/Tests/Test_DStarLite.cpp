@@ -0,0 +1,232 @@
+#include "Test.h"
+#include "TestGraphs.h"
+
+#include <map>
+#include <queue>
+#include <functional>
+#include <cstdlib>
+
+#include "navigation/TimeSlicedGraphAlgorithms.h"
+
+
+//the extra cost of the edges that have changed, keyed on their nodes, lower
+//index first
+static std::map<std::pair<int, int>, double> ExtraCosts;
+
+static std::pair<int, int> EdgeKey(int nd1, int nd2)
+{
+  return nd1 < nd2 ? std::make_pair(nd1, nd2) : std::make_pair(nd2, nd1);
+}
+
+//------------------------------ EdgeCost_Changing ----------------------------
+//
+//  an edge's own cost plus whatever the test has added to it
+//-----------------------------------------------------------------------------
+class EdgeCost_Changing
+{
+public:
+
+  static double Cost(const NavGraphEdge& edge)
+  {
+    std::map<std::pair<int, int>, double>::const_iterator it =
+                                    ExtraCosts.find(EdgeKey(edge.From(), edge.To()));
+
+    return edge.Cost() + (it == ExtraCosts.end() ? 0 : it->second);
+  }
+};
+
+//------------------------------- CostFromScratch -----------------------------
+//
+//  the cost of the shortest path from source to target with the edge costs
+//  as they are now, found by Dijkstra's algorithm. Like D* Lite, it counts
+//  every edge as costing at least a thousandth
+//-----------------------------------------------------------------------------
+static double CostFromScratch(const TestFrozenGraph& G, int source, int target)
+{
+  typedef std::pair<double, int> QueueEntry;
+
+  std::vector<double> costs(G.NumNodes(), MaxDouble);
+
+  std::priority_queue<QueueEntry, std::vector<QueueEntry>, std::greater<QueueEntry> > pq;
+
+  costs[source] = 0;
+
+  pq.push(QueueEntry(0, source));
+
+  while (!pq.empty())
+  {
+    double cost = pq.top().first;
+    int    nd   = pq.top().second;
+
+    pq.pop();
+
+    if (nd == target) return cost;
+
+    if (cost > costs[nd]) continue;
+
+    TestFrozenGraph::ConstEdgeIterator ConstEdgeItr(G, nd);
+    for (const NavGraphEdge* pE=ConstEdgeItr.begin();
+         !ConstEdgeItr.end();
+         pE=ConstEdgeItr.next())
+    {
+      double NewCost = cost + (std::max)(EdgeCost_Changing::Cost(*pE), 1e-3);
+
+      if (NewCost < costs[pE->To()])
+      {
+        costs[pE->To()] = NewCost;
+
+        pq.push(QueueEntry(NewCost, pE->To()));
+      }
+    }
+  }
+
+  return MaxDouble;
+}
+
+
+//----------------------------- DStarLite_Repair ------------------------------
+//
+//  a bot follows a path while the costs of random edges, and of an edge on
+//  its path, change under it. After each change the repaired search must
+//  give the path a search from scratch would, leading to the target, and on
+//  the whole repairing must take fewer cycles than the first search did
+//-----------------------------------------------------------------------------
+TEST(DStarLite_Repair)
+{
+  typedef Graph_SearchDStarLite_TS<TestFrozenGraph, Heuristic_Euclid, EdgeCost_Changing> DStarLite;
+
+  TestNavGraph graph(false);
+
+  TEST_CHECK(LoadMapGraph(graph, "Raven_DM1.map"));
+
+  TestFrozenGraph G(graph);
+
+  std::vector<int> nodes = ValidNodes(G);
+
+  std::vector<std::pair<int, int> > edges;
+
+  for (unsigned int n=0; n<nodes.size(); ++n)
+  {
+    TestFrozenGraph::ConstEdgeIterator ConstEdgeItr(G, nodes[n]);
+    for (const NavGraphEdge* pE=ConstEdgeItr.begin();
+         !ConstEdgeItr.end();
+         pE=ConstEdgeItr.next())
+    {
+      if (pE->From() < pE->To()) edges.push_back(EdgeKey(pE->From(), pE->To()));
+    }
+  }
+
+  std::srand(7);
+
+  long NumSearchCycles = 0;
+  long NumRepairCycles = 0;
+  int  NumRepairs      = 0;
+  int  NumWrong        = 0;
+
+  const int NumTrials = 50;
+
+  for (int trial=0; trial<NumTrials; ++trial)
+  {
+    ExtraCosts.clear();
+
+    int start  = nodes[std::rand() % nodes.size()];
+    int target = nodes[std::rand() % nodes.size()];
+
+    DStarLite search(G, start, target);
+
+    int result;
+
+    while ((result = search.CycleOnce()) == search_incomplete) ++NumSearchCycles;
+
+    if (std::fabs(search.GetCostToTarget() - CostFromScratch(G, start, target)) > 1e-6) ++NumWrong;
+
+    for (int change=0; change<10; ++change)
+    {
+      //the bot moves a few nodes along its path
+      std::list<int> path = search.GetPathToTarget();
+
+      std::list<int>::iterator it = path.begin();
+
+      for (int step=0; step<3 && it != path.end() && *it != target; ++step) ++it;
+
+      if (it != path.end()) start = *it;
+
+      search.SetStart(start);
+
+      //then some edges get dearer (some impassably so) or cheaper again
+      std::vector<int> changed;
+
+      for (int e=0; e<5; ++e)
+      {
+        std::pair<int, int> edge = edges[std::rand() % edges.size()];
+
+        if (std::rand() % 2 && !ExtraCosts.empty())
+        {
+          std::map<std::pair<int, int>, double>::iterator x = ExtraCosts.begin();
+
+          std::advance(x, std::rand() % ExtraCosts.size());
+
+          edge = x->first;
+
+          ExtraCosts.erase(x);
+        }
+        else
+        {
+          ExtraCosts[edge] = (std::rand() % 3 == 0) ? 1e5 : std::rand() % 200;
+        }
+
+        changed.push_back(edge.first);
+        changed.push_back(edge.second);
+      }
+
+      //including one on the path the bot is following
+      if (path.size() > 4)
+      {
+        std::list<int>::iterator mid = path.begin();
+
+        std::advance(mid, path.size() / 2);
+
+        int nd1 = *mid;
+        int nd2 = *(++mid);
+
+        ExtraCosts[EdgeKey(nd1, nd2)] = 500;
+
+        changed.push_back(nd1);
+        changed.push_back(nd2);
+      }
+
+      search.EdgeCostsChanged(changed);
+
+      ++NumRepairs;
+
+      while ((result = search.CycleOnce()) == search_incomplete) ++NumRepairCycles;
+
+      double expected = CostFromScratch(G, start, target);
+
+      //the path handed out must cost what the search says and reach the
+      //target
+      std::vector<const NavGraphEdge*> spt = search.GetSPT();
+
+      double cost = 0;
+
+      for (unsigned int e=0; e<spt.size(); ++e)
+      {
+        cost += (std::max)(EdgeCost_Changing::Cost(*spt[e]), 1e-3);
+      }
+
+      int end = spt.empty() ? start : spt.back()->To();
+
+      if (std::fabs(search.GetCostToTarget() - expected) > 1e-6 ||
+          std::fabs(cost - expected) > 1e-6                     ||
+          end != target)
+      {
+        ++NumWrong;
+      }
+    }
+  }
+
+  TEST_CHECK(NumWrong == 0);
+  TEST_CHECK((double)NumRepairCycles / NumRepairs < (double)NumSearchCycles / NumTrials);
+
+  ExtraCosts.clear();
+}
@@ -0,0 +1,224 @@
+#include "Test.h"
+#include "TestGraphs.h"
+
+#include <set>
+#include <queue>
+#include <functional>
+#include <cstdlib>
+
+#include "Graph/DistanceField.h"
+
+
+//------------------------------- CostsFromSources ----------------------------
+//
+//  the cost from every node to the nearest of sources, worked out from
+//  scratch by Dijkstra's algorithm started from all the sources at once
+//-----------------------------------------------------------------------------
+static std::vector<double> CostsFromSources(const TestFrozenGraph& G,
+                                            const std::set<int>&   sources)
+{
+  typedef std::pair<double, int> QueueEntry;
+
+  std::vector<double> costs(G.NumNodes(), MaxDouble);
+
+  std::priority_queue<QueueEntry, std::vector<QueueEntry>, std::greater<QueueEntry> > pq;
+
+  for (std::set<int>::const_iterator s=sources.begin(); s!=sources.end(); ++s)
+  {
+    costs[*s] = 0;
+
+    pq.push(QueueEntry(0, *s));
+  }
+
+  while (!pq.empty())
+  {
+    double cost = pq.top().first;
+    int    nd   = pq.top().second;
+
+    pq.pop();
+
+    if (cost > costs[nd]) continue;
+
+    TestFrozenGraph::ConstEdgeIterator ConstEdgeItr(G, nd);
+    for (const NavGraphEdge* pE=ConstEdgeItr.begin();
+         !ConstEdgeItr.end();
+         pE=ConstEdgeItr.next())
+    {
+      if (cost + pE->Cost() < costs[pE->To()])
+      {
+        costs[pE->To()] = cost + pE->Cost();
+
+        pq.push(QueueEntry(costs[pE->To()], pE->To()));
+      }
+    }
+  }
+
+  return costs;
+}
+
+//--------------------------------- CheckField --------------------------------
+//
+//  returns the number of nodes at which the field disagrees with costs: the
+//  node's cost must match, and following the field's edges from the node
+//  must reach its nearest source at that cost
+//-----------------------------------------------------------------------------
+static int CheckField(const DistanceField<TestFrozenGraph>& field,
+                      const std::vector<double>&            costs,
+                      const std::vector<int>&               nodes)
+{
+  int NumWrong = 0;
+
+  for (unsigned int n=0; n<nodes.size(); ++n)
+  {
+    int nd = nodes[n];
+
+    if (costs[nd] == MaxDouble)
+    {
+      if (field.Cost(nd) != MaxDouble || field.NextEdge(nd)) ++NumWrong;
+
+      continue;
+    }
+
+    double cost    = 0;
+    int    current = nd;
+    int    NumHops = 0;
+
+    for (const NavGraphEdge* pE = field.NextEdge(nd);
+         pE && NumHops < (int)nodes.size();
+         pE = field.NextEdge(current), ++NumHops)
+    {
+      cost   += pE->Cost();
+      current = pE->To();
+    }
+
+    if (std::fabs(field.Cost(nd) - costs[nd]) > 1e-6 ||
+        std::fabs(cost - costs[nd]) > 1e-6           ||
+        !field.isSource(current)                     ||
+        field.NearestSource(nd) != current)
+    {
+      ++NumWrong;
+    }
+  }
+
+  return NumWrong;
+}
+
+
+//------------------------- DistanceField_AddAndRemove ------------------------
+//
+//  sources are added and removed at random, and after each change the field
+//  must match one worked out from scratch
+//-----------------------------------------------------------------------------
+TEST(DistanceField_AddAndRemove)
+{
+  TestNavGraph graph(false);
+
+  TEST_CHECK(LoadMapGraph(graph, "Raven_DM1.map"));
+
+  TestFrozenGraph G(graph);
+
+  std::vector<int> nodes = ValidNodes(G);
+
+  DistanceField<TestFrozenGraph> field;
+
+  field.Build(G);
+
+  std::set<int> sources;
+
+  std::srand(5);
+
+  int NumWrong = 0;
+
+  for (int change=0; change<1000; ++change)
+  {
+    int nd = nodes[std::rand() % nodes.size()];
+
+    //remove a source about as often as one is added, once there are a few
+    if (!sources.count(nd) && sources.size() > 6 && std::rand() % 2)
+    {
+      std::set<int>::iterator it = sources.begin();
+
+      std::advance(it, std::rand() % sources.size());
+
+      nd = *it;
+    }
+
+    if (sources.count(nd))
+    {
+      field.RemoveSource(nd);
+
+      sources.erase(nd);
+    }
+    else
+    {
+      field.AddSource(nd);
+
+      sources.insert(nd);
+    }
+
+    TEST_CHECK(field.NumSources() == (int)sources.size());
+
+    if (CheckField(field, CostsFromSources(G, sources), nodes) > 0) ++NumWrong;
+  }
+
+  TEST_CHECK(NumWrong == 0);
+
+  //removing the last source leaves every node without one
+  while (!sources.empty())
+  {
+    field.RemoveSource(*sources.begin());
+
+    sources.erase(sources.begin());
+  }
+
+  TEST_CHECK(field.NumSources() == 0);
+  TEST_CHECK(CheckField(field, CostsFromSources(G, sources), nodes) == 0);
+}
+
+//--------------------------- DistanceField_Stepwise --------------------------
+//
+//  a queued source is worked out a node at a time. The field must be
+//  complete once PropagateOnce returns false, having taken about a step per
+//  node, and must then match one made with AddSource
+//-----------------------------------------------------------------------------
+TEST(DistanceField_Stepwise)
+{
+  TestNavGraph graph(false);
+
+  CreateMaze(graph, 60);
+
+  TestFrozenGraph G(graph);
+
+  std::vector<int> nodes = ValidNodes(G);
+
+  DistanceField<TestFrozenGraph> field;
+
+  field.Build(G);
+  field.QueueSource(0);
+
+  int NumSteps = 0;
+
+  while (field.PropagateOnce()) ++NumSteps;
+
+  TEST_CHECK(NumSteps >= (int)nodes.size() - 1);
+
+  std::set<int> sources;
+
+  sources.insert(0);
+
+  TEST_CHECK(CheckField(field, CostsFromSources(G, sources), nodes) == 0);
+
+  DistanceField<TestFrozenGraph> AddedField;
+
+  AddedField.Build(G);
+  AddedField.AddSource(0);
+
+  int NumDifferent = 0;
+
+  for (unsigned int n=0; n<nodes.size(); ++n)
+  {
+    if (field.NextEdge(nodes[n]) != AddedField.NextEdge(nodes[n])) ++NumDifferent;
+  }
+
+  TEST_CHECK(NumDifferent == 0);
+}
@@ -0,0 +1,148 @@
+#include "Test.h"
+
+#include <vector>
+#include <set>
+#include <cstdlib>
+
+#include "Game/EntityManager.h"
+#include "Game/BaseGameEntity.h"
+
+
+//an entity with nothing to it
+class TestEntity : public BaseGameEntity
+{
+public:
+
+  TestEntity():BaseGameEntity(BaseGameEntity::GetNextValidID()){}
+
+  void Render(){}
+};
+
+
+//--------------------------- EntityManager_Handles ---------------------------
+//
+//  entities are registered and removed at random. A live entity's handle
+//  and ID must find it, a removed entity's must find nothing even once its
+//  slot has been reused, and the packed table must hold exactly the live
+//  entities
+//-----------------------------------------------------------------------------
+TEST(EntityManager_Handles)
+{
+  EntityMgr->Reset();
+
+  std::vector<TestEntity*>   live;
+  std::vector<EntityHandle>  RemovedHandles;
+  std::vector<int>           RemovedIDs;
+
+  std::srand(11);
+
+  int NumWrong = 0;
+
+  for (int change=0; change<2000; ++change)
+  {
+    if (live.empty() || std::rand() % 3 != 0)
+    {
+      TestEntity* pEntity = new TestEntity();
+
+      EntityHandle h = EntityMgr->RegisterEntity(pEntity);
+
+      if (h != pEntity->Handle()) ++NumWrong;
+
+      live.push_back(pEntity);
+    }
+    else
+    {
+      int e = std::rand() % live.size();
+
+      RemovedHandles.push_back(live[e]->Handle());
+      RemovedIDs.push_back(live[e]->ID());
+
+      //deleting an entity removes it from the manager
+      delete live[e];
+
+      live[e] = live.back();
+      live.pop_back();
+    }
+  }
+
+  for (unsigned int e=0; e<live.size(); ++e)
+  {
+    if (EntityMgr->GetEntityFromHandle(live[e]->Handle()) != live[e]) ++NumWrong;
+    if (EntityMgr->TryGetEntityFromID(live[e]->ID()) != live[e])      ++NumWrong;
+    if (EntityMgr->GetEntityFromID(live[e]->ID()) != live[e])         ++NumWrong;
+  }
+
+  TEST_CHECK(NumWrong == 0);
+
+  int NumStale = 0;
+
+  for (unsigned int r=0; r<RemovedHandles.size(); ++r)
+  {
+    if (EntityMgr->isValid(RemovedHandles[r]))                ++NumStale;
+    if (EntityMgr->TryGetEntityFromID(RemovedIDs[r]) != NULL) ++NumStale;
+  }
+
+  TEST_CHECK(NumStale == 0);
+
+  //the slots of removed entities are reused rather than the table growing
+  std::set<unsigned int> slots;
+
+  for (unsigned int e=0; e<live.size(); ++e) slots.insert(live[e]->Handle().Index);
+
+  TEST_CHECK(slots.size() == live.size());
+  TEST_CHECK(*slots.rbegin() < live.size() + RemovedHandles.size() / 2);
+
+  std::set<BaseGameEntity*> registered(EntityMgr->GetEntities().begin(),
+                                       EntityMgr->GetEntities().end());
+
+  TEST_CHECK(registered == std::set<BaseGameEntity*>(live.begin(), live.end()));
+
+  //a reset leaves every handle stale, and the entities can then be deleted
+  std::vector<EntityHandle> handles;
+
+  for (unsigned int e=0; e<live.size(); ++e) handles.push_back(live[e]->Handle());
+
+  EntityMgr->Reset();
+
+  TEST_CHECK(EntityMgr->GetEntities().empty());
+
+  for (unsigned int e=0; e<live.size(); ++e)
+  {
+    TEST_CHECK(!EntityMgr->isValid(handles[e]));
+    TEST_CHECK(EntityMgr->TryGetEntityFromID(live[e]->ID()) == NULL);
+
+    delete live[e];
+  }
+}
+
+//---------------------------- EntityManager_Reuse ----------------------------
+//
+//  an entity registered in a freed slot gets a new generation, so the old
+//  handle doesn't find it
+//-----------------------------------------------------------------------------
+TEST(EntityManager_Reuse)
+{
+  EntityMgr->Reset();
+
+  TestEntity* pFirst = new TestEntity();
+
+  EntityHandle FirstHandle = EntityMgr->RegisterEntity(pFirst);
+
+  EntityMgr->RemoveEntity(pFirst);
+
+  TEST_CHECK(pFirst->Handle().isNull());
+
+  TestEntity* pSecond = new TestEntity();
+
+  EntityHandle SecondHandle = EntityMgr->RegisterEntity(pSecond);
+
+  TEST_CHECK(SecondHandle.Index == FirstHandle.Index);
+  TEST_CHECK(SecondHandle.Generation != FirstHandle.Generation);
+  TEST_CHECK(EntityMgr->GetEntityFromHandle(FirstHandle) == NULL);
+  TEST_CHECK(EntityMgr->GetEntityFromHandle(SecondHandle) == pSecond);
+
+  delete pFirst;
+  delete pSecond;
+
+  TEST_CHECK(EntityMgr->GetEntities().empty());
+}
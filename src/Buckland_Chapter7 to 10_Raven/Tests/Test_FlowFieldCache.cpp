@@ -0,0 +1,212 @@
+#include "Test.h"
+#include "TestGraphs.h"
+
+#include "navigation/FlowFieldCache.h"
+#include "navigation/TimeSlicedGraphAlgorithms.h"
+
+
+typedef FlowFieldCache<TestFrozenGraph>  TestFlowFields;
+
+
+//-------------------------------- BuildField ---------------------------------
+//
+//  asks for the field leading to target on behalf of enough requesters to
+//  have it made, then makes it and hands it to the cache. Returns false if
+//  the cache didn't ask for it to be made
+//-----------------------------------------------------------------------------
+static bool BuildField(TestFlowFields& cache, int source, int target, int MinRequests)
+{
+  bool bBuild = false;
+
+  for (int requester=0; requester<MinRequests && !bBuild; ++requester)
+  {
+    cache.Request(target, requester, bBuild);
+  }
+
+  if (!bBuild) return false;
+
+  TestFlowFields::FieldSearch* pSearch = cache.NewFieldSearch(source, target);
+
+  while (pSearch->CycleOnce() == search_incomplete);
+
+  pSearch->HandOver();
+
+  delete pSearch;
+
+  return true;
+}
+
+
+//--------------------------- FlowFieldCache_Requests -------------------------
+//
+//  a field is only made once its destination has been asked for by
+//  MinRequests different requesters, and only once at a time. The path
+//  read off it must be the one A* finds
+//-----------------------------------------------------------------------------
+TEST(FlowFieldCache_Requests)
+{
+  TestNavGraph graph(false);
+
+  TEST_CHECK(LoadMapGraph(graph, "Raven_DM1.map"));
+
+  TestFrozenGraph G(graph);
+
+  std::vector<int> nodes = ValidNodes(G);
+
+  int source = nodes.front();
+  int target = nodes[nodes.size() / 2];
+
+  TestFlowFields cache;
+
+  cache.SetGraph(&G, 4, 3);
+
+  bool bBuild;
+
+  //the same requester asking again doesn't count
+  TEST_CHECK(cache.Request(target, 1, bBuild) == NULL && !bBuild);
+  TEST_CHECK(cache.Request(target, 1, bBuild) == NULL && !bBuild);
+  TEST_CHECK(cache.Request(target, 2, bBuild) == NULL && !bBuild);
+  TEST_CHECK(cache.Request(target, 2, bBuild) == NULL && !bBuild);
+  TEST_CHECK(cache.Request(target, 3, bBuild) == NULL && bBuild);
+
+  //nor does anyone once the field is being made
+  TEST_CHECK(cache.Request(target, 4, bBuild) == NULL && !bBuild);
+  TEST_CHECK(cache.NumBuilding() == 1);
+
+  TestFlowFields::FieldSearch* pSearch = cache.NewFieldSearch(source, target);
+
+  int result;
+
+  while ((result = pSearch->CycleOnce()) == search_incomplete);
+
+  //the field isn't the cache's until it is handed over
+  TEST_CHECK(cache.Size() == 0);
+
+  pSearch->HandOver();
+
+  TEST_CHECK(cache.Size() == 1);
+  TEST_CHECK(cache.NumBuilding() == 0);
+  TEST_CHECK(cache.NumBuilt() == 1);
+
+  SearchWorkspacePool<NavGraphEdge> pool;
+
+  Graph_SearchAStar_TS<TestFrozenGraph, Heuristic_Euclid> AStar(G, source, target, &pool);
+
+  while (AStar.CycleOnce() == search_incomplete);
+
+  //the search still gives out its path after handing the field over
+  TEST_CHECK(result == target_found);
+  TEST_CHECK_CLOSE(pSearch->GetCostToTarget(), AStar.GetCostToTarget());
+  TEST_CHECK(pSearch->GetPathToTarget().size() == AStar.GetPathToTarget().size());
+
+  delete pSearch;
+
+  const TestFlowFields::FlowField* pField = cache.Request(target, 5, bBuild);
+
+  TEST_CHECK(pField != NULL && !bBuild);
+  TEST_CHECK(cache.NumHits() == 1);
+
+  if (pField)
+  {
+    TEST_CHECK_CLOSE(pField->Cost(source), AStar.GetCostToTarget());
+  }
+}
+
+//------------------------------ FlowFieldCache_LRU ---------------------------
+//
+//  when the cache is full the least recently used field is dropped
+//-----------------------------------------------------------------------------
+TEST(FlowFieldCache_LRU)
+{
+  TestNavGraph graph(false);
+
+  TEST_CHECK(LoadMapGraph(graph, "Raven_DM1.map"));
+
+  TestFrozenGraph G(graph);
+
+  std::vector<int> nodes = ValidNodes(G);
+
+  int source = nodes[0];
+  int first  = nodes[10];
+  int second = nodes[20];
+  int third  = nodes[30];
+
+  TestFlowFields cache;
+
+  cache.SetGraph(&G, 2, 2);
+
+  bool bBuild;
+
+  TEST_CHECK(BuildField(cache, source, first, 2));
+  TEST_CHECK(BuildField(cache, source, second, 2));
+
+  //using the first field makes the second the least recently used
+  TEST_CHECK(cache.Request(first, 0, bBuild) != NULL);
+
+  TEST_CHECK(BuildField(cache, source, third, 2));
+
+  TEST_CHECK(cache.Size() == 2);
+  TEST_CHECK(cache.Request(first, 0, bBuild) != NULL);
+  TEST_CHECK(cache.Request(third, 0, bBuild) != NULL);
+  TEST_CHECK(cache.Request(second, 0, bBuild) == NULL && !bBuild);
+
+  //a capacity of zero turns the cache off
+  cache.SetGraph(&G, 0, 1);
+
+  TEST_CHECK(cache.Request(first, 0, bBuild) == NULL && !bBuild);
+}
+
+//--------------------------- FlowFieldCache_Abandoned ------------------------
+//
+//  a field search deleted before it's done lets the field be asked for
+//  again, and a field made for a cache that has since been cleared is not
+//  taken
+//-----------------------------------------------------------------------------
+TEST(FlowFieldCache_Abandoned)
+{
+  TestNavGraph graph(false);
+
+  TEST_CHECK(LoadMapGraph(graph, "Raven_DM1.map"));
+
+  TestFrozenGraph G(graph);
+
+  std::vector<int> nodes = ValidNodes(G);
+
+  int source = nodes[0];
+  int target = nodes[50];
+
+  TestFlowFields cache;
+
+  cache.SetGraph(&G, 2, 1);
+
+  bool bBuild;
+
+  cache.Request(target, 0, bBuild);
+
+  TEST_CHECK(bBuild);
+
+  TestFlowFields::FieldSearch* pSearch = cache.NewFieldSearch(source, target);
+
+  pSearch->CycleOnce();
+
+  delete pSearch;
+
+  TEST_CHECK(cache.NumBuilding() == 0);
+
+  cache.Request(target, 0, bBuild);
+
+  TEST_CHECK(bBuild);
+
+  pSearch = cache.NewFieldSearch(source, target);
+
+  while (pSearch->CycleOnce() == search_incomplete);
+
+  cache.SetGraph(&G, 2, 1);
+
+  pSearch->HandOver();
+
+  delete pSearch;
+
+  TEST_CHECK(cache.Size() == 0);
+  TEST_CHECK(cache.NumBuilt() == 0);
+}
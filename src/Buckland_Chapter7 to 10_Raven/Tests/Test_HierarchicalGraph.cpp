@@ -0,0 +1,164 @@
+#include "Test.h"
+#include "TestGraphs.h"
+
+#include <algorithm>
+
+#include "Graph/HierarchicalGraph.h"
+#include "navigation/TimeSlicedGraphAlgorithms.h"
+
+
+//---------------------------------- PathLength -------------------------------
+//
+//  the length of a path, or -1 if its edges don't join up from source to
+//  target
+//-----------------------------------------------------------------------------
+static double PathLength(const std::list<PathEdge>& path, Vector2D source, Vector2D target)
+{
+  double   length  = 0;
+  Vector2D current = source;
+
+  for (std::list<PathEdge>::const_iterator e=path.begin(); e!=path.end(); ++e)
+  {
+    if (!(e->Source() == current)) return -1;
+
+    length += Vec2DDistance(e->Source(), e->Destination());
+    current = e->Destination();
+  }
+
+  return current == target ? length : -1;
+}
+
+//------------------------------ CheckAgainstAStar ----------------------------
+//
+//  hierarchical A* must find a path between a sample of nodes wherever A*
+//  does, at the same cost, and the path refined a cluster at a time must be
+//  as long as A*'s
+//-----------------------------------------------------------------------------
+static void CheckAgainstAStar(const TestFrozenGraph& G, double ClusterSize)
+{
+  typedef Graph_SearchHPA_TS<TestFrozenGraph, Heuristic_Euclid>  HPASearch;
+
+  HierarchicalGraph<TestFrozenGraph> hierarchy;
+
+  hierarchy.Build(G, ClusterSize);
+
+  TEST_CHECK(hierarchy.NumClusters() > 1);
+
+  SearchWorkspacePool<NavGraphEdge>          pool;
+  HPASearch::WorkspacePool                   AbstractPool;
+
+  std::vector<int> nodes = ValidNodes(G);
+
+  int step = std::max(1, (int)nodes.size() / 25);
+
+  for (unsigned int s=0; s<nodes.size(); s+=step)
+  {
+    for (unsigned int t=3; t<nodes.size(); t+=step+1)
+    {
+      int source = nodes[s];
+      int target = nodes[t];
+
+      Graph_SearchAStar_TS<TestFrozenGraph, Heuristic_Euclid> AStar(G, source, target, &pool);
+      HPASearch                                               HPA(hierarchy, source, target, &AbstractPool);
+
+      int AStarResult, HPAResult;
+
+      while ((AStarResult = AStar.CycleOnce()) == search_incomplete);
+      while ((HPAResult   = HPA.CycleOnce())   == search_incomplete);
+
+      TEST_CHECK(AStarResult == HPAResult);
+
+      if (AStarResult != target_found || HPAResult != target_found) continue;
+
+      TEST_CHECK_CLOSE(HPA.GetCostToTarget(), AStar.GetCostToTarget());
+
+      std::list<PathEdge> path = HPA.GetPathAsPathEdges();
+
+      while (HPA.HasUnrefinedPath()) HPA.RefineNextSegment(path);
+
+      TEST_CHECK(!HPA.RefinementFailed());
+
+      std::list<PathEdge> AStarPath = AStar.GetPathAsPathEdges();
+
+      Vector2D from = G.GetNode(source).Pos();
+      Vector2D to   = G.GetNode(target).Pos();
+
+      TEST_CHECK_CLOSE(PathLength(path, from, to), PathLength(AStarPath, from, to));
+    }
+  }
+
+  TEST_CHECK(AbstractPool.NumInUse() == 0);
+}
+
+
+//--------------------------- HierarchicalGraph_Map ---------------------------
+//-----------------------------------------------------------------------------
+TEST(HierarchicalGraph_Map)
+{
+  TestNavGraph graph(false);
+
+  TEST_CHECK(LoadMapGraph(graph, "Raven_DM1.map"));
+
+  TestFrozenGraph G(graph);
+
+  CheckAgainstAStar(G, 60);
+  CheckAgainstAStar(G, 250);
+}
+
+//--------------------------- HierarchicalGraph_Maze --------------------------
+//
+//  a graph ten times the size of DM1, split into a hundred clusters
+//-----------------------------------------------------------------------------
+TEST(HierarchicalGraph_Maze)
+{
+  TestNavGraph graph(false);
+
+  CreateMaze(graph, 60);
+
+  TestFrozenGraph G(graph);
+
+  CheckAgainstAStar(G, 60);
+}
+
+//------------------------ HierarchicalGraph_StaleRefinement ------------------
+//
+//  a corridor of 40 nodes in four clusters. Once the path along it has been
+//  found, an edge inside the third cluster is removed, so that cluster can
+//  no longer be crossed. Refining the path must then fail there: the path
+//  handed out stops at the entrance to that cluster instead of running on
+//  through the gap
+//-----------------------------------------------------------------------------
+TEST(HierarchicalGraph_StaleRefinement)
+{
+  typedef Graph_SearchHPA_TS<TestNavGraph, Heuristic_Euclid>  HPASearch;
+
+  TestNavGraph G(false);
+
+  CreateWallGrid(G, 40, 1, 10, [](int, int){return false;});
+
+  HierarchicalGraph<TestNavGraph> hierarchy;
+
+  hierarchy.Build(G, 100);
+
+  TEST_CHECK(hierarchy.NumClusters() == 4);
+
+  HPASearch::WorkspacePool pool;
+
+  HPASearch HPA(hierarchy, 0, 39, &pool);
+
+  while (HPA.CycleOnce() == search_incomplete);
+
+  std::list<PathEdge> path = HPA.GetPathAsPathEdges();
+
+  HPA.RefineNextSegment(path);
+
+  TEST_CHECK(!HPA.RefinementFailed());
+
+  G.RemoveEdge(24, 25);
+
+  while (HPA.HasUnrefinedPath()) HPA.RefineNextSegment(path);
+
+  TEST_CHECK(HPA.RefinementFailed());
+  TEST_CHECK(!path.empty());
+  TEST_CHECK(path.back().Destination() == G.GetNode(20).Pos());
+}
@@ -0,0 +1,175 @@
+#include "Test.h"
+#include "TestGraphs.h"
+
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <chrono>
+
+#include "Graph/LandmarkTable.h"
+#include "navigation/TimeSlicedGraphAlgorithms.h"
+
+
+//the results of running the same searches with the straight line distance
+//and with the ALT heuristic
+struct HeuristicComparison
+{
+  int     NumSearches;
+  int     NumMismatches;
+
+  long    EuclidExpansions;
+  long    ALTExpansions;
+
+  double  EuclidSeconds;
+  double  ALTSeconds;
+};
+
+//------------------------------- CompareHeuristics ---------------------------
+//
+//  searches between about SampleSize sources and as many targets, once with
+//  each heuristic, counting the nodes each expands. Both heuristics are
+//  admissible, so the searches must agree on the cost of every path
+//-----------------------------------------------------------------------------
+static HeuristicComparison CompareHeuristics(const TestFrozenGraph& G,
+                                             int                    NumLandmarks,
+                                             int                    SampleSize)
+{
+  typedef std::chrono::steady_clock Clock;
+
+  LandmarkTable<TestFrozenGraph> landmarks;
+
+  landmarks.Build(G, NumLandmarks);
+
+  Heuristic_ALT<TestFrozenGraph>::SetLandmarks(&landmarks);
+
+  SearchWorkspacePool<NavGraphEdge> pool;
+
+  HeuristicComparison result = {0, 0, 0, 0, 0.0, 0.0};
+
+  std::vector<int> nodes = ValidNodes(G);
+
+  int step = std::max(1, (int)nodes.size() / SampleSize);
+
+  for (unsigned int s=0; s<nodes.size(); s+=step)
+  {
+    for (unsigned int t=1; t<nodes.size(); t+=step+2)
+    {
+      ++result.NumSearches;
+
+      Clock::time_point start = Clock::now();
+
+      Graph_SearchAStar_TS<TestFrozenGraph, Heuristic_Euclid> euclid(G, nodes[s], nodes[t], &pool);
+
+      int EuclidResult;
+
+      while ((EuclidResult = euclid.CycleOnce()) == search_incomplete) ++result.EuclidExpansions;
+
+      Clock::time_point middle = Clock::now();
+
+      Graph_SearchAStar_TS<TestFrozenGraph, Heuristic_ALT<TestFrozenGraph> > alt(G, nodes[s], nodes[t], &pool);
+
+      int ALTResult;
+
+      while ((ALTResult = alt.CycleOnce()) == search_incomplete) ++result.ALTExpansions;
+
+      Clock::time_point end = Clock::now();
+
+      result.EuclidSeconds += std::chrono::duration<double>(middle - start).count();
+      result.ALTSeconds    += std::chrono::duration<double>(end - middle).count();
+
+      if (EuclidResult != ALTResult ||
+          (EuclidResult == target_found &&
+           std::fabs(euclid.GetCostToTarget() - alt.GetCostToTarget()) > 1e-6))
+      {
+        ++result.NumMismatches;
+      }
+    }
+  }
+
+  Heuristic_ALT<TestFrozenGraph>::SetLandmarks(NULL);
+
+  return result;
+}
+
+//----------------------------------- Report ----------------------------------
+//-----------------------------------------------------------------------------
+static void Report(const char*                name,
+                   const TestFrozenGraph&     G,
+                   int                        NumLandmarks,
+                   const HeuristicComparison& result)
+{
+  std::cout << std::fixed << std::setprecision(1)
+            << name << ": " << G.NumNodes() << " nodes, " << NumLandmarks << " landmarks, "
+            << result.NumSearches << " searches. Nodes expanded: "
+            << result.EuclidExpansions << " -> " << result.ALTExpansions << " ("
+            << 100.0 * result.ALTExpansions / result.EuclidExpansions << "%), time: "
+            << result.EuclidSeconds * 1000 << "ms -> " << result.ALTSeconds * 1000 << "ms"
+            << std::endl;
+}
+
+
+//---------------------------- LandmarkTable_ALT ------------------------------
+//
+//  ALT must find paths as short as the straight line distance does, and on
+//  the maze, where the straight line is a poor guide, expand fewer nodes
+//-----------------------------------------------------------------------------
+TEST(LandmarkTable_ALT)
+{
+  TestNavGraph map(false);
+
+  TEST_CHECK(LoadMapGraph(map, "Raven_DM1.map"));
+
+  TestNavGraph maze(false);
+
+  CreateMaze(maze, 60);
+
+  TestFrozenGraph MapGraph(map);
+  TestFrozenGraph MazeGraph(maze);
+
+  TEST_CHECK(CompareHeuristics(MapGraph, 8, 30).NumMismatches == 0);
+
+  HeuristicComparison result = CompareHeuristics(MazeGraph, 8, 30);
+
+  TEST_CHECK(result.NumMismatches == 0);
+  TEST_CHECK(result.ALTExpansions < result.EuclidExpansions);
+}
+
+//------------------------------- ALT_vs_Euclid -------------------------------
+//
+//  the nodes expanded, and the time taken, by A* with each heuristic for 4, 8
+//  and 16 landmarks (see NumLandmarks in Params.ini) on DM1 and on a 120x120
+//  maze
+//-----------------------------------------------------------------------------
+BENCHMARK(ALT_vs_Euclid)
+{
+  TestNavGraph map(false);
+
+  TEST_CHECK(LoadMapGraph(map, "Raven_DM1.map"));
+
+  TestNavGraph maze(false);
+
+  CreateMaze(maze, 120);
+
+  TestFrozenGraph MapGraph(map);
+  TestFrozenGraph MazeGraph(maze);
+
+  const int NumLandmarks[] = {4, 8, 16};
+
+  for (int k=0; k<3; ++k)
+  {
+    HeuristicComparison result = CompareHeuristics(MapGraph, NumLandmarks[k], 120);
+
+    TEST_CHECK(result.NumMismatches == 0);
+
+    Report("DM1", MapGraph, NumLandmarks[k], result);
+  }
+
+  for (int k=0; k<3; ++k)
+  {
+    HeuristicComparison result = CompareHeuristics(MazeGraph, NumLandmarks[k], 120);
+
+    TEST_CHECK(result.NumMismatches == 0);
+
+    Report("maze", MazeGraph, NumLandmarks[k], result);
+  }
+}
@@ -0,0 +1,167 @@
+#include "Test.h"
+#include "TestGraphs.h"
+
+#include <algorithm>
+
+#include "Graph/NextHopTable.h"
+#include "Graph/HandyGraphFunctions.h"
+#include "navigation/TimeSlicedGraphAlgorithms.h"
+
+
+//-------------------------- CheckAgainstAllPairs -----------------------------
+//
+//  the table must give the same next hop as CreateAllPairsTable for every
+//  pair of nodes, whether it was made on one thread or on several
+//-----------------------------------------------------------------------------
+static void CheckAgainstAllPairs(const TestFrozenGraph& G, int NumThreads)
+{
+  NextHopTable<TestFrozenGraph> table;
+
+  TEST_CHECK(table.Build(G, NumThreads));
+
+  std::vector<std::vector<int> > AllPairs = CreateAllPairsTable(G);
+
+  int NumDifferent = 0;
+
+  for (int source=0; source<G.NumNodes(); ++source)
+  {
+    for (int target=0; target<G.NumNodes(); ++target)
+    {
+      //(CreateAllPairsTable marks a missing path with -1)
+      int expected = AllPairs[source][target];
+
+      if (expected < 0) expected = invalid_node_index;
+
+      if (table.NextHop(source, target) != expected) ++NumDifferent;
+    }
+  }
+
+  TEST_CHECK(NumDifferent == 0);
+}
+
+//----------------------------- CheckAgainstAStar -----------------------------
+//
+//  following the table's edges from a sample of sources must reach each of a
+//  sample of targets at the cost A* finds, and must find no path where A*
+//  finds none
+//-----------------------------------------------------------------------------
+static void CheckAgainstAStar(const TestFrozenGraph& G)
+{
+  NextHopTable<TestFrozenGraph> table;
+
+  TEST_CHECK(table.Build(G));
+
+  SearchWorkspacePool<NavGraphEdge> pool;
+
+  std::vector<int> nodes = ValidNodes(G);
+
+  int step = std::max(1, (int)nodes.size() / 40);
+
+  for (unsigned int s=0; s<nodes.size(); s+=step)
+  {
+    for (unsigned int t=1; t<nodes.size(); t+=step+1)
+    {
+      int source = nodes[s];
+      int target = nodes[t];
+
+      Graph_SearchAStar_TS<TestFrozenGraph, Heuristic_Euclid> AStar(G, source, target, &pool);
+
+      int result;
+
+      while ((result = AStar.CycleOnce()) == search_incomplete);
+
+      if (result != target_found)
+      {
+        TEST_CHECK(table.NextHop(source, target) == invalid_node_index);
+
+        continue;
+      }
+
+      //follow the table to the target, giving up if it loops
+      double cost    = 0;
+      int    current = source;
+      int    NumHops = 0;
+
+      for (const NavGraphEdge* pE = table.NextEdge(source, target);
+           pE && NumHops < G.NumNodes();
+           pE = table.NextEdge(current, target), ++NumHops)
+      {
+        cost   += pE->Cost();
+        current = pE->To();
+      }
+
+      TEST_CHECK(current == target);
+      TEST_CHECK_CLOSE(cost, AStar.GetCostToTarget());
+    }
+  }
+}
+
+
+//---------------------------- NextHopTable_Map -------------------------------
+//-----------------------------------------------------------------------------
+TEST(NextHopTable_Map)
+{
+  TestNavGraph graph(false);
+
+  TEST_CHECK(LoadMapGraph(graph, "Raven_DM1.map"));
+
+  TestFrozenGraph G(graph);
+
+  CheckAgainstAllPairs(G, 1);
+  CheckAgainstAllPairs(G, 0);
+  CheckAgainstAStar(G);
+}
+
+//---------------------------- NextHopTable_Grid ------------------------------
+//
+//  a grid close to the largest the table is made for, with walls that leave
+//  a gap every ten nodes
+//-----------------------------------------------------------------------------
+TEST(NextHopTable_Grid)
+{
+  TestNavGraph graph(false);
+
+  CreateWallGrid(graph, 38, 38, 10,
+                 [](int x, int y){return (y % 6 == 3) && (x % 10 != 0);});
+
+  TestFrozenGraph G(graph);
+
+  CheckAgainstAllPairs(G, 1);
+  CheckAgainstAllPairs(G, 0);
+  CheckAgainstAStar(G);
+}
+
+//--------------------------- NextHopTable_Stored -----------------------------
+//
+//  a table assigned the entries of another, as when it is read back from a
+//  compiled map, must give the same next hops
+//-----------------------------------------------------------------------------
+TEST(NextHopTable_Stored)
+{
+  TestNavGraph graph(false);
+
+  TEST_CHECK(LoadMapGraph(graph, "Raven_DM1.map"));
+
+  TestFrozenGraph G(graph);
+
+  NextHopTable<TestFrozenGraph> built;
+  NextHopTable<TestFrozenGraph> stored;
+
+  TEST_CHECK(built.Entries() == NULL);
+  TEST_CHECK(built.Build(G));
+  TEST_CHECK(stored.Assign(G, built.Entries()));
+
+  TEST_CHECK(stored.SizeInBytes() == built.SizeInBytes());
+
+  int NumDifferent = 0;
+
+  for (int source=0; source<G.NumNodes(); ++source)
+  {
+    for (int target=0; target<G.NumNodes(); ++target)
+    {
+      if (stored.NextHop(source, target) != built.NextHop(source, target)) ++NumDifferent;
+    }
+  }
+
+  TEST_CHECK(NumDifferent == 0);
+}
@@ -0,0 +1,79 @@
+#include "Test.h"
+#include "TestGraphs.h"
+
+#include "Graph/PathCostTable.h"
+
+
+typedef PathCostTable<TestFrozenGraph>  TestPathCosts;
+
+
+//------------------------------ PathCostTable_Stored -------------------------
+//
+//  a table assigned the stored costs of another, whatever the layout and
+//  precision of each, must give the same costs as one built from scratch
+//  (to within a float's precision where either holds floats), and its own
+//  stored costs must be the size StoredSize says
+//-----------------------------------------------------------------------------
+TEST(PathCostTable_Stored)
+{
+  TestNavGraph graph(false);
+
+  TEST_CHECK(LoadMapGraph(graph, "Raven_DM1.map"));
+
+  TestFrozenGraph G(graph);
+
+  const int N = G.NumNodes();
+
+  TestPathCosts exact;
+
+  exact.Build(G, TestPathCosts::full, TestPathCosts::double_precision);
+
+  const TestPathCosts::layout    layouts[]    = {TestPathCosts::full,
+                                                 TestPathCosts::triangular};
+  const TestPathCosts::precision precisions[] = {TestPathCosts::double_precision,
+                                                 TestPathCosts::single_precision};
+
+  for (int sl=0; sl<2; ++sl)
+  for (int sp=0; sp<2; ++sp)
+  {
+    TestPathCosts source;
+
+    source.Build(G, layouts[sl], precisions[sp]);
+
+    TEST_CHECK(source.StoredCosts() != NULL);
+    TEST_CHECK(source.MemoryUsed() == TestPathCosts::StoredSize(N, layouts[sl], precisions[sp]));
+
+    for (int l=0; l<2; ++l)
+    for (int p=0; p<2; ++p)
+    {
+      TestPathCosts table;
+
+      table.Assign(G, source.StoredCosts(), layouts[sl], precisions[sp], layouts[l], precisions[p]);
+
+      bool bFloats = (precisions[sp] == TestPathCosts::single_precision) ||
+                     (precisions[p]  == TestPathCosts::single_precision);
+
+      int NumWrong = 0;
+
+      for (int a=0; a<N; ++a)
+      {
+        for (int b=0; b<N; ++b)
+        {
+          double expected  = exact.Cost(a, b);
+          double tolerance = bFloats ? 1e-6 * expected + 1e-6 : 1e-9;
+
+          if (std::fabs(table.Cost(a, b) - expected) > tolerance) ++NumWrong;
+        }
+      }
+
+      TEST_CHECK(NumWrong == 0);
+    }
+  }
+
+  //an on demand table has nothing to store
+  TestPathCosts OnDemand;
+
+  OnDemand.Build(G, TestPathCosts::on_demand, TestPathCosts::double_precision, 1024);
+
+  TEST_CHECK(OnDemand.StoredCosts() == NULL);
+}
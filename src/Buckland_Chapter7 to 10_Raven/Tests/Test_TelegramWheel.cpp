@@ -0,0 +1,146 @@
+#include "Test.h"
+
+#include <vector>
+#include <cstdlib>
+
+#include "Messaging/TelegramWheel.h"
+
+
+//---------------------------- TelegramWheel_Expiry ---------------------------
+//
+//  telegrams are queued for ticks spread over every wheel and the overflow,
+//  some while the wheel is advancing. Each must come out exactly once, on
+//  the call to Advance that passes its tick
+//-----------------------------------------------------------------------------
+TEST(TelegramWheel_Expiry)
+{
+  TelegramWheel wheel;
+
+  //each telegram's receiver is its index here
+  std::vector<long> DueTicks;
+  std::vector<int>  TimesExpired;
+
+  std::srand(3);
+
+  for (int t=0; t<5000; ++t)
+  {
+    //mostly near, with some on each of the outer wheels and beyond them
+    long delay;
+
+    switch (std::rand() % 4)
+    {
+      case 0:  delay = std::rand() % 256;                          break;
+      case 1:  delay = std::rand() % (1 << 14);                    break;
+      case 2:  delay = (long)(std::rand() % 1024) * 1024;          break;
+      default: delay = (1L << 20) + (long)(std::rand() % 2048) * 1024;
+    }
+
+    long due = wheel.CurrentTick() + 1 + delay;
+
+    TEST_CHECK(wheel.Insert(Telegram(0, 0, t, 0), due));
+
+    DueTicks.push_back(due);
+    TimesExpired.push_back(0);
+
+    //the wheel moves on now and again as telegrams are queued
+    if (t % 50 == 49)
+    {
+      long now = wheel.CurrentTick() + std::rand() % 300;
+
+      std::vector<Telegram> expired;
+
+      wheel.Advance(now, expired);
+
+      for (unsigned int e=0; e<expired.size(); ++e)
+      {
+        int id = expired[e].Receiver;
+
+        ++TimesExpired[id];
+
+        TEST_CHECK(DueTicks[id] <= now);
+      }
+    }
+  }
+
+  TEST_CHECK(wheel.Size() > 0);
+
+  //then runs until every telegram is out, in uneven steps
+  long LastTick = wheel.CurrentTick();
+
+  int NumEarly = 0;
+  int NumLate  = 0;
+
+  while (!wheel.Empty())
+  {
+    long now = LastTick + 1 + std::rand() % 5000;
+
+    std::vector<Telegram> expired;
+
+    wheel.Advance(now, expired);
+
+    for (unsigned int e=0; e<expired.size(); ++e)
+    {
+      int id = expired[e].Receiver;
+
+      ++TimesExpired[id];
+
+      if (DueTicks[id] > now)       ++NumEarly;
+      if (DueTicks[id] <= LastTick) ++NumLate;
+    }
+
+    LastTick = now;
+  }
+
+  TEST_CHECK(NumEarly == 0);
+  TEST_CHECK(NumLate == 0);
+
+  int NumNotOnce = 0;
+
+  for (unsigned int id=0; id<TimesExpired.size(); ++id)
+  {
+    if (TimesExpired[id] != 1) ++NumNotOnce;
+  }
+
+  TEST_CHECK(NumNotOnce == 0);
+}
+
+//--------------------------- TelegramWheel_Insert ----------------------------
+//
+//  an equivalent telegram for the same tick is discarded, and one due on a
+//  tick that has passed falls due on the next
+//-----------------------------------------------------------------------------
+TEST(TelegramWheel_Insert)
+{
+  TelegramWheel wheel(100);
+
+  TEST_CHECK(wheel.Insert(Telegram(1.0, 1, 2, 3), 150));
+  TEST_CHECK(!wheel.Insert(Telegram(1.1, 1, 2, 3), 150));
+  TEST_CHECK(wheel.Insert(Telegram(1.0, 1, 2, 3), 151));
+  TEST_CHECK(wheel.Insert(Telegram(1.0, 1, 2, 4), 150));
+  TEST_CHECK(wheel.Size() == 3);
+
+  TEST_CHECK(wheel.Insert(Telegram(0.0, 5, 6, 7), 50));
+
+  std::vector<Telegram> expired;
+
+  wheel.Advance(101, expired);
+
+  TEST_CHECK(expired.size() == 1);
+  TEST_CHECK(expired.size() == 1 && expired[0].Sender == 5);
+
+  expired.clear();
+
+  wheel.Advance(150, expired);
+
+  TEST_CHECK(expired.size() == 2);
+
+  wheel.Clear(1000);
+
+  TEST_CHECK(wheel.Empty());
+  TEST_CHECK(wheel.CurrentTick() == 1000);
+
+  //an empty wheel jumps straight to the tick it's advanced to
+  wheel.Advance(5000, expired);
+
+  TEST_CHECK(wheel.CurrentTick() == 5000);
+}
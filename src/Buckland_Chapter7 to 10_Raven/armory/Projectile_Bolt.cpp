@@ -20,11 +20,11 @@ Bolt::Bolt(Raven_Bot* shooter, Vector2D target):
                          shooter->ID(),
                          shooter->Pos(),
                          shooter->Facing(),
-                         script->GetInt("Bolt_Damage"),
-                         script->GetDouble("Bolt_Scale"),
-                         script->GetDouble("Bolt_MaxSpeed"),
-                         script->GetDouble("Bolt_Mass"),
-                         script->GetDouble("Bolt_MaxForce"))
+                         script->Params().Bolt_Damage,
+                         script->Params().Bolt_Scale,
+                         script->Params().Bolt_MaxSpeed,
+                         script->Params().Bolt_Mass,
+                         script->Params().Bolt_MaxForce)
 {
    assert (target != Vector2D());
 }
@@ -76,7 +76,7 @@ void Bolt::Update()
                                                  m_vPosition,
                                                  dist,
                                                  m_vImpactPoint,
-                                                 m_pWorld->GetMap()->GetWalls()))
+                                                 m_pWorld->GetMap()->GetWallTable()))
      {
        m_bDead     = true;
        m_bImpacted = true;
@@ -22,14 +22,14 @@ Grenade::Grenade(Raven_Bot* shooter, Vector2D target) :
 		shooter->ID(),
 		shooter->Pos(),
 		shooter->Facing(),
-		script->GetInt("Grenade_Damage"),
-		script->GetDouble("Grenade_Scale"),
-		script->GetDouble("Grenade_MaxSpeed"),
-		script->GetDouble("Grenade_Mass"),
-		script->GetDouble("Grenade_MaxForce")),
+		script->Params().Grenade_Damage,
+		script->Params().Grenade_Scale,
+		script->Params().Grenade_MaxSpeed,
+		script->Params().Grenade_Mass,
+		script->Params().Grenade_MaxForce),
 
 	m_dCurrentBlastRadius(0.0),
-	m_dBlastRadius(script->GetDouble("Grenade_BlastRadius")),
+	m_dBlastRadius(script->Params().Grenade_BlastRadius),
 	detonate(false),
 	detonationStart(false)
 {
@@ -65,7 +65,7 @@ void Grenade::Update()
 			InflictDamageOnBotsWithinBlastRadius();
 			detonationStart = true;
 		}
-		m_dCurrentBlastRadius += script->GetDouble("Grenade_ExplosionDecayRate");
+		m_dCurrentBlastRadius += script->Params().Grenade_ExplosionDecayRate;
 
 		//when the rendered blast circle becomes equal in size to the blast radius
 		//the Grenade can be removed from the game
@@ -116,7 +116,7 @@ void Grenade::TestForImpact()
 		m_vPosition,
 		dist,
 		m_vImpactPoint,
-		m_pWorld->GetMap()->GetWalls()))
+		m_pWorld->GetMap()->GetWallTable()))
 	{
 		m_bImpacted = true;
 
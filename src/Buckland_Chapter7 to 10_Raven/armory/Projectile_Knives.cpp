@@ -20,11 +20,11 @@ Knifes::Knifes(Raven_Bot* shooter, Vector2D target) :
 		shooter->ID(),
 		shooter->Pos(),
 		shooter->Facing(),
-		script->GetInt("Knifes_Damage"),
-		script->GetDouble("Knifes_Scale"),
-		script->GetDouble("Knifes_MaxSpeed"),
-		script->GetDouble("Knifes_Mass"),
-		script->GetDouble("Knifes_MaxForce"))
+		script->Params().Knifes_Damage,
+		script->Params().Knifes_Scale,
+		script->Params().Knifes_MaxSpeed,
+		script->Params().Knifes_Mass,
+		script->Params().Knifes_MaxForce)
 {
 
 	assert(target != Vector2D());
@@ -77,7 +77,7 @@ void Knifes::Update()
 			m_vPosition,
 			dist,
 			m_vImpactPoint,
-			m_pWorld->GetMap()->GetWalls()))
+			m_pWorld->GetMap()->GetWallTable()))
 		{
 			m_bDead = true;
 			m_bImpacted = true;
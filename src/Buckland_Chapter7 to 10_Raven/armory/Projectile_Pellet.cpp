@@ -23,13 +23,13 @@ Pellet::Pellet(Raven_Bot* shooter, Vector2D target):
                          shooter->ID(),
                          shooter->Pos(),
                          shooter->Facing(),
-                         script->GetInt("Pellet_Damage"),
-                         script->GetDouble("Pellet_Scale"),
-                         script->GetDouble("Pellet_MaxSpeed"),
-                         script->GetDouble("Pellet_Mass"),
-                         script->GetDouble("Pellet_MaxForce")),
+                         script->Params().Pellet_Damage,
+                         script->Params().Pellet_Scale,
+                         script->Params().Pellet_MaxSpeed,
+                         script->Params().Pellet_Mass,
+                         script->Params().Pellet_MaxForce),
 
-        m_dTimeShotIsVisible(script->GetDouble("Pellet_Persistance"))
+        m_dTimeShotIsVisible(script->Params().Pellet_Persistance)
 {
   
 }
@@ -79,7 +79,7 @@ void Pellet::TestForImpact()
                                           m_vPosition,
                                           DistToClosestImpact,
                                           m_vImpactPoint,
-                                          m_pWorld->GetMap()->GetWalls());
+                                          m_pWorld->GetMap()->GetWallTable());
 
   //test to see if the ray between the current position of the shell and 
   //the start position intersects with any bots.
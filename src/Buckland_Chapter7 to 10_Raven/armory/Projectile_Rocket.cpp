@@ -20,14 +20,14 @@ Rocket::Rocket(Raven_Bot* shooter, Vector2D target):
                          shooter->ID(),
                          shooter->Pos(),
                          shooter->Facing(),
-                         script->GetInt("Rocket_Damage"),
-                         script->GetDouble("Rocket_Scale"),
-                         script->GetDouble("Rocket_MaxSpeed"),
-                         script->GetDouble("Rocket_Mass"),
-                         script->GetDouble("Rocket_MaxForce")),
+                         script->Params().Rocket_Damage,
+                         script->Params().Rocket_Scale,
+                         script->Params().Rocket_MaxSpeed,
+                         script->Params().Rocket_Mass,
+                         script->Params().Rocket_MaxForce),
 
        m_dCurrentBlastRadius(0.0),
-       m_dBlastRadius(script->GetDouble("Rocket_BlastRadius"))
+       m_dBlastRadius(script->Params().Rocket_BlastRadius)
 {
    assert (target != Vector2D());
 }
@@ -52,7 +52,7 @@ void Rocket::Update()
 
   else
   {
-    m_dCurrentBlastRadius += script->GetDouble("Rocket_ExplosionDecayRate");
+    m_dCurrentBlastRadius += script->Params().Rocket_ExplosionDecayRate;
 
     //when the rendered blast circle becomes equal in size to the blast radius
     //the rocket can be removed from the game
@@ -98,7 +98,7 @@ void Rocket::TestForImpact()
                                                  m_vPosition,
                                                  dist,
                                                  m_vImpactPoint,
-                                                 m_pWorld->GetMap()->GetWalls()))
+                                                 m_pWorld->GetMap()->GetWallTable()))
      {
         m_bImpacted = true;
       
@@ -22,13 +22,13 @@ Slug::Slug(Raven_Bot* shooter, Vector2D target):
                          shooter->ID(),
                          shooter->Pos(),
                          shooter->Facing(),
-                         script->GetInt("Slug_Damage"),
-                         script->GetDouble("Slug_Scale"),
-                         script->GetDouble("Slug_MaxSpeed"),
-                         script->GetDouble("Slug_Mass"),
-                         script->GetDouble("Slug_MaxForce")),
+                         script->Params().Slug_Damage,
+                         script->Params().Slug_Scale,
+                         script->Params().Slug_MaxSpeed,
+                         script->Params().Slug_Mass,
+                         script->Params().Slug_MaxForce),
 
-        m_dTimeShotIsVisible(script->GetDouble("Slug_Persistance"))
+        m_dTimeShotIsVisible(script->Params().Slug_Persistance)
 {
   
 }
@@ -78,7 +78,7 @@ void Slug::TestForImpact()
                                           m_vPosition,
                                           DistToClosestImpact,
                                           m_vImpactPoint,
-                                          m_pWorld->GetMap()->GetWalls());
+                                          m_pWorld->GetMap()->GetWallTable());
 
   //test to see if the ray between the current position of the slug and 
   //the start position intersects with any bots.
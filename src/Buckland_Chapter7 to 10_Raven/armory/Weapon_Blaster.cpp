@@ -12,11 +12,11 @@
 Blaster::Blaster(Raven_Bot*   owner):
 
                       Raven_Weapon(type_blaster,
-                                   script->GetInt("Blaster_DefaultRounds"),
-                                   script->GetInt("Blaster_MaxRoundsCarried"),
-                                   script->GetDouble("Blaster_FiringFreq"),
-                                   script->GetDouble("Blaster_IdealRange"),
-                                   script->GetDouble("Bolt_MaxSpeed"),
+                                   script->Params().Blaster_DefaultRounds,
+                                   script->Params().Blaster_MaxRoundsCarried,
+                                   script->Params().Blaster_FiringFreq,
+                                   script->Params().Blaster_IdealRange,
+                                   script->Params().Bolt_MaxSpeed,
                                    owner)
 {
   //setup the vertex buffer
@@ -49,9 +49,9 @@ inline void Blaster::ShootAt(Vector2D pos)
 
     UpdateTimeWeaponIsNextAvailable();
 
-    //add a trigger to the game so that the other bots can hear this shot
+    //add a sound event to the map so that the other bots can hear this shot
     //(provided they are within range)
-    m_pOwner->GetWorld()->GetMap()->AddSoundTrigger(m_pOwner, script->GetDouble("Blaster_SoundRange"));
+    m_pOwner->GetWorld()->GetMap()->AddSoundEvent(m_pOwner, script->Params().Blaster_SoundRange);
   }
 }
 
@@ -12,11 +12,11 @@
 GrenadeLauncher::GrenadeLauncher(Raven_Bot* owner) :
 
 	Raven_Weapon(type_grenade_launcher,
-		script->GetInt("GrenadeLauncher_DefaultRounds"),
-		script->GetInt("GrenadeLauncher_MaxRoundsCarried"),
-		script->GetDouble("GrenadeLauncher_FiringFreq"),
-		script->GetDouble("GrenadeLauncher_IdealRange"),
-		script->GetDouble("Grenade_MaxSpeed"),
+		script->Params().GrenadeLauncher_DefaultRounds,
+		script->Params().GrenadeLauncher_MaxRoundsCarried,
+		script->Params().GrenadeLauncher_FiringFreq,
+		script->Params().GrenadeLauncher_IdealRange,
+		script->Params().Grenade_MaxSpeed,
 		owner)
 {
 
@@ -54,9 +54,9 @@ inline void GrenadeLauncher::ShootAt(Vector2D pos)
 
 		m_iNumRoundsLeft--;
 
-		//add a trigger to the game so that the other bots can hear this shot
+		//add a sound event to the map so that the other bots can hear this shot
 		//(provided they are within range)
-		m_pOwner->GetWorld()->GetMap()->AddSoundTrigger(m_pOwner, script->GetDouble("GrenadeLauncher_SoundRange"));
+		m_pOwner->GetWorld()->GetMap()->AddSoundEvent(m_pOwner, script->Params().GrenadeLauncher_SoundRange);
 	}
 }
 
@@ -12,11 +12,11 @@
 Knife::Knife(Raven_Bot* owner) :
 
 	Raven_Weapon(type_knife,
-		script->GetInt("Knife_DefaultRounds"),
-		script->GetInt("Knife_MaxRoundsCarried"),
-		script->GetDouble("Knife_FiringFreq"),
-		script->GetDouble("Knife_IdealRange"),
-		script->GetDouble("Knifes_MaxSpeed"),
+		script->Params().Knife_DefaultRounds,
+		script->Params().Knife_MaxRoundsCarried,
+		script->Params().Knife_FiringFreq,
+		script->Params().Knife_IdealRange,
+		script->Params().Knifes_MaxSpeed,
 		owner)
 {
 
@@ -12,11 +12,11 @@
 RailGun::RailGun(Raven_Bot*   owner):
 
                       Raven_Weapon(type_rail_gun,
-                                   script->GetInt("RailGun_DefaultRounds"),
-                                   script->GetInt("RailGun_MaxRoundsCarried"),
-                                   script->GetDouble("RailGun_FiringFreq"),
-                                   script->GetDouble("RailGun_IdealRange"),
-                                   script->GetDouble("Slug_MaxSpeed"),
+                                   script->Params().RailGun_DefaultRounds,
+                                   script->Params().RailGun_MaxRoundsCarried,
+                                   script->Params().RailGun_FiringFreq,
+                                   script->Params().RailGun_IdealRange,
+                                   script->Params().Slug_MaxSpeed,
                                    owner)
 {
 
@@ -53,9 +53,9 @@ inline void RailGun::ShootAt(Vector2D pos)
 
     m_iNumRoundsLeft--;
 
-    //add a trigger to the game so that the other bots can hear this shot
+    //add a sound event to the map so that the other bots can hear this shot
     //(provided they are within range)
-    m_pOwner->GetWorld()->GetMap()->AddSoundTrigger(m_pOwner, script->GetDouble("RailGun_SoundRange"));
+    m_pOwner->GetWorld()->GetMap()->AddSoundEvent(m_pOwner, script->Params().RailGun_SoundRange);
   }
 }
 
@@ -12,11 +12,11 @@
 RocketLauncher::RocketLauncher(Raven_Bot*   owner):
 
                       Raven_Weapon(type_rocket_launcher,
-                                   script->GetInt("RocketLauncher_DefaultRounds"),
-                                   script->GetInt("RocketLauncher_MaxRoundsCarried"),
-                                   script->GetDouble("RocketLauncher_FiringFreq"),
-                                   script->GetDouble("RocketLauncher_IdealRange"),
-                                   script->GetDouble("Rocket_MaxSpeed"),
+                                   script->Params().RocketLauncher_DefaultRounds,
+                                   script->Params().RocketLauncher_MaxRoundsCarried,
+                                   script->Params().RocketLauncher_FiringFreq,
+                                   script->Params().RocketLauncher_IdealRange,
+                                   script->Params().Rocket_MaxSpeed,
                                    owner)
 {
     //setup the vertex buffer
@@ -54,9 +54,9 @@ inline void RocketLauncher::ShootAt(Vector2D pos)
 
     UpdateTimeWeaponIsNextAvailable();
 
-    //add a trigger to the game so that the other bots can hear this shot
+    //add a sound event to the map so that the other bots can hear this shot
     //(provided they are within range)
-    m_pOwner->GetWorld()->GetMap()->AddSoundTrigger(m_pOwner, script->GetDouble("RocketLauncher_SoundRange"));
+    m_pOwner->GetWorld()->GetMap()->AddSoundEvent(m_pOwner, script->Params().RocketLauncher_SoundRange);
   }
 }
 
@@ -13,15 +13,15 @@
 ShotGun::ShotGun(Raven_Bot*   owner):
 
                       Raven_Weapon(type_shotgun,
-                                   script->GetInt("ShotGun_DefaultRounds"),
-                                   script->GetInt("ShotGun_MaxRoundsCarried"),
-                                   script->GetDouble("ShotGun_FiringFreq"),
-                                   script->GetDouble("ShotGun_IdealRange"),
-                                   script->GetDouble("Pellet_MaxSpeed"),
+                                   script->Params().ShotGun_DefaultRounds,
+                                   script->Params().ShotGun_MaxRoundsCarried,
+                                   script->Params().ShotGun_FiringFreq,
+                                   script->Params().ShotGun_IdealRange,
+                                   script->Params().Pellet_MaxSpeed,
                                    owner),
 
-            m_iNumBallsInShell(script->GetInt("ShotGun_NumBallsInShell")),
-            m_dSpread(script->GetDouble("ShotGun_Spread"))
+            m_iNumBallsInShell(script->Params().ShotGun_NumBallsInShell),
+            m_dSpread(script->Params().ShotGun_Spread)
 {
 
     //setup the vertex buffer
@@ -75,9 +75,9 @@ inline void ShotGun::ShootAt(Vector2D pos)
 
     UpdateTimeWeaponIsNextAvailable();
 
-    //add a trigger to the game so that the other bots can hear this shot
+    //add a sound event to the map so that the other bots can hear this shot
     //(provided they are within range)
-    m_pOwner->GetWorld()->GetMap()->AddSoundTrigger(m_pOwner, script->GetDouble("ShotGun_SoundRange"));
+    m_pOwner->GetWorld()->GetMap()->AddSoundEvent(m_pOwner, script->Params().ShotGun_SoundRange);
   }
 }
 
@@ -30,7 +30,10 @@ void Goal_Explore::Activate()
   }
 
   //and request a path to that position
-  m_pOwner->GetPathPlanner()->RequestPathToPosition(m_CurrentDestination);
+  m_pOwner->GetPathPlanner()->RequestPathToPosition(m_CurrentDestination,
+                                                    Raven_PathPlanner::priority_explore);
+
+  m_iPathID = m_pOwner->GetPathPlanner()->GetPathID();
 
   //the bot may have to wait a few update cycles before a path is calculated
   //so for appearances sake it simple ARRIVES at the destination until a path
@@ -52,6 +55,16 @@ int Goal_Explore::Process()
 }
 
 
+//------------------------------ Terminate ------------------------------------
+//
+//  the search for the path is stopped if it's still running (or, if it's
+//  incremental, still being repaired)
+//-----------------------------------------------------------------------------
+void Goal_Explore::Terminate()
+{
+  m_pOwner->GetPathPlanner()->AbandonPath(m_iPathID);
+}
+
 //---------------------------- HandleMessage ----------------------------------
 //-----------------------------------------------------------------------------
 bool Goal_Explore::HandleMessage(const Telegram& msg)
@@ -18,11 +18,15 @@ private:
   //set to true when the destination for the exploration has been established
   bool      m_bDestinationIsSet;
 
+  //the ID of the path request made by this goal
+  int       m_iPathID;
+
 public:
 
   Goal_Explore(Raven_Bot* pOwner):Goal_Composite<Raven_Bot>(pOwner,
                                                             goal_explore),
-                                  m_bDestinationIsSet(false)
+                                  m_bDestinationIsSet(false),
+                                  m_iPathID(-1)
   {}
 
 
@@ -30,7 +34,7 @@ public:
 
   int Process();
 
-  void Terminate(){}
+  void Terminate();
 
   bool HandleMessage(const Telegram& msg);
 };
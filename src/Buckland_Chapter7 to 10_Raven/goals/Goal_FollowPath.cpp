@@ -13,7 +13,8 @@
 Goal_FollowPath::
 Goal_FollowPath(Raven_Bot*          pBot,
                 std::list<PathEdge> path):Goal_Composite<Raven_Bot>(pBot, goal_follow_path),
-                                                  m_Path(path)
+                                                  m_Path(path),
+                                                  m_iPathID(pBot->GetPathPlanner()->GetPathID())
 {
 }
 
@@ -23,6 +24,14 @@ Goal_FollowPath(Raven_Bot*          pBot,
 void Goal_FollowPath::Activate()
 {
   m_iStatus = active;
+
+  //fetch the next piece of the path (if there is one) before the last edge
+  //is taken, so that edge isn't treated as the end of the path. If the rest
+  //of the path can't be found the path is abandoned
+  if (m_Path.size() < 2 && !m_pOwner->GetPathPlanner()->ExtendPath(m_Path, m_iPathID))
+  {
+    m_iStatus = failed; return;
+  }
   
   //get a reference to the next edge
   PathEdge edge = m_Path.front();
@@ -79,6 +88,8 @@ int Goal_FollowPath::Process()
   //if status is inactive, call Activate()
   ActivateIfInactive();
 
+  if (hasFailed()) return m_iStatus;
+
   m_iStatus = ProcessSubgoals();
 
   //if there are no subgoals present check to see if the path still has edges.
@@ -24,6 +24,11 @@ private:
   //a local copy of the path returned by the path planner
   std::list<PathEdge>  m_Path;
 
+  //the ID of the search the path came from. A hierarchical search hands out
+  //its path a piece at a time, and this is used to ask the planner for the
+  //next piece (see Raven_PathPlanner::ExtendPath)
+  int                  m_iPathID;
+
 public:
 
   Goal_FollowPath(Raven_Bot* pBot, std::list<PathEdge> path);
@@ -26,12 +26,26 @@ void Goal_MoveToPosition::Activate()
   //before a path is calculated. Consequently, for appearances sake, it just
   //seeks directly to the target position whilst it's awaiting notification
   //that the path planning request has succeeded/failed
-  if (m_pOwner->GetPathPlanner()->RequestPathToPosition(m_vDestination))
+  bool bRequested = m_pOwner->GetPathPlanner()->RequestPathToPosition(m_vDestination);
+
+  m_iPathID = m_pOwner->GetPathPlanner()->GetPathID();
+
+  if (bRequested)
   {
     AddSubgoal(new Goal_SeekToPosition(m_pOwner, m_vDestination));
   }
 }
 
+//------------------------------ Terminate ------------------------------------
+//
+//  the search for the path is stopped if it's still running (or, if it's
+//  incremental, still being repaired)
+//-----------------------------------------------------------------------------
+void Goal_MoveToPosition::Terminate()
+{
+  m_pOwner->GetPathPlanner()->AbandonPath(m_iPathID);
+}
+
 //------------------------------ Process --------------------------------------
 //-----------------------------------------------------------------------------
 int Goal_MoveToPosition::Process()
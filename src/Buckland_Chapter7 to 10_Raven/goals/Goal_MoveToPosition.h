@@ -16,6 +16,9 @@ private:
   //the position the bot wants to reach
   Vector2D m_vDestination;
 
+  //the ID of the path request made by this goal
+  int      m_iPathID;
+
 public:
 
   Goal_MoveToPosition(Raven_Bot* pBot,
@@ -23,13 +26,14 @@ public:
   
             Goal_Composite<Raven_Bot>(pBot,
                                       goal_move_to_position),
-            m_vDestination(pos)
+            m_vDestination(pos),
+            m_iPathID(-1)
   {}
 
  //the usual suspects
   void Activate();
   int  Process();
-  void Terminate(){}
+  void Terminate();
 
   //this goal is able to accept messages
   bool HandleMessage(const Telegram& msg);
@@ -15,7 +15,7 @@
 void Goal_RushTarget::Activate()
 {
 	//return max speed back to normal
-	m_pOwner->SetMaxRushSpeed(script->GetDouble("Bot_MaxRushSpeed"));
+	m_pOwner->SetMaxRushSpeed(script->Params().Bot_MaxRushSpeed);
 
 	m_iStatus = active;
 
@@ -49,7 +49,7 @@ void Goal_RushTarget::Activate()
 	else
 	{
 		//return max speed back to normal
-		m_pOwner->SetMaxSpeed(script->GetDouble("Bot_MaxSpeed"));
+		m_pOwner->SetMaxSpeed(script->Params().Bot_MaxSpeed);
 
 		m_iStatus = completed;
 	}
@@ -40,14 +40,14 @@ void Goal_TraverseEdge::Activate()
   {
     case NavGraphEdge::swim:
     {
-      m_pOwner->SetMaxSpeed(script->GetDouble("Bot_MaxSwimmingSpeed"));
+      m_pOwner->SetMaxSpeed(script->Params().Bot_MaxSwimmingSpeed);
     }
    
     break;
    
     case NavGraphEdge::crawl:
     {
-       m_pOwner->SetMaxSpeed(script->GetDouble("Bot_MaxCrawlingSpeed"));
+       m_pOwner->SetMaxSpeed(script->Params().Bot_MaxCrawlingSpeed);
     }
    
     break;
@@ -139,7 +139,7 @@ void Goal_TraverseEdge::Terminate()
   m_pOwner->GetSteering()->ArriveOff();
 
   //return max speed back to normal
-  m_pOwner->SetMaxSpeed(script->GetDouble("Bot_MaxSpeed"));
+  m_pOwner->SetMaxSpeed(script->Params().Bot_MaxSpeed);
 }
 
 //----------------------------- Render ----------------------------------------
@@ -38,23 +38,23 @@ double GetMaxRoundsBotCanCarryForWeapon(int WeaponType)
   {
   case type_rail_gun:
 
-    return script->GetDouble("RailGun_MaxRoundsCarried");
+    return script->Params().RailGun_MaxRoundsCarried;
 
   case type_rocket_launcher:
 
-    return script->GetDouble("RocketLauncher_MaxRoundsCarried");
+    return script->Params().RocketLauncher_MaxRoundsCarried;
 
   case type_shotgun:
 
-    return script->GetDouble("ShotGun_MaxRoundsCarried");
+    return script->Params().ShotGun_MaxRoundsCarried;
   
   case type_grenade_launcher:
 
-	  return script->GetDouble("GrenadeLauncher_MaxRoundsCarried");
+	  return script->Params().GrenadeLauncher_MaxRoundsCarried;
 
   case type_knife:
 
-	  return script->GetDouble("Knife_MaxRoundsCarried");
+	  return script->Params().Knife_MaxRoundsCarried;
 
   default:
 
@@ -0,0 +1,140 @@
+//-----------------------------------------------------------------------------
+//
+//  Name:   Raven_ParamList.h
+//
+//  Desc:   the parameters Raven reads from Params.ini. Each entry becomes a
+//          typed field of Raven_Params (see Raven_Scriptor.h) which is
+//          filled once when the file is loaded.
+//
+//          This file is included with RAVEN_PARAM(type, name) defined by
+//          the includer, so it has no include guard.
+//
+//-----------------------------------------------------------------------------
+
+//General game parameters
+RAVEN_PARAM(int,         NumBots)
+RAVEN_PARAM(int,         MaxSearchCyclesPerUpdateStep)
+RAVEN_PARAM(double,      SearchBudgetMicroseconds)
+RAVEN_PARAM(int,         SearchCyclesPerSlice)
+RAVEN_PARAM(double,      SearchPriorityAgingRate)
+RAVEN_PARAM(int,         PathWorkerThreads)
+RAVEN_PARAM(std::string, StartMap)
+RAVEN_PARAM(int,         NumCellsX)
+RAVEN_PARAM(int,         NumCellsY)
+RAVEN_PARAM(double,      GraveLifetime)
+RAVEN_PARAM(int,         PathCostStorage)
+RAVEN_PARAM(int,         PathCostSinglePrecision)
+RAVEN_PARAM(int,         PathCostCacheKB)
+RAVEN_PARAM(int,         HPAMinNodes)
+RAVEN_PARAM(double,      HPAClusterSize)
+RAVEN_PARAM(int,         PathCacheSize)
+RAVEN_PARAM(int,         NumLandmarks)
+RAVEN_PARAM(int,         NextHopTableMaxNodes)
+RAVEN_PARAM(double,      ClosedDoorCost)
+RAVEN_PARAM(int,         FlowFieldCacheSize)
+RAVEN_PARAM(int,         FlowFieldMinRequests)
+
+//bot parameters
+RAVEN_PARAM(int,         Bot_MaxHealth)
+RAVEN_PARAM(double,      Bot_MaxSpeed)
+RAVEN_PARAM(double,      Bot_Mass)
+RAVEN_PARAM(double,      Bot_MaxForce)
+RAVEN_PARAM(double,      Bot_MaxHeadTurnRate)
+RAVEN_PARAM(double,      Bot_Scale)
+RAVEN_PARAM(double,      Bot_MaxSwimmingSpeed)
+RAVEN_PARAM(double,      Bot_MaxCrawlingSpeed)
+RAVEN_PARAM(double,      Bot_MaxRushSpeed)
+RAVEN_PARAM(double,      Bot_WeaponSelectionFrequency)
+RAVEN_PARAM(double,      Bot_GoalAppraisalUpdateFreq)
+RAVEN_PARAM(double,      Bot_TargetingUpdateFreq)
+RAVEN_PARAM(double,      Bot_TriggerUpdateFreq)
+RAVEN_PARAM(double,      Bot_VisionUpdateFreq)
+RAVEN_PARAM(double,      Bot_FOV)
+RAVEN_PARAM(double,      Bot_ReactionTime)
+RAVEN_PARAM(double,      Bot_AimPersistance)
+RAVEN_PARAM(double,      Bot_AimAccuracy)
+RAVEN_PARAM(double,      HitFlashTime)
+RAVEN_PARAM(double,      Bot_MemorySpan)
+
+//steering parameters
+RAVEN_PARAM(double,      SeparationWeight)
+RAVEN_PARAM(double,      WallAvoidanceWeight)
+RAVEN_PARAM(double,      WanderWeight)
+RAVEN_PARAM(double,      SeekWeight)
+RAVEN_PARAM(double,      ArriveWeight)
+RAVEN_PARAM(double,      ViewDistance)
+RAVEN_PARAM(double,      WallDetectionFeelerLength)
+
+//giver-trigger parameters
+RAVEN_PARAM(double,      DefaultGiverTriggerRange)
+RAVEN_PARAM(double,      Health_RespawnDelay)
+RAVEN_PARAM(double,      Weapon_RespawnDelay)
+
+//weapon parameters
+RAVEN_PARAM(double,      Blaster_FiringFreq)
+RAVEN_PARAM(int,         Blaster_DefaultRounds)
+RAVEN_PARAM(int,         Blaster_MaxRoundsCarried)
+RAVEN_PARAM(double,      Blaster_IdealRange)
+RAVEN_PARAM(double,      Blaster_SoundRange)
+RAVEN_PARAM(double,      Bolt_MaxSpeed)
+RAVEN_PARAM(double,      Bolt_Mass)
+RAVEN_PARAM(double,      Bolt_MaxForce)
+RAVEN_PARAM(double,      Bolt_Scale)
+RAVEN_PARAM(int,         Bolt_Damage)
+RAVEN_PARAM(double,      RocketLauncher_FiringFreq)
+RAVEN_PARAM(int,         RocketLauncher_DefaultRounds)
+RAVEN_PARAM(int,         RocketLauncher_MaxRoundsCarried)
+RAVEN_PARAM(double,      RocketLauncher_IdealRange)
+RAVEN_PARAM(double,      RocketLauncher_SoundRange)
+RAVEN_PARAM(double,      Rocket_BlastRadius)
+RAVEN_PARAM(double,      Rocket_MaxSpeed)
+RAVEN_PARAM(double,      Rocket_Mass)
+RAVEN_PARAM(double,      Rocket_MaxForce)
+RAVEN_PARAM(double,      Rocket_Scale)
+RAVEN_PARAM(int,         Rocket_Damage)
+RAVEN_PARAM(double,      Rocket_ExplosionDecayRate)
+RAVEN_PARAM(double,      RailGun_FiringFreq)
+RAVEN_PARAM(int,         RailGun_DefaultRounds)
+RAVEN_PARAM(int,         RailGun_MaxRoundsCarried)
+RAVEN_PARAM(double,      RailGun_IdealRange)
+RAVEN_PARAM(double,      RailGun_SoundRange)
+RAVEN_PARAM(double,      Slug_MaxSpeed)
+RAVEN_PARAM(double,      Slug_Mass)
+RAVEN_PARAM(double,      Slug_MaxForce)
+RAVEN_PARAM(double,      Slug_Scale)
+RAVEN_PARAM(double,      Slug_Persistance)
+RAVEN_PARAM(int,         Slug_Damage)
+RAVEN_PARAM(double,      ShotGun_FiringFreq)
+RAVEN_PARAM(int,         ShotGun_DefaultRounds)
+RAVEN_PARAM(int,         ShotGun_MaxRoundsCarried)
+RAVEN_PARAM(int,         ShotGun_NumBallsInShell)
+RAVEN_PARAM(double,      ShotGun_Spread)
+RAVEN_PARAM(double,      ShotGun_IdealRange)
+RAVEN_PARAM(double,      ShotGun_SoundRange)
+RAVEN_PARAM(double,      Pellet_MaxSpeed)
+RAVEN_PARAM(double,      Pellet_Mass)
+RAVEN_PARAM(double,      Pellet_MaxForce)
+RAVEN_PARAM(double,      Pellet_Scale)
+RAVEN_PARAM(double,      Pellet_Persistance)
+RAVEN_PARAM(int,         Pellet_Damage)
+RAVEN_PARAM(double,      Knife_FiringFreq)
+RAVEN_PARAM(int,         Knife_DefaultRounds)
+RAVEN_PARAM(int,         Knife_MaxRoundsCarried)
+RAVEN_PARAM(double,      Knife_IdealRange)
+RAVEN_PARAM(double,      Knifes_MaxSpeed)
+RAVEN_PARAM(int,         Knifes_Damage)
+RAVEN_PARAM(double,      Knifes_Mass)
+RAVEN_PARAM(double,      Knifes_MaxForce)
+RAVEN_PARAM(double,      Knifes_Scale)
+RAVEN_PARAM(double,      GrenadeLauncher_FiringFreq)
+RAVEN_PARAM(int,         GrenadeLauncher_DefaultRounds)
+RAVEN_PARAM(int,         GrenadeLauncher_MaxRoundsCarried)
+RAVEN_PARAM(double,      GrenadeLauncher_IdealRange)
+RAVEN_PARAM(double,      GrenadeLauncher_SoundRange)
+RAVEN_PARAM(double,      Grenade_BlastRadius)
+RAVEN_PARAM(double,      Grenade_MaxSpeed)
+RAVEN_PARAM(double,      Grenade_Mass)
+RAVEN_PARAM(double,      Grenade_MaxForce)
+RAVEN_PARAM(double,      Grenade_Scale)
+RAVEN_PARAM(int,         Grenade_Damage)
+RAVEN_PARAM(double,      Grenade_ExplosionDecayRate)
@@ -1,5 +1,7 @@
 #include "Raven_Scriptor.h"
 
+#include <windows.h>
+
 Raven_Scriptor* Raven_Scriptor::Instance()
 {
   static Raven_Scriptor instance;
@@ -9,4 +11,150 @@ Raven_Scriptor* Raven_Scriptor::Instance()
 
 
 
-Raven_Scriptor::Raven_Scriptor(): Scriptor("Params.ini") {}
\ No newline at end of file
+Raven_Scriptor::Raven_Scriptor(): Scriptor("Params.ini"),
+                                  m_sFileName("Params.ini"),
+                                  m_bPending(false),
+                                  m_bStopWatching(false)
+{
+  Raven_Params* params = new Raven_Params;
+
+  m_pParams.reset(params);
+
+  CompileParams(*this, *params);
+}
+
+Raven_Scriptor::~Raven_Scriptor()
+{
+  StopWatching();
+}
+
+//------------------------------ Handle ---------------------------------------
+//-----------------------------------------------------------------------------
+int Raven_Scriptor::Handle(const Scriptor& source, const char* name)
+{
+  int h = source.GetHandle(name);
+
+  if (h < 0)
+  {
+    throw std::runtime_error(std::string("Params.ini is missing parameter: ") + name);
+  }
+
+  return h;
+}
+
+//--------------------------- CompileParams -----------------------------------
+//-----------------------------------------------------------------------------
+void Raven_Scriptor::CompileParams(const Scriptor& source, Raven_Params& params)
+{
+#define RAVEN_PARAM(type, name) Read(source, #name, params.name);
+#include "lua/Raven_ParamList.h"
+#undef RAVEN_PARAM
+}
+
+//---------------------------- ReloadParams -----------------------------------
+//-----------------------------------------------------------------------------
+void Raven_Scriptor::ReloadParams()
+{
+  try
+  {
+    Scriptor source(m_sFileName);
+
+    Raven_Params* params = new Raven_Params;
+    ParamsPtr snapshot(params);
+
+    CompileParams(source, *params);
+
+    std::lock_guard<std::mutex> lock(m_PendingMutex);
+
+    m_pPending = snapshot;
+    m_bPending = true;
+  }
+  catch (const std::exception&)
+  {
+    //keep the current parameters. The file will be looked at again when
+    //it next changes
+  }
+}
+
+//---------------------------- UpdateParams -----------------------------------
+//-----------------------------------------------------------------------------
+bool Raven_Scriptor::UpdateParams()
+{
+  if (!m_bPending) return false;
+
+  std::lock_guard<std::mutex> lock(m_PendingMutex);
+
+  m_pParams = m_pPending;
+  m_pPending.reset();
+  m_bPending = false;
+
+  return true;
+}
+
+//-------------------------- WatchParamsFile ----------------------------------
+//
+//  waits on a change notification for the directory holding the file and
+//  reloads it whenever its last write time changes. The wait times out
+//  regularly so that the thread notices when it is asked to stop
+//-----------------------------------------------------------------------------
+static bool GetLastWriteTime(const std::string& FileName, FILETIME& time)
+{
+  WIN32_FILE_ATTRIBUTE_DATA data;
+
+  if (!GetFileAttributesExA(FileName.c_str(), GetFileExInfoStandard, &data)) return false;
+
+  time = data.ftLastWriteTime;
+
+  return true;
+}
+
+void Raven_Scriptor::WatchParamsFile()
+{
+  HANDLE hChange = FindFirstChangeNotificationA(".", FALSE, FILE_NOTIFY_CHANGE_LAST_WRITE);
+
+  if (hChange == INVALID_HANDLE_VALUE) return;
+
+  FILETIME LastWrite = {0, 0};
+  GetLastWriteTime(m_sFileName, LastWrite);
+
+  while (!m_bStopWatching)
+  {
+    if (WaitForSingleObject(hChange, 250) != WAIT_OBJECT_0) continue;
+
+    FILETIME time;
+
+    if (GetLastWriteTime(m_sFileName, time) && CompareFileTime(&time, &LastWrite) != 0)
+    {
+      LastWrite = time;
+
+      //give the editor a moment to finish writing
+      Sleep(50);
+
+      ReloadParams();
+    }
+
+    if (!FindNextChangeNotification(hChange)) break;
+  }
+
+  FindCloseChangeNotification(hChange);
+}
+
+//------------------------- Start/StopWatching --------------------------------
+//-----------------------------------------------------------------------------
+void Raven_Scriptor::StartWatching()
+{
+  if (m_Watcher.joinable()) return;
+
+  m_bStopWatching = false;
+
+  m_Watcher = std::thread(&Raven_Scriptor::WatchParamsFile, this);
+}
+
+void Raven_Scriptor::StopWatching()
+{
+  if (!m_Watcher.joinable()) return;
+
+  m_bStopWatching = true;
+
+  m_Watcher.join();
+}
@@ -1,12 +1,72 @@
 #pragma once
 
+#include <string>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <thread>
+
 #include "Script/scriptor.h"
 
 #define script Raven_Scriptor::Instance()
 
+
+//the parameters listed in Raven_ParamList.h, parsed into their types. Reading
+//one is a plain member access
+struct Raven_Params
+{
+#define RAVEN_PARAM(type, name) type name;
+#include "lua/Raven_ParamList.h"
+#undef RAVEN_PARAM
+};
+
+
+//Params() returns the current immutable snapshot of the parameters. While
+//watching is switched on, a background thread reparses Params.ini whenever it
+//is saved and publishes a new snapshot, which replaces the current one the
+//next time UpdateParams is called (once per update-step, by Raven_Game).
+//Raven_Game then hands the new values to the bots already in the game (see
+//Raven_Bot::ApplyParams). Other values read into objects when they are
+//created, such as a weapon's rate of fire, apply to those made afterwards.
 class Raven_Scriptor : public Scriptor
 {
+public:
+
+  typedef std::shared_ptr<const Raven_Params> ParamsPtr;
+
 private:
+
+  std::string       m_sFileName;
+
+  //the snapshot handed out by Params
+  ParamsPtr         m_pParams;
+
+  //a freshly reloaded snapshot waiting to be picked up by UpdateParams
+  ParamsPtr         m_pPending;
+  std::mutex        m_PendingMutex;
+  std::atomic<bool> m_bPending;
+
+  //the file watching thread
+  std::thread       m_Watcher;
+  std::atomic<bool> m_bStopWatching;
+
+  //copies the value of every parameter in Raven_ParamList.h from source
+  //into params. Throws if any of them is missing
+  static void CompileParams(const Scriptor& source, Raven_Params& params);
+
+  static int  Handle(const Scriptor& source, const char* name);
+
+  static void Read(const Scriptor& s, const char* name, int& val){val = s.GetInt(Handle(s, name));}
+  static void Read(const Scriptor& s, const char* name, double& val){val = s.GetDouble(Handle(s, name));}
+  static void Read(const Scriptor& s, const char* name, std::string& val){val = s.GetString(Handle(s, name));}
+
+  //parses the file into a new snapshot and marks it as pending. A file that
+  //can't be read or is missing parameters (it may be only partly written)
+  //is ignored
+  void ReloadParams();
+
+  //the body of the watching thread
+  void WatchParamsFile();
   
   Raven_Scriptor();
 
@@ -16,6 +76,26 @@ private:
 
 public:
 
+  ~Raven_Scriptor();
+
   static Raven_Scriptor* Instance();
 
+  //use this in preference to the string lookups inherited from Scriptor
+  //(those always reflect the file as it was at startup). The snapshot is
+  //only replaced by UpdateParams, between update-steps, so the reference
+  //is good for the rest of the step. Game thread only
+  const Raven_Params& Params()const{return *m_pParams;}
+
+  //the snapshot itself, for anything that must keep the parameters it was
+  //given past a reload. A replaced snapshot is freed once nothing points
+  //to it
+  ParamsPtr           Snapshot()const{return m_pParams;}
+
+  //installs any snapshot published by the watching thread. Returns true if
+  //the parameters changed. Only call this between update-steps
+  bool UpdateParams();
+
+  //starts/stops the thread watching Params.ini for changes
+  void StartWatching();
+  void StopWatching();
 };
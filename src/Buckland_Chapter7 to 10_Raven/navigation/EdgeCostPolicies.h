@@ -0,0 +1,63 @@
+#ifndef EDGE_COST_POLICIES_H
+#define EDGE_COST_POLICIES_H
+#pragma warning (disable:4786)
+//-----------------------------------------------------------------------------
+//
+//  Name:   EdgeCostPolicies.h
+//
+//  Desc:   class templates to define the cost a search gives a graph edge
+//          (see Graph_SearchDStarLite_TS)
+//-----------------------------------------------------------------------------
+#include <vector>
+
+
+//----------------------------- EdgeCost_Fixed --------------------------------
+
+//the cost stored in the edge
+class EdgeCost_Fixed
+{
+public:
+
+  template <class edge_type>
+  static double Cost(const edge_type& edge)
+  {
+    return edge.Cost();
+  }
+};
+
+//----------------------------- EdgeCost_Doors --------------------------------
+
+//the cost stored in the edge plus, if the edge goes through a door, that
+//door's entry in the door cost table (indexed by door ID). The table is set
+//by the map and changes as the doors open and shut
+template <class edge_type>
+class EdgeCost_Doors
+{
+private:
+
+  static const std::vector<double>* s_pDoorCosts;
+
+public:
+
+  static void SetDoorCosts(const std::vector<double>* pDoorCosts){s_pDoorCosts = pDoorCosts;}
+
+  static double Cost(const edge_type& edge)
+  {
+    double cost = edge.Cost();
+
+    if (s_pDoorCosts && (edge.Flags() & edge_type::goes_through_door))
+    {
+      unsigned int door = (unsigned int)edge.IDofIntersectingEntity();
+
+      if (door < s_pDoorCosts->size()) cost += (*s_pDoorCosts)[door];
+    }
+
+    return cost;
+  }
+};
+
+template <class edge_type>
+const std::vector<double>* EdgeCost_Doors<edge_type>::s_pDoorCosts = NULL;
+
+
+#endif
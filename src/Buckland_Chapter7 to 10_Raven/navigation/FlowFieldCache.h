@@ -0,0 +1,429 @@
+#ifndef FLOW_FIELD_CACHE_H
+#define FLOW_FIELD_CACHE_H
+#pragma warning (disable:4786)
+//-----------------------------------------------------------------------------
+//
+//  Name:   FlowFieldCache.h
+//
+//  Desc:   flow fields for the navgraph nodes many bots are heading for,
+//          shared by all the bots' path planners.
+//
+//          A flow field is a DistanceField with a single source, the
+//          destination, so it gives the first edge of the shortest path to
+//          the destination from every node. It costs one search of the
+//          whole graph to make, after which the path from any node is read
+//          straight off it. That's only worth it for a destination several
+//          bots want, so a field is made once its destination has been
+//          asked for by MinRequests different bots.
+//
+//          The field is made by a Graph_FlowFieldSearch_TS, which the bot
+//          whose request tipped the count over hands to the path manager
+//          like any other search, so it's made within the manager's time
+//          budget (or by one of its worker threads). The cache holds the
+//          field once that search hands it over.
+//
+//          The least recently used field is dropped when the cache is full.
+//-----------------------------------------------------------------------------
+#include <list>
+#include <map>
+#include <set>
+#include <vector>
+#include <algorithm>
+#include <cassert>
+
+#include "Graph/DistanceField.h"
+#include "TimeSlicedGraphAlgorithms.h"
+
+
+template <class graph_type> class Graph_FlowFieldSearch_TS;
+
+
+template <class graph_type>
+class FlowFieldCache
+{
+public:
+
+  typedef DistanceField<graph_type>             FlowField;
+  typedef Graph_FlowFieldSearch_TS<graph_type>  FieldSearch;
+
+private:
+
+  struct Entry
+  {
+    int        iTarget;
+    FlowField  Field;
+  };
+
+  typedef std::list<Entry>                                  FieldList;
+  typedef std::map<int, typename FieldList::iterator>       FieldIndex;
+
+  //a destination without a field, and the requesters that have asked for it
+  struct RequestCount
+  {
+    int               iTarget;
+    std::vector<int>  Requesters;
+  };
+
+  const graph_type*  m_pGraph;
+
+  //the fields, most recently used first
+  FieldList          m_Fields;
+
+  //the fields by destination
+  FieldIndex         m_Index;
+
+  //the destinations recently asked for that don't have a field yet, most
+  //recent first
+  std::list<RequestCount>  m_Requests;
+
+  //the destinations whose fields are being made
+  std::set<int>      m_Building;
+
+  //changed whenever the cache is cleared, so a field that was being made
+  //for an earlier graph isn't taken
+  int                m_iGeneration;
+
+  unsigned int       m_iCapacity;
+  int                m_iMinRequests;
+
+  int                m_iNumBuilt;
+  int                m_iNumHits;
+
+  //notes a request for target by requester and returns how many different
+  //requesters have asked for it
+  int  CountRequest(int target, int requester);
+
+public:
+
+  FlowFieldCache():m_pGraph(NULL),
+                   m_iGeneration(0),
+                   m_iCapacity(0),
+                   m_iMinRequests(1),
+                   m_iNumBuilt(0),
+                   m_iNumHits(0)
+  {}
+
+  //the fields are made for G, which must outlive them (or the next call to
+  //SetGraph or Clear). A capacity of zero disables the cache
+  void  SetGraph(const graph_type* G, unsigned int capacity, int MinRequests);
+
+  void  Clear();
+
+  //returns the field leading to target if there is one, otherwise NULL.
+  //If target has now been asked for by enough different requesters (each
+  //identified by an ID, such as its bot's) and its field isn't already
+  //being made, bBuild is set to true and the caller should make the field
+  //by running the search given by NewFieldSearch. The pointer is only valid
+  //until the cache is next changed
+  const FlowField* Request(int target, int requester, bool& bBuild);
+
+  //a search that makes the field leading to target, and is also the search
+  //for the path there from source
+  FieldSearch*     NewFieldSearch(int source, int target);
+
+  //called by a FieldSearch when its field is complete, or when it is
+  //deleted before then
+  void  BuildFinished(int target, int generation, FlowField& field);
+  void  BuildAbandoned(int target, int generation);
+
+  int          Generation()const{return m_iGeneration;}
+
+  unsigned int Size()const{return m_Fields.size();}
+  int          NumBuilding()const{return m_Building.size();}
+  int          NumBuilt()const{return m_iNumBuilt;}
+  int          NumHits()const{return m_iNumHits;}
+};
+
+
+//------------------------- Graph_FlowFieldSearch_TS --------------------------
+//
+//  makes the flow field leading to a target a node at a time. Its result
+//  is the path to the target from the source it was made with, which is
+//  read off the field when it's complete. Once the field has been handed
+//  to the cache the search still has that path to give out
+//-----------------------------------------------------------------------------
+template <class graph_type>
+class Graph_FlowFieldSearch_TS : public Graph_SearchTimeSliced<typename graph_type::EdgeType>
+{
+private:
+
+  typedef typename graph_type::EdgeType  Edge;
+
+  const graph_type&            m_Graph;
+
+  FlowFieldCache<graph_type>*  m_pCache;
+
+  //the cache's generation when the search was made
+  int                          m_iGeneration;
+
+  int                          m_iSource;
+  int                          m_iTarget;
+
+  DistanceField<graph_type>    m_Field;
+
+  bool                         m_bComplete;
+  bool                         m_bHandedOver;
+
+  //the path from the source and its cost, read off the field once it's
+  //complete
+  std::vector<const Edge*>     m_Path;
+  double                       m_dCost;
+
+public:
+
+  Graph_FlowFieldSearch_TS(const graph_type&           G,
+                           FlowFieldCache<graph_type>* pCache,
+                           int                         source,
+                           int                         target):Graph_SearchTimeSliced<Edge>(Graph_SearchTimeSliced<Edge>::AStar),
+                                                               m_Graph(G),
+                                                               m_pCache(pCache),
+                                                               m_iGeneration(pCache->Generation()),
+                                                               m_iSource(source),
+                                                               m_iTarget(target),
+                                                               m_bComplete(false),
+                                                               m_bHandedOver(false),
+                                                               m_dCost(MaxDouble)
+  {
+    m_Field.Build(G);
+    m_Field.QueueSource(target);
+  }
+
+  ~Graph_FlowFieldSearch_TS()
+  {
+    if (!m_bHandedOver) m_pCache->BuildAbandoned(m_iTarget, m_iGeneration);
+  }
+
+  int  CycleOnce()
+  {
+    if (!m_bComplete)
+    {
+      if (m_Field.PropagateOnce()) return search_incomplete;
+
+      m_bComplete = true;
+
+      m_dCost = m_Field.Cost(m_iSource);
+
+      for (const Edge* pE = m_Field.NextEdge(m_iSource); pE; pE = m_Field.NextEdge(pE->To()))
+      {
+        m_Path.push_back(pE);
+      }
+    }
+
+    return m_dCost < MaxDouble ? target_found : target_not_found;
+  }
+
+  //gives the complete field to the cache. This must be done on the thread
+  //that uses the cache
+  void HandOver()
+  {
+    if (!m_bComplete || m_bHandedOver) return;
+
+    m_bHandedOver = true;
+
+    m_pCache->BuildFinished(m_iTarget, m_iGeneration, m_Field);
+  }
+
+  std::vector<const Edge*> GetSPT()const{return m_Path;}
+
+  double                   GetCostToTarget()const{return m_dCost;}
+
+  std::list<int>           GetPathToTarget()const;
+
+  std::list<PathEdge>      GetPathAsPathEdges()const;
+};
+
+
+//------------------------------- SetGraph ------------------------------------
+//-----------------------------------------------------------------------------
+template <class graph_type>
+void FlowFieldCache<graph_type>::SetGraph(const graph_type* G,
+                                          unsigned int      capacity,
+                                          int               MinRequests)
+{
+  Clear();
+
+  m_pGraph       = G;
+  m_iCapacity    = capacity;
+  m_iMinRequests = MinRequests > 1 ? MinRequests : 1;
+}
+
+//--------------------------------- Clear -------------------------------------
+//-----------------------------------------------------------------------------
+template <class graph_type>
+void FlowFieldCache<graph_type>::Clear()
+{
+  m_pGraph = NULL;
+
+  m_Fields.clear();
+  m_Index.clear();
+  m_Requests.clear();
+  m_Building.clear();
+
+  ++m_iGeneration;
+}
+
+//----------------------------- CountRequest ----------------------------------
+//
+//  only a few times as many destinations as there are fields are counted.
+//  A destination that drops off the end hasn't been popular lately
+//-----------------------------------------------------------------------------
+template <class graph_type>
+int FlowFieldCache<graph_type>::CountRequest(int target, int requester)
+{
+  typename std::list<RequestCount>::iterator it = m_Requests.begin();
+
+  while (it != m_Requests.end() && it->iTarget != target) ++it;
+
+  if (it == m_Requests.end())
+  {
+    m_Requests.push_front(RequestCount());
+
+    m_Requests.front().iTarget = target;
+
+    if (m_Requests.size() > 4 * m_iCapacity)
+    {
+      m_Requests.pop_back();
+    }
+  }
+  else
+  {
+    m_Requests.splice(m_Requests.begin(), m_Requests, it);
+  }
+
+  std::vector<int>& requesters = m_Requests.front().Requesters;
+
+  if (std::find(requesters.begin(), requesters.end(), requester) == requesters.end())
+  {
+    requesters.push_back(requester);
+  }
+
+  return requesters.size();
+}
+
+//-------------------------------- Request ------------------------------------
+//-----------------------------------------------------------------------------
+template <class graph_type>
+const typename FlowFieldCache<graph_type>::FlowField*
+FlowFieldCache<graph_type>::Request(int target, int requester, bool& bBuild)
+{
+  bBuild = false;
+
+  if (!m_pGraph || m_iCapacity == 0) return NULL;
+
+  typename FieldIndex::iterator found = m_Index.find(target);
+
+  if (found != m_Index.end())
+  {
+    //make it the most recently used
+    m_Fields.splice(m_Fields.begin(), m_Fields, found->second);
+
+    ++m_iNumHits;
+
+    return &m_Fields.front().Field;
+  }
+
+  if (m_Building.count(target)) return NULL;
+
+  if (CountRequest(target, requester) < m_iMinRequests) return NULL;
+
+  //(the count is no longer needed)
+  m_Requests.pop_front();
+
+  m_Building.insert(target);
+
+  bBuild = true;
+
+  return NULL;
+}
+
+//---------------------------- NewFieldSearch ---------------------------------
+//-----------------------------------------------------------------------------
+template <class graph_type>
+typename FlowFieldCache<graph_type>::FieldSearch*
+FlowFieldCache<graph_type>::NewFieldSearch(int source, int target)
+{
+  assert (m_pGraph && "<FlowFieldCache::NewFieldSearch>: no graph");
+
+  return new FieldSearch(*m_pGraph, this, source, target);
+}
+
+//----------------------------- BuildFinished ---------------------------------
+//-----------------------------------------------------------------------------
+template <class graph_type>
+void FlowFieldCache<graph_type>::BuildFinished(int        target,
+                                               int        generation,
+                                               FlowField& field)
+{
+  if (generation != m_iGeneration || !m_Building.erase(target)) return;
+
+  //make room for the new field
+  if (m_Fields.size() >= m_iCapacity)
+  {
+    m_Index.erase(m_Fields.back().iTarget);
+
+    m_Fields.pop_back();
+  }
+
+  m_Fields.push_front(Entry());
+
+  Entry& entry = m_Fields.front();
+
+  entry.iTarget = target;
+
+  std::swap(entry.Field, field);
+
+  m_Index[target] = m_Fields.begin();
+
+  ++m_iNumBuilt;
+}
+
+//----------------------------- BuildAbandoned --------------------------------
+//-----------------------------------------------------------------------------
+template <class graph_type>
+void FlowFieldCache<graph_type>::BuildAbandoned(int target, int generation)
+{
+  if (generation == m_iGeneration) m_Building.erase(target);
+}
+
+
+//---------------------------- GetPathToTarget --------------------------------
+//-----------------------------------------------------------------------------
+template <class graph_type>
+std::list<int> Graph_FlowFieldSearch_TS<graph_type>::GetPathToTarget()const
+{
+  std::list<int> path;
+
+  if (m_dCost == MaxDouble) return path;
+
+  path.push_back(m_iSource);
+
+  for (unsigned int e=0; e<m_Path.size(); ++e)
+  {
+    path.push_back(m_Path[e]->To());
+  }
+
+  return path;
+}
+
+//-------------------------- GetPathAsPathEdges -------------------------------
+//-----------------------------------------------------------------------------
+template <class graph_type>
+std::list<PathEdge> Graph_FlowFieldSearch_TS<graph_type>::GetPathAsPathEdges()const
+{
+  std::list<PathEdge> path;
+
+  for (unsigned int e=0; e<m_Path.size(); ++e)
+  {
+    const Edge* pE = m_Path[e];
+
+    path.push_back(PathEdge(m_Graph.GetNode(pE->From()).Pos(),
+                            m_Graph.GetNode(pE->To()).Pos(),
+                            pE->Flags(),
+                            pE->IDofIntersectingEntity()));
+  }
+
+  return path;
+}
+
+
+#endif
@@ -0,0 +1,130 @@
+#include "PathCache.h"
+#include "Graph/GraphEdgeTypes.h"
+#include <algorithm>
+#include <climits>
+
+
+//------------------------------- Erase ---------------------------------------
+//-----------------------------------------------------------------------------
+void PathCache::Erase(PathList::iterator it)
+{
+  m_Index.erase(std::make_pair(it->iSource, it->iTarget));
+
+  m_Paths.erase(it);
+}
+
+//---------------------------- SetCapacity ------------------------------------
+//-----------------------------------------------------------------------------
+void PathCache::SetCapacity(unsigned int capacity)
+{
+  m_iCapacity = capacity;
+
+  while (m_Paths.size() > m_iCapacity)
+  {
+    Erase(--m_Paths.end());
+  }
+}
+
+//------------------------------- Clear ---------------------------------------
+//-----------------------------------------------------------------------------
+void PathCache::Clear()
+{
+  m_Paths.clear();
+  m_Index.clear();
+
+  m_iNumHits   = 0;
+  m_iNumMisses = 0;
+}
+
+//-------------------------------- Find ---------------------------------------
+//-----------------------------------------------------------------------------
+const PathCache::CachedPath* PathCache::Find(int source, int target)
+{
+  PathIndex::iterator entry = m_Index.find(std::make_pair(source, target));
+
+  if (entry == m_Index.end())
+  {
+    ++m_iNumMisses;
+
+    return NULL;
+  }
+
+  ++m_iNumHits;
+
+  //move the path to the front of the list
+  m_Paths.splice(m_Paths.begin(), m_Paths, entry->second);
+
+  return &(*entry->second);
+}
+
+//---------------------------- HasPathsFrom -----------------------------------
+//-----------------------------------------------------------------------------
+bool PathCache::HasPathsFrom(int source)const
+{
+  PathIndex::const_iterator entry = m_Index.lower_bound(std::make_pair(source, INT_MIN));
+
+  return entry != m_Index.end() && entry->first.first == source;
+}
+
+//--------------------------------- Add ---------------------------------------
+//-----------------------------------------------------------------------------
+void PathCache::Add(int                        source,
+                    int                        target,
+                    const std::list<int>&      nodes,
+                    const std::list<PathEdge>& edges,
+                    double                     cost)
+{
+  if (m_iCapacity == 0) return;
+
+  PathIndex::iterator entry = m_Index.find(std::make_pair(source, target));
+
+  if (entry != m_Index.end())
+  {
+    Erase(entry->second);
+  }
+
+  else if (m_Paths.size() == m_iCapacity)
+  {
+    Erase(--m_Paths.end());
+  }
+
+  m_Paths.push_front(CachedPath());
+
+  CachedPath& path = m_Paths.front();
+
+  path.iSource = source;
+  path.iTarget = target;
+  path.Nodes   = nodes;
+  path.Edges   = edges;
+  path.dCost   = cost;
+
+  for (std::list<PathEdge>::const_iterator e = edges.begin(); e != edges.end(); ++e)
+  {
+    if ((e->Behavior() & NavGraphEdge::goes_through_door) &&
+        std::find(path.Doors.begin(), path.Doors.end(), e->DoorID()) == path.Doors.end())
+    {
+      path.Doors.push_back(e->DoorID());
+    }
+  }
+
+  m_Index[std::make_pair(source, target)] = m_Paths.begin();
+}
+
+//--------------------------- InvalidateDoor ----------------------------------
+//-----------------------------------------------------------------------------
+void PathCache::InvalidateDoor(int DoorID)
+{
+  PathList::iterator it = m_Paths.begin();
+
+  while (it != m_Paths.end())
+  {
+    PathList::iterator next = it; ++next;
+
+    if (std::find(it->Doors.begin(), it->Doors.end(), DoorID) != it->Doors.end())
+    {
+      Erase(it);
+    }
+
+    it = next;
+  }
+}
@@ -0,0 +1,100 @@
+#ifndef PATH_CACHE_H
+#define PATH_CACHE_H
+#pragma warning (disable:4786)
+//-----------------------------------------------------------------------------
+//
+//  Name:   PathCache.h
+//
+//  Desc:   a bounded cache of the paths found between pairs of navgraph
+//          nodes, shared by all the bots' path planners. Bots often want a
+//          path between the same two nodes (to the same item giver, for
+//          example), and a cached path lets a planner answer those requests
+//          without searching.
+//
+//          The least recently used path is dropped when the cache is full.
+//          A door opening or closing drops every path that passes through
+//          it.
+//-----------------------------------------------------------------------------
+#include <list>
+#include <map>
+#include <vector>
+
+#include "PathEdge.h"
+
+
+class PathCache
+{
+public:
+
+  struct CachedPath
+  {
+    int                  iSource;
+    int                  iTarget;
+
+    //the nodes of the path, source to target, and the path itself
+    std::list<int>       Nodes;
+    std::list<PathEdge>  Edges;
+
+    double               dCost;
+
+    //the IDs of the doors the path goes through
+    std::vector<int>     Doors;
+  };
+
+private:
+
+  typedef std::list<CachedPath>                           PathList;
+  typedef std::map<std::pair<int, int>, PathList::iterator> PathIndex;
+
+  //the paths, most recently used first
+  PathList      m_Paths;
+
+  //the paths by source and target node
+  PathIndex     m_Index;
+
+  unsigned int  m_iCapacity;
+
+  int           m_iNumHits;
+  int           m_iNumMisses;
+
+  void Erase(PathList::iterator it);
+
+public:
+
+  PathCache(unsigned int capacity = 0):m_iCapacity(capacity),
+                                       m_iNumHits(0),
+                                       m_iNumMisses(0)
+  {}
+
+  //sets the maximum number of paths held, dropping the least recently used
+  //if there are now too many. A capacity of zero disables the cache
+  void  SetCapacity(unsigned int capacity);
+
+  void  Clear();
+
+  //returns the path from source to target (and makes it the most recently
+  //used) or NULL if it isn't cached. The pointer is only valid until the
+  //cache is next changed
+  const CachedPath* Find(int source, int target);
+
+  //true if any path from source is cached
+  bool  HasPathsFrom(int source)const;
+
+  //caches a path, replacing any already held between the same nodes
+  void  Add(int                        source,
+            int                        target,
+            const std::list<int>&      nodes,
+            const std::list<PathEdge>& edges,
+            double                     cost);
+
+  //drops every path through the door
+  void  InvalidateDoor(int DoorID);
+
+  unsigned int Size()const{return m_Paths.size();}
+  unsigned int Capacity()const{return m_iCapacity;}
+  int          NumHits()const{return m_iNumHits;}
+  int          NumMisses()const{return m_iNumMisses;}
+};
+
+
+#endif
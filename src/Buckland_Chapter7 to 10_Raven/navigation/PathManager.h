@@ -7,12 +7,55 @@
 //
 //  Author: Mat Buckland (www.ai-junkie.com)
 //
-//  Desc:   a template class to manage a number of graph searches, and to 
+//  Desc:   a template class to manage a number of graph searches, and to
 //          distribute the calculation of each search over several update-steps
+//
+//          Each update-step the searches are given a time budget (or, if the
+//          budget is zero, a number of search cycles). The requests are
+//          served in turn, highest priority first, each getting a slice of
+//          cycles in proportion to its priority, so a short search never has
+//          to wait for a long one to finish. A request's priority rises the
+//          longer it waits so low priority requests are never starved.
+//
+//          Alternatively the manager can be given a pool of worker threads,
+//          in which case each search is run to completion by a worker and
+//          its result delivered to the planner at the start of the next
+//          update-step. The searches only read the navgraph, and are still
+//          created and deleted on the game thread, so the workspace pools
+//          need no locking.
+//
+//          The path_planner class must provide GetSearchPriority(),
+//          SetSearchStats(const PathSearchStats&), GetSearch() and
+//          SearchFinished(int result) as well as CycleOnce().
 //-----------------------------------------------------------------------------
 #include <list>
+#include <vector>
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
 #include <cassert>
 
+#include "SearchWorkspace.h"
+#include "TimeSlicedGraphAlgorithms.h"
+
+
+//the timings of a completed path request, in milliseconds
+struct PathSearchStats
+{
+  //from the request being registered to its first search cycle
+  double  dQueueLatency;
+
+  //from the request being registered to its result being delivered
+  double  dTotalLatency;
+
+  int     iNumCycles;
+  int     iPriority;
+
+  PathSearchStats():dQueueLatency(0), dTotalLatency(0), iNumCycles(0), iPriority(0){}
+};
 
 
 template <class path_planner>
@@ -20,40 +63,378 @@ class PathManager
 {
 private:
 
+  typedef std::chrono::steady_clock    SearchClock;
+
+  struct SearchRequest
+  {
+    path_planner*           pPlanner;
+
+    int                     iPriority;
+
+    SearchClock::time_point Registered;
+
+    //the priority the request is served at this update-step, including
+    //the amount it has aged by
+    double                  dEffectivePriority;
+
+    bool                    bStarted;
+
+    PathSearchStats         Stats;
+  };
+
+  typedef Graph_SearchTimeSliced<typename path_planner::EdgeType> SearchType;
+
+  //a request being run by the worker threads
+  struct AsyncJob
+  {
+    SearchRequest           Request;
+
+    //set to NULL once the planner has given up on the request, in which
+    //case the manager deletes the search when the worker is done with it
+    path_planner*           pPlanner;
+
+    SearchType*             pSearch;
+
+    //the following are guarded by m_JobMutex
+    bool                    bRunning;
+    bool                    bFinished;
+    int                     iResult;
+
+    //tells the worker to stop early
+    std::atomic<bool>       bCancelled;
+
+    AsyncJob(const SearchRequest& request,
+             SearchType*          pSearch):Request(request),
+                                          pPlanner(request.pPlanner),
+                                          pSearch(pSearch),
+                                          bRunning(false),
+                                          bFinished(false),
+                                          iResult(search_incomplete),
+                                          bCancelled(false)
+    {}
+  };
+
+  //orders requests by their effective priority, highest first
+  static bool HigherPriority(const SearchRequest& a, const SearchRequest& b)
+  {
+    return a.dEffectivePriority > b.dEffectivePriority;
+  }
+
   //a container of all the active search requests
-  std::list<path_planner*>  m_SearchRequests;
+  std::list<SearchRequest>  m_SearchRequests;
+
+  //requests that were answered without a search (from the path cache).
+  //These are completed at the start of the next update and don't use up
+  //any of the budget
+  std::list<SearchRequest>  m_AnsweredRequests;
 
-  //this is the total number of search cycles allocated to the manager. 
-  //Each update-step these are divided equally amongst all registered path
-  //requests
+  //this is the total number of search cycles allocated to the manager
+  //each update-step if there is no time budget
   unsigned int              m_iNumSearchCyclesPerUpdate;
 
+  //the time the searches may take each update-step, in microseconds
+  double                    m_dBudgetMicroseconds;
+
+  //the number of cycles a request of priority zero is given before moving
+  //on to the next. A request of priority p is given (p+1) times as many,
+  //up to a priority of MaxSlicePriority
+  unsigned int              m_iCyclesPerSlice;
+
+  enum {MaxSlicePriority = 15};
+
+  //the amount a request's priority rises each second it waits
+  double                    m_dAgingRate;
+
+  //running totals of the completed requests' stats
+  int                       m_iNumCompleted;
+  double                    m_dTotalQueueLatency;
+  double                    m_dMaxQueueLatency;
+
+  //the searches take their per-node storage from here, so that starting a
+  //search doesn't allocate any (see SearchWorkspace.h)
+  SearchWorkspacePool<typename path_planner::EdgeType>  m_Workspaces;
+
+  //and the hierarchical searches from here
+  SearchWorkspacePool<typename path_planner::AbstractEdgeType>  m_AbstractWorkspaces;
+
+  //the worker threads (none if the searches are time-sliced)
+  std::vector<std::thread>  m_Workers;
+
+  //every request handed to the workers and not yet delivered. Only the
+  //game thread changes this list
+  std::list<AsyncJob*>      m_AsyncJobs;
+
+  //the requests waiting for a worker, highest priority first
+  std::list<AsyncJob*>      m_QueuedJobs;
+
+  //guards m_QueuedJobs, m_bShutdown and the jobs' result fields
+  std::mutex                m_JobMutex;
+  std::condition_variable   m_JobQueued;
+  bool                      m_bShutdown;
+
+
+  SearchRequest MakeRequest(path_planner* pPathPlanner)const
+  {
+    SearchRequest request;
+
+    request.pPlanner           = pPathPlanner;
+    request.iPriority          = pPathPlanner->GetSearchPriority();
+    request.Registered         = SearchClock::now();
+    request.dEffectivePriority = request.iPriority;
+    request.bStarted           = false;
+
+    request.Stats.iPriority    = request.iPriority;
+
+    return request;
+  }
+
+  //milliseconds between two times
+  static double Milliseconds(SearchClock::time_point from, SearchClock::time_point to)
+  {
+    return std::chrono::duration<double, std::milli>(to - from).count();
+  }
+
+  //runs up to NumCycles cycles of a request, stopping early if the clock
+  //passes Deadline (it is looked at once every m_iCyclesPerSlice cycles, so
+  //a high priority request's big slice can't overrun the time budget by
+  //much). Returns true if the search terminated, in which case its stats
+  //are handed to its planner
+  bool Serve(SearchRequest&          request,
+             unsigned int            NumCycles,
+             unsigned int&           CyclesUsed,
+             SearchClock::time_point Deadline = SearchClock::time_point::max());
+
+  //adds a completed request to the running totals and hands its stats to
+  //its planner
+  void Complete(SearchRequest& request);
+
+  //the worker threads run this until the manager is destroyed
+  void RunWorker();
+
+  //hands the results of the requests the workers have finished to their
+  //planners
+  void DeliverAsyncResults();
+
+  PathManager(const PathManager&);
+  PathManager& operator=(const PathManager&);
+
 public:
-    
-  PathManager(unsigned int NumCyclesPerUpdate):m_iNumSearchCyclesPerUpdate(NumCyclesPerUpdate){}
 
-  //every time this is called the total amount of search cycles available will
-  //be shared out equally between all the active path requests. If a search
-  //completes successfully or fails the method will notify the relevant bot
+  //if NumWorkerThreads is not zero the searches are run to completion by
+  //that many worker threads instead of being time-sliced
+  PathManager(unsigned int NumCyclesPerUpdate,
+              double       BudgetMicroseconds = 0,
+              unsigned int CyclesPerSlice = 1,
+              double       AgingRate = 0,
+              unsigned int NumWorkerThreads = 0):m_iNumSearchCyclesPerUpdate(NumCyclesPerUpdate),
+                                                 m_dBudgetMicroseconds(BudgetMicroseconds),
+                                                 m_iCyclesPerSlice(CyclesPerSlice > 0 ? CyclesPerSlice : 1),
+                                                 m_dAgingRate(AgingRate),
+                                                 m_iNumCompleted(0),
+                                                 m_dTotalQueueLatency(0),
+                                                 m_dMaxQueueLatency(0),
+                                                 m_bShutdown(false)
+  {
+    for (unsigned int t=0; t<NumWorkerThreads; ++t)
+    {
+      m_Workers.push_back(std::thread(&PathManager::RunWorker, this));
+    }
+  }
+
+  //stops the workers. Any searches they were running are abandoned
+  ~PathManager();
+
+  //every time this is called the search budget is shared out between the
+  //active path requests in order of priority. If a search completes
+  //successfully or fails the method will notify the relevant bot
   void UpdateSearches();
 
-  //a path planner should call this method to register a search with the 
+  //a path planner should call this method to register a search with the
   //manager. (The method checks to ensure the path planner is only registered
   //once)
   void Register(path_planner* pPathPlanner);
 
-  void UnRegister(path_planner* pPathPlanner);
+  //a path planner that already has the answer to its request calls this
+  //instead of Register
+  void RegisterAnswered(path_planner* pPathPlanner);
+
+  //removes the planner's request. Returns true if a worker thread is still
+  //running the planner's search, in which case the manager takes ownership
+  //of the search and deletes it once the worker has finished with it
+  bool UnRegister(path_planner* pPathPlanner);
 
   //returns the amount of path requests currently active.
-  int  GetNumActiveSearches()const{return m_SearchRequests.size();}
+  int  GetNumActiveSearches()const{return m_SearchRequests.size() + m_AsyncJobs.size();}
+
+  bool isAsync()const{return !m_Workers.empty();}
+
+  //the queue latency stats (in milliseconds) of the requests completed so far
+  int    GetNumCompletedSearches()const{return m_iNumCompleted;}
+  double GetAverageQueueLatency()const{return m_iNumCompleted ? m_dTotalQueueLatency / m_iNumCompleted : 0.0;}
+  double GetMaxQueueLatency()const{return m_dMaxQueueLatency;}
+
+  SearchWorkspacePool<typename path_planner::EdgeType>& GetWorkspacePool(){return m_Workspaces;}
+
+  SearchWorkspacePool<typename path_planner::AbstractEdgeType>& GetAbstractWorkspacePool(){return m_AbstractWorkspaces;}
 };
 
+//------------------------------- Serve ---------------------------------------
+//-----------------------------------------------------------------------------
+template <class path_planner>
+bool PathManager<path_planner>::Serve(SearchRequest&          request,
+                                      unsigned int            NumCycles,
+                                      unsigned int&           CyclesUsed,
+                                      SearchClock::time_point Deadline)
+{
+  if (!request.bStarted)
+  {
+    request.bStarted            = true;
+    request.Stats.dQueueLatency = Milliseconds(request.Registered, SearchClock::now());
+  }
+
+  const bool bTimed = Deadline != SearchClock::time_point::max();
+
+  for (unsigned int cycle=1; cycle<=NumCycles; ++cycle)
+  {
+    int result = request.pPlanner->CycleOnce();
+
+    ++request.Stats.iNumCycles;
+    ++CyclesUsed;
+
+    if ( (result == target_found) || (result == target_not_found) )
+    {
+      Complete(request);
+
+      return true;
+    }
+
+    if (bTimed && (cycle % m_iCyclesPerSlice == 0) && SearchClock::now() >= Deadline)
+    {
+      break;
+    }
+  }
+
+  return false;
+}
+
+//------------------------------ Complete -------------------------------------
+//-----------------------------------------------------------------------------
+template <class path_planner>
+void PathManager<path_planner>::Complete(SearchRequest& request)
+{
+  request.Stats.dTotalLatency = Milliseconds(request.Registered, SearchClock::now());
+
+  ++m_iNumCompleted;
+  m_dTotalQueueLatency += request.Stats.dQueueLatency;
+
+  if (request.Stats.dQueueLatency > m_dMaxQueueLatency)
+  {
+    m_dMaxQueueLatency = request.Stats.dQueueLatency;
+  }
+
+  request.pPlanner->SetSearchStats(request.Stats);
+}
+
+//------------------------------ RunWorker ------------------------------------
+//
+//  takes the highest priority queued request and runs its search to
+//  completion (or until the request is cancelled), then marks it finished
+//  for DeliverAsyncResults to pick up
+//-----------------------------------------------------------------------------
+template <class path_planner>
+void PathManager<path_planner>::RunWorker()
+{
+  for (;;)
+  {
+    AsyncJob* pJob = NULL;
+
+    {
+      std::unique_lock<std::mutex> lock(m_JobMutex);
+
+      m_JobQueued.wait(lock, [this](){return m_bShutdown || !m_QueuedJobs.empty();});
+
+      if (m_bShutdown) return;
+
+      pJob = m_QueuedJobs.front();
+      m_QueuedJobs.pop_front();
+
+      pJob->bRunning = true;
+    }
+
+    SearchClock::time_point start = SearchClock::now();
+
+    int result    = search_incomplete;
+    int NumCycles = 0;
+
+    while (result == search_incomplete && !pJob->bCancelled)
+    {
+      result = pJob->pSearch->CycleOnce();
+
+      ++NumCycles;
+    }
+
+    std::lock_guard<std::mutex> lock(m_JobMutex);
+
+    pJob->iResult                     = result;
+    pJob->Request.Stats.dQueueLatency = Milliseconds(pJob->Request.Registered, start);
+    pJob->Request.Stats.iNumCycles    = NumCycles;
+    pJob->bFinished                   = true;
+  }
+}
+
+//------------------------- DeliverAsyncResults -------------------------------
+//-----------------------------------------------------------------------------
+template <class path_planner>
+void PathManager<path_planner>::DeliverAsyncResults()
+{
+  std::vector<AsyncJob*> finished;
+
+  {
+    std::lock_guard<std::mutex> lock(m_JobMutex);
+
+    typename std::list<AsyncJob*>::iterator it = m_AsyncJobs.begin();
+
+    while (it != m_AsyncJobs.end())
+    {
+      if ((*it)->bFinished)
+      {
+        finished.push_back(*it);
+
+        it = m_AsyncJobs.erase(it);
+      }
+      else
+      {
+        ++it;
+      }
+    }
+  }
+
+  //the planners are told outside the lock as they may make new requests
+  for (unsigned int j=0; j<finished.size(); ++j)
+  {
+    AsyncJob* pJob = finished[j];
+
+    if (pJob->pPlanner)
+    {
+      pJob->pPlanner->SearchFinished(pJob->iResult);
+
+      Complete(pJob->Request);
+    }
+    else
+    {
+      delete pJob->pSearch;
+    }
+
+    delete pJob;
+  }
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 //------------------------- UpdateSearches ------------------------------------
 //
-//  This method iterates through all the active path planning requests 
-//  updating their searches until the user specified total number of search
-//  cycles has been satisfied.
+//  This method works through the active path planning requests, highest
+//  priority first, giving each a slice of search cycles in turn until the
+//  update-step's budget has been used up.
 //
 //  If a path is found or the search is unsuccessful the relevant agent is
 //  notified accordingly by Telegram
@@ -61,35 +442,86 @@ public:
 template <class path_planner>
 inline void PathManager<path_planner>::UpdateSearches()
 {
-  int NumCyclesRemaining = m_iNumSearchCyclesPerUpdate;
+  if (!m_AsyncJobs.empty()) DeliverAsyncResults();
+
+  unsigned int CyclesUsed = 0;
+
+  //the answered requests take a single cycle to complete, which is not
+  //counted against the budget
+  while (!m_AnsweredRequests.empty())
+  {
+    SearchRequest request = m_AnsweredRequests.front();
+
+    m_AnsweredRequests.pop_front();
+
+    Serve(request, 1, CyclesUsed);
+  }
+
+  if (m_SearchRequests.empty()) return;
+
+  SearchClock::time_point start = SearchClock::now();
+
+  SearchClock::time_point deadline = SearchClock::time_point::max();
+
+  if (m_dBudgetMicroseconds > 0)
+  {
+    deadline = start + std::chrono::duration_cast<SearchClock::duration>(
+                         std::chrono::duration<double, std::micro>(m_dBudgetMicroseconds));
+  }
+
+  //age the requests and put them in order of priority
+  for (typename std::list<SearchRequest>::iterator it = m_SearchRequests.begin();
+       it != m_SearchRequests.end();
+       ++it)
+  {
+    it->dEffectivePriority = it->iPriority +
+                     m_dAgingRate * Milliseconds(it->Registered, start) * 0.001;
+  }
+
+  m_SearchRequests.sort(HigherPriority);
+
+  CyclesUsed = 0;
+
+  bool bBudgetLeft = true;
 
   //iterate through the search requests until either all requests have been
-  //fulfilled or there are no search cycles remaining for this update-step.
-  std::list<path_planner*>::iterator curPath = m_SearchRequests.begin();
-  while (NumCyclesRemaining-- && !m_SearchRequests.empty())
+  //fulfilled or there is no budget remaining for this update-step.
+  while (bBudgetLeft && !m_SearchRequests.empty())
   {
-    //make one search cycle of this path request
-    int result = (*curPath)->CycleOnce();
+    typename std::list<SearchRequest>::iterator curPath = m_SearchRequests.begin();
 
-    //if the search has terminated remove from the list
-    if ( (result == target_found) || (result == target_not_found) )
-    {
-      //remove this path from the path list
-      curPath = m_SearchRequests.erase(curPath);       
-    }
-    //move on to the next
-    else
+    while (curPath != m_SearchRequests.end())
     {
-      ++curPath;
-    }
+      //a long wait puts a request first but doesn't grow its slice forever
+      double SlicePriority = (std::min)(curPath->dEffectivePriority,
+                                        (double)MaxSlicePriority);
 
-    //the iterator may now be pointing to the end of the list. If this is so,
-    // it must be reset to the beginning.
-    if (curPath == m_SearchRequests.end())
-    {
-      curPath = m_SearchRequests.begin();
-    }
+      unsigned int NumCycles = (unsigned int)(m_iCyclesPerSlice *
+                                   (1.0 + (std::max)(SlicePriority, 0.0)));
+
+      if (m_dBudgetMicroseconds <= 0)
+      {
+        if (CyclesUsed >= m_iNumSearchCyclesPerUpdate){bBudgetLeft = false; break;}
 
+        NumCycles = (std::min)(NumCycles, m_iNumSearchCyclesPerUpdate - CyclesUsed);
+      }
+
+      //if the search has terminated remove it from the list, otherwise move
+      //on to the next
+      if (Serve(*curPath, NumCycles, CyclesUsed, deadline))
+      {
+        curPath = m_SearchRequests.erase(curPath);
+      }
+      else
+      {
+        ++curPath;
+      }
+
+      if (m_dBudgetMicroseconds > 0 && SearchClock::now() >= deadline)
+      {
+        bBudgetLeft = false; break;
+      }
+    }
   }//end while
 }
 
@@ -101,26 +533,154 @@ template <class path_planner>
 inline void PathManager<path_planner>::Register(path_planner* pPathPlanner)
 {
   //make sure the bot does not already have a current search in the queue
-  if(std::find(m_SearchRequests.begin(),
-               m_SearchRequests.end(),
-               pPathPlanner) == m_SearchRequests.end())
-  { 
+  for (typename std::list<SearchRequest>::const_iterator it = m_SearchRequests.begin();
+       it != m_SearchRequests.end();
+       ++it)
+  {
+    if (it->pPlanner == pPathPlanner) return;
+  }
+
+  for (typename std::list<AsyncJob*>::const_iterator job = m_AsyncJobs.begin();
+       job != m_AsyncJobs.end();
+       ++job)
+  {
+    if ((*job)->pPlanner == pPathPlanner) return;
+  }
+
+  if (!isAsync())
+  {
     //add to the list
-    m_SearchRequests.push_back(pPathPlanner);
+    m_SearchRequests.push_back(MakeRequest(pPathPlanner));
+
+    return;
   }
+
+  //otherwise queue the search for the workers
+  AsyncJob* pJob = new AsyncJob(MakeRequest(pPathPlanner), pPathPlanner->GetSearch());
+
+  m_AsyncJobs.push_back(pJob);
+
+  {
+    std::lock_guard<std::mutex> lock(m_JobMutex);
+
+    typename std::list<AsyncJob*>::iterator it = m_QueuedJobs.begin();
+
+    while (it != m_QueuedJobs.end() && (*it)->Request.iPriority >= pJob->Request.iPriority) ++it;
+
+    m_QueuedJobs.insert(it, pJob);
+  }
+
+  m_JobQueued.notify_one();
+}
+
+//------------------------- RegisterAnswered ----------------------------------
+//-----------------------------------------------------------------------------
+template <class path_planner>
+inline void PathManager<path_planner>::RegisterAnswered(path_planner* pPathPlanner)
+{
+  for (typename std::list<SearchRequest>::const_iterator it = m_AnsweredRequests.begin();
+       it != m_AnsweredRequests.end();
+       ++it)
+  {
+    if (it->pPlanner == pPathPlanner) return;
+  }
+
+  m_AnsweredRequests.push_back(MakeRequest(pPathPlanner));
 }
 
 //----------------------------- UnRegister ------------------------------------
 //-----------------------------------------------------------------------------
 template <class path_planner>
-inline void PathManager<path_planner>::UnRegister(path_planner* pPathPlanner)
+inline bool PathManager<path_planner>::UnRegister(path_planner* pPathPlanner)
+{
+  typename std::list<SearchRequest>::iterator it;
+
+  for (it = m_SearchRequests.begin(); it != m_SearchRequests.end(); )
+  {
+    if (it->pPlanner == pPathPlanner) it = m_SearchRequests.erase(it); else ++it;
+  }
+
+  for (it = m_AnsweredRequests.begin(); it != m_AnsweredRequests.end(); )
+  {
+    if (it->pPlanner == pPathPlanner) it = m_AnsweredRequests.erase(it); else ++it;
+  }
+
+  if (m_AsyncJobs.empty()) return false;
+
+  bool bSearchKept = false;
+
+  std::lock_guard<std::mutex> lock(m_JobMutex);
+
+  typename std::list<AsyncJob*>::iterator job = m_AsyncJobs.begin();
+
+  while (job != m_AsyncJobs.end())
+  {
+    AsyncJob* pJob = *job;
+
+    if (pJob->pPlanner != pPathPlanner){++job; continue;}
+
+    //a worker is still running the search, so it must be left for the
+    //worker to finish with
+    if (pJob->bRunning && !pJob->bFinished)
+    {
+      pJob->pPlanner   = NULL;
+      pJob->bCancelled = true;
+
+      bSearchKept = true;
+
+      ++job;
+    }
+    else
+    {
+      if (!pJob->bRunning) m_QueuedJobs.remove(pJob);
+
+      delete pJob;
+
+      job = m_AsyncJobs.erase(job);
+    }
+  }
+
+  return bSearchKept;
+}
+
+//-------------------------------- dtor ---------------------------------------
+//-----------------------------------------------------------------------------
+template <class path_planner>
+PathManager<path_planner>::~PathManager()
 {
-  m_SearchRequests.remove(pPathPlanner);
+  {
+    std::lock_guard<std::mutex> lock(m_JobMutex);
+
+    m_bShutdown = true;
+
+    for (typename std::list<AsyncJob*>::iterator job = m_AsyncJobs.begin();
+         job != m_AsyncJobs.end();
+         ++job)
+    {
+      (*job)->bCancelled = true;
+    }
+  }
 
+  m_JobQueued.notify_all();
+
+  for (unsigned int t=0; t<m_Workers.size(); ++t)
+  {
+    m_Workers[t].join();
+  }
+
+  //the searches of requests still owned by a planner are deleted by it
+  for (typename std::list<AsyncJob*>::iterator job = m_AsyncJobs.begin();
+       job != m_AsyncJobs.end();
+       ++job)
+  {
+    if (!(*job)->pPlanner) delete (*job)->pSearch;
+
+    delete *job;
+  }
 }
 
 
 
 
 
-#endif
\ No newline at end of file
+#endif
@@ -18,12 +18,22 @@
 #include "Debug/DebugConsole.h"
 //#define SHOW_NAVINFO
 #include <cassert>
+#include <algorithm>
+#include <iterator>
 
 //---------------------------- ctor -------------------------------------------
 //-----------------------------------------------------------------------------
 Raven_PathPlanner::Raven_PathPlanner(Raven_Bot* owner):m_pOwner(owner),
                m_NavGraph(m_pOwner->GetWorld()->GetMap()->GetNavGraph()),
-               m_pCurrentSearch(NULL)
+               m_SearchGraph(m_pOwner->GetWorld()->GetMap()->GetFrozenNavGraph()),
+               m_pCurrentSearch(NULL),
+               m_pIncrementalSearch(NULL),
+               m_bRepairing(false),
+               m_pFieldSearch(NULL),
+               m_iPathID(0),
+               m_iSearchSource(no_closest_node_found),
+               m_bCacheResult(false),
+               m_iPriority(priority_normal)
 {
 }
 
@@ -41,12 +51,26 @@ Raven_PathPlanner::~Raven_PathPlanner()
 //-----------------------------------------------------------------------------
 void Raven_PathPlanner::GetReadyForNewSearch()
 {
-  //unregister any existing search with the path manager
-  m_pOwner->GetWorld()->GetPathManager()->UnRegister(this);
+  //unregister any existing search with the path manager. If a worker thread
+  //is still running the search the path manager deletes it instead
+  if (m_pOwner->GetWorld()->GetPathManager()->UnRegister(this))
+  {
+    m_pCurrentSearch = 0;
+  }
 
   //clean up memory used by any existing search
   delete m_pCurrentSearch;    
   m_pCurrentSearch = 0;
+
+  m_pIncrementalSearch = NULL;
+  m_bRepairing         = false;
+  m_DeliveredNodes.clear();
+
+  m_pFieldSearch = NULL;
+
+  m_bCacheResult = false;
+
+  ++m_iPathID;
 }
 
 //---------------------------- GetCostToNode ----------------------------------
@@ -69,9 +93,10 @@ double Raven_PathPlanner::GetCostToNode(unsigned int NodeIdx)const
 
 //------------------------ GetCostToClosestItem ---------------------------
 //
-//  returns the cost to the closest instance of the giver type. This method
-//  makes use of the pre-calculated lookup table. Returns -1 if no active
-//  trigger found
+//  returns the cost to the closest instance of the giver type. The items
+//  that don't belong to a team are looked up in the map's field for the
+//  type, and any belonging to the bot's team in the pre-calculated lookup
+//  table. Returns -1 if no active trigger found
 //-----------------------------------------------------------------------------
 double Raven_PathPlanner::GetCostToClosestItem(unsigned int GiverType)const
 {
@@ -83,19 +108,23 @@ double Raven_PathPlanner::GetCostToClosestItem(unsigned int GiverType)const
 
   double ClosestSoFar = MaxDouble;
 
-  //iterate through all the triggers to find the closest *active* trigger of 
-  //type GiverType
-  const Raven_Map::TriggerSystem::TriggerList& triggers = m_pOwner->GetWorld()->GetMap()->GetTriggers();
+  const Raven_Map::ItemField* pField = m_pOwner->GetWorld()->GetMap()->GetItemField(GiverType);
+
+  if (pField)
+  {
+    ClosestSoFar = pField->Cost(nd);
+  }
+
+  const std::vector<Raven_Map::TriggerType*>& TeamItems = m_pOwner->GetWorld()->GetMap()->GetTeamItems();
 
-  Raven_Map::TriggerSystem::TriggerList::const_iterator it;
-  for (it = triggers.begin(); it != triggers.end(); ++it)
+  for (unsigned int i=0; i<TeamItems.size(); ++i)
   {
-    if ( ((*it)->EntityType() == GiverType) && (*it)->isActive() && 
-		(!(*it)->IsInATeam() || ((*it)->IsInATeam() && (*it)->GetNameTeam() == m_pOwner->GetNameTeam()))) // Si l'objet n'est pas dans une team ou qu'il est dans la mme team que le bot
+    if ( (TeamItems[i]->EntityType() == GiverType) && TeamItems[i]->isActive() &&
+         (TeamItems[i]->GetNameTeam() == m_pOwner->GetNameTeam()) )
     {
       double cost = 
       m_pOwner->GetWorld()->GetMap()->CalculateCostToTravelBetweenNodes(nd,
-                                                      (*it)->GraphNodeIndex());
+                                                      TeamItems[i]->GraphNodeIndex());
 
       if (cost < ClosestSoFar)
       {
@@ -113,7 +142,6 @@ double Raven_PathPlanner::GetCostToClosestItem(unsigned int GiverType)const
   return ClosestSoFar;
 }
 
-
 //----------------------------- GetPath ------------------------------------
 //
 //  called by an agent after it has been notified that a search has terminated
@@ -134,10 +162,53 @@ Raven_PathPlanner::Path Raven_PathPlanner::GetPath()
                             GetNodePosition(closest),
                             NavGraphEdge::normal));
 
-  
+  FinishPath(path);
+
+  //a hierarchical search may have found it can't complete the path after
+  //all. The bot is told there's no path (it is still handling the message
+  //saying there was one, so this reaches the goal that made the request)
+  if (m_pCurrentSearch->RefinementFailed())
+  {
+    Dispatcher->DispatchMsg(SEND_MSG_IMMEDIATELY,
+                            SENDER_ID_IRRELEVANT,
+                            m_pOwner->ID(),
+                            Msg_NoPathAvailable,
+                            NO_ADDITIONAL_INFO);
+  }
+
+  return path;
+}
+
+//----------------------------- ExtendPath ---------------------------------
+//-----------------------------------------------------------------------------
+bool Raven_PathPlanner::ExtendPath(Path& path, int PathID)
+{
+  if (PathID != m_iPathID || !m_pCurrentSearch) return true;
+
+  if (m_pCurrentSearch->HasUnrefinedPath())
+  {
+    Path next;
+
+    m_pCurrentSearch->RefineNextSegment(next);
+
+    FinishPath(next);
+
+    path.splice(path.end(), next);
+  }
+
+  return !m_pCurrentSearch->RefinementFailed();
+}
+
+//----------------------------- FinishPath ---------------------------------
+//-----------------------------------------------------------------------------
+void Raven_PathPlanner::FinishPath(Path& path)
+{
   //if the bot requested a path to a location then an edge leading to the
-  //destination must be added
-  if (m_pCurrentSearch->GetType() == Graph_SearchTimeSliced<EdgeType>::AStar)
+  //destination must be added (once the whole path has been handed out, and
+  //only if all of it was found)
+  if (m_pCurrentSearch->GetType() == Graph_SearchTimeSliced<EdgeType>::AStar &&
+      !m_pCurrentSearch->HasUnrefinedPath() &&
+      !m_pCurrentSearch->RefinementFailed() && !path.empty())
   {   
     path.push_back(PathEdge(path.back().Destination(),
                             m_vDestinationPos,
@@ -154,8 +225,6 @@ Raven_PathPlanner::Path Raven_PathPlanner::GetPath()
   {
     SmoothPathEdgesPrecise(path);
   }
-
-  return path;
 }
 
 //--------------------------- SmoothPathEdgesQuick ----------------------------
@@ -164,78 +233,142 @@ Raven_PathPlanner::Path Raven_PathPlanner::GetPath()
 //-----------------------------------------------------------------------------
 void Raven_PathPlanner::SmoothPathEdgesQuick(Path& path)
 {
-  //create a couple of iterators and point them at the front of the path
-  Path::iterator e1(path.begin()), e2(path.begin());
+  if (path.size() < 2) return;
+
+  m_SmoothBuffer.assign(path.begin(), path.end());
+
+  //step through the edges checking to see if the agent can move without
+  //obstruction from the source of the current edge, e1, to the destination
+  //of the next, e2. If it can the two edges are replaced with a single
+  //edge, otherwise e1 is kept and e2 becomes the current edge. The kept
+  //edges are packed at the front of the buffer
+  int NumKept = 0;
 
-  //increment e2 so it points to the edge following e1.
-  ++e2;
+  PathEdge e1 = m_SmoothBuffer[0];
 
-  //while e2 is not the last edge in the path, step through the edges checking
-  //to see if the agent can move without obstruction from the source node of
-  //e1 to the destination node of e2. If the agent can move between those 
-  //positions then the two edges are replaced with a single edge.
-  while (e2 != path.end())
+  for (unsigned int i=1; i<m_SmoothBuffer.size(); ++i)
   {
+    const PathEdge& e2 = m_SmoothBuffer[i];
+
     //check for obstruction, adjust and remove the edges accordingly
-    if ( (e2->Behavior() == EdgeType::normal) &&
-          m_pOwner->canWalkBetween(e1->Source(), e2->Destination()) )
+    if ( (e2.Behavior() == EdgeType::normal) &&
+          m_pOwner->canWalkBetween(e1.Source(), e2.Destination()) )
     {
-      e1->SetDestination(e2->Destination());
-      e2 = path.erase(e2);
+      e1.SetDestination(e2.Destination());
     }
 
     else
     {
+      m_SmoothBuffer[NumKept++] = e1;
       e1 = e2;
-      ++e2;
     }
   }
+
+  m_SmoothBuffer[NumKept++] = e1;
+
+  CopySmoothedPath(path, NumKept);
 }
 
 
 //----------------------- SmoothPathEdgesPrecise ---------------------------------
 //
-//  smooths a path by removing extraneous edges.
+//  smooths a path by removing extraneous edges. Starting from the first
+//  edge, it is extended to the destination of the furthest following edge
+//  that can be walked to directly, the edges in between are removed, and
+//  the process continues from the edge after. Only normal edges can be
+//  removed, so a door or other special edge stays where it is.
+//
+//  Rather than trying every following edge, the furthest is found by
+//  testing edges 1, 2, 4, 8... ahead until one can't be walked to and then
+//  halving the gap between the last edge that could and that one. This
+//  needs only O(log n) walk tests per edge kept and so finds much the same
+//  path as testing them all.
 //-----------------------------------------------------------------------------
 void Raven_PathPlanner::SmoothPathEdgesPrecise(Path& path)
 {
-  //create a couple of iterators
-  Path::iterator e1, e2;
-
-  //point e1 to the beginning of the path
-  e1 = path.begin();
-    
-  while (e1 != path.end())
-  {
-    //point e2 to the edge immediately following e1
-    e2 = e1; 
-    ++e2;
-
-    //while e2 is not the last edge in the path, step through the edges
-    //checking to see if the agent can move without obstruction from the 
-    //source node of e1 to the destination node of e2. If the agent can move
-    //between those positions then the any edges between e1 and e2 are
-    //replaced with a single edge.
-    while (e2 != path.end())
+  if (path.size() < 2) return;
+
+  m_SmoothBuffer.assign(path.begin(), path.end());
+
+  const int NumEdges = (int)m_SmoothBuffer.size();
+
+  //m_SmoothRunEnd[i] is the last edge of the run of normal edges that
+  //follows edge i, ie. the furthest edge edge i can be extended over
+  m_SmoothRunEnd.resize(NumEdges);
+
+  m_SmoothRunEnd[NumEdges-1] = NumEdges-1;
+
+  for (int i=NumEdges-2; i>=0; --i)
+  {
+    m_SmoothRunEnd[i] = m_SmoothBuffer[i+1].Behavior() == EdgeType::normal ?
+                        m_SmoothRunEnd[i+1] : i;
+  }
+
+  int NumKept = 0;
+
+  for (int e1=0; e1<NumEdges; )
+  {
+    const Vector2D start  = m_SmoothBuffer[e1].Source();
+    const int      RunEnd = m_SmoothRunEnd[e1];
+
+    //the furthest edge known to be reachable, and the nearest known not
+    //to be (or one past the run)
+    int reachable   = e1;
+    int unreachable = RunEnd + 1;
+
+    for (int step=1; e1+step <= RunEnd; step *= 2)
     {
-      //check for obstruction, adjust and remove the edges accordingly
-      if ( (e2->Behavior() == EdgeType::normal) &&
-            m_pOwner->canWalkBetween(e1->Source(), e2->Destination()) )
+      if (m_pOwner->canWalkBetween(start, m_SmoothBuffer[e1+step].Destination()))
+      {
+        reachable = e1+step;
+      }
+      else
       {
-        e1->SetDestination(e2->Destination());
-        e2 = path.erase(++e1, ++e2);
-        e1 = e2;
-        --e1;
+        unreachable = e1+step; break;
       }
+    }
+
+    while (unreachable - reachable > 1)
+    {
+      int mid = (reachable + unreachable) / 2;
 
+      if (m_pOwner->canWalkBetween(start, m_SmoothBuffer[mid].Destination()))
+      {
+        reachable = mid;
+      }
       else
       {
-        ++e2;
+        unreachable = mid;
       }
     }
 
-    ++e1;
+    PathEdge smoothed = m_SmoothBuffer[e1];
+
+    smoothed.SetDestination(m_SmoothBuffer[reachable].Destination());
+
+    m_SmoothBuffer[NumKept++] = smoothed;
+
+    e1 = reachable + 1;
+  }
+
+  CopySmoothedPath(path, NumKept);
+}
+
+//--------------------------- CopySmoothedPath --------------------------------
+//
+//  replaces the path with the first NumEdges edges of m_SmoothBuffer,
+//  reusing the path's elements rather than allocating new ones
+//-----------------------------------------------------------------------------
+void Raven_PathPlanner::CopySmoothedPath(Path& path, int NumEdges)const
+{
+  Path::iterator it = path.begin();
+
+  for (int i=0; i<NumEdges; ++i, ++it)
+  {
+    *it = m_SmoothBuffer[i];
   }
+
+  path.erase(it, path.end());
 }
 
 
@@ -251,6 +384,24 @@ int Raven_PathPlanner::CycleOnce()const
 
   int result = m_pCurrentSearch->CycleOnce();
 
+  SearchFinished(result);
+
+  return result;
+}
+
+//-------------------------- SearchFinished -----------------------------------
+//
+//  messages the owner with the result of the current search, if it has
+//  terminated
+//-----------------------------------------------------------------------------
+void Raven_PathPlanner::SearchFinished(int result)const
+{
+  //a flow field is complete whether or not it leads from the bot
+  if (m_pFieldSearch && result != search_incomplete)
+  {
+    m_pFieldSearch->HandOver();
+  }
+
   //let the bot know of the failure to find a path
   if (result == target_not_found)
   {
@@ -269,8 +420,42 @@ int Raven_PathPlanner::CycleOnce()const
     //represent a giver trigger. Consequently, it's worth passing the pointer
     //to the trigger in the extra info field of the message. (The pointer
     //will just be NULL if no trigger)
-    void* pTrigger = 
-    m_NavGraph.GetNode(m_pCurrentSearch->GetPathToTarget().back()).ExtraInfo();
+    std::list<int> nodes = m_pCurrentSearch->GetPathToTarget();
+
+    void* pTrigger = m_NavGraph.GetNode(nodes.back()).ExtraInfo();
+
+    if (m_pIncrementalSearch)
+    {
+      //a repair that leaves the path the bot is following as it was needn't
+      //disturb the bot. The bot is somewhere along that path, so the
+      //repaired path is the same if it's the remainder of it
+      bool bUnchanged = false;
+
+      if (m_bRepairing && nodes.size() <= m_DeliveredNodes.size())
+      {
+        std::list<int>::const_iterator it = m_DeliveredNodes.begin();
+
+        std::advance(it, m_DeliveredNodes.size() - nodes.size());
+
+        bUnchanged = std::equal(nodes.begin(), nodes.end(), it);
+      }
+
+      m_bRepairing = false;
+
+      if (bUnchanged) return;
+
+      m_DeliveredNodes = nodes;
+    }
+
+    //keep the path for any other bot that wants it
+    if (m_bCacheResult)
+    {
+      m_pOwner->GetWorld()->GetMap()->GetPathCache().Add(m_iSearchSource,
+                                                          nodes.back(),
+                                                          nodes,
+                                                          m_pCurrentSearch->GetPathAsPathEdges(),
+                                                          m_pCurrentSearch->GetCostToTarget());
+    }
 
     Dispatcher->DispatchMsg(SEND_MSG_IMMEDIATELY,
                             SENDER_ID_IRRELEVANT,
@@ -278,48 +463,22 @@ int Raven_PathPlanner::CycleOnce()const
                             Msg_PathReady,
                             pTrigger);
   }
-
-  return result;
 }
 
 //------------------------ GetClosestNodeToPosition ---------------------------
 //
-//  returns the index of the closest visible graph node to the given position
+//  returns the index of the closest visible graph node to the given position.
+//  The map's lookup grid hands out the nodes near the position closest
+//  first, so usually only one walk test is needed
 //-----------------------------------------------------------------------------
 int Raven_PathPlanner::GetClosestNodeToPosition(Vector2D pos)const
 {
-  double ClosestSoFar = MaxDouble;
-  int   ClosestNode  = no_closest_node_found;
-
-  //when the cell space is queried this the the range searched for neighboring
-  //graph nodes. This value is inversely proportional to the density of a 
-  //navigation graph (less dense = bigger values)
-  const double range = m_pOwner->GetWorld()->GetMap()->GetCellSpaceNeighborhoodRange();
+  const Raven_Bot* pOwner = m_pOwner;
 
-  //calculate the graph nodes that are neighboring this position
-  m_pOwner->GetWorld()->GetMap()->GetCellSpace()->CalculateNeighbors(pos, range);
-
-  //iterate through the neighbors and sum up all the position vectors
-  for (NodeType* pN = m_pOwner->GetWorld()->GetMap()->GetCellSpace()->begin();
-                 !m_pOwner->GetWorld()->GetMap()->GetCellSpace()->end();     
-                 pN = m_pOwner->GetWorld()->GetMap()->GetCellSpace()->next())
-  {
-    //if the path between this node and pos is unobstructed calculate the
-    //distance
-    if (m_pOwner->canWalkBetween(pos, pN->Pos()))
-    {
-      double dist = Vec2DDistanceSq(pos, pN->Pos());
+  int ClosestNode = m_pOwner->GetWorld()->GetMap()->GetNodeLookup().ClosestNode(pos,
+                        [pOwner](Vector2D from, Vector2D to){return pOwner->canWalkBetween(from, to);});
 
-      //keep a record of the closest so far
-      if (dist < ClosestSoFar)
-      {
-        ClosestSoFar = dist;
-        ClosestNode  = pN->Index();
-      }
-    }
-  }
-   
-  return ClosestNode;
+  return ClosestNode == invalid_node_index ? no_closest_node_found : ClosestNode;
 }
 
 //--------------------------- RequestPathToPosition ------------------------------
@@ -330,10 +489,13 @@ int Raven_PathPlanner::GetClosestNodeToPosition(Vector2D pos)const
 //
 //  If nodes are reachable from both positions then an instance of the time-
 //  sliced A* search is created and registered with the search manager. the
-//  method then returns true.
+//  method then returns true. (Unless the path can be had without searching,
+//  from the map's routing table, a flow field shared with the other bots
+//  heading the same way or the path cache)
 //        
 //-----------------------------------------------------------------------------
-bool Raven_PathPlanner::RequestPathToPosition(Vector2D TargetPos)
+bool Raven_PathPlanner::RequestPathToPosition(Vector2D        TargetPos,
+                                              search_priority priority)
 { 
   #ifdef SHOW_NAVINFO
     debug_con << "------------------------------------------------" << "";
@@ -343,6 +505,8 @@ bool Raven_PathPlanner::RequestPathToPosition(Vector2D TargetPos)
   //make a note of the target position.
   m_vDestinationPos = TargetPos;
 
+  SetPriority(priority);
+
   //if the target is walkable from the bot's position a path does not need to
   //be calculated, the bot can go straight to the position by ARRIVING at
   //the current waypoint
@@ -391,12 +555,95 @@ bool Raven_PathPlanner::RequestPathToPosition(Vector2D TargetPos)
     debug_con << "Closest node to target is " << ClosestNodeToTarget << "";
 #endif
 
-  //create an instance of a the distributed A* search class
-  typedef Graph_SearchAStar_TS<Raven_Map::NavGraph, Heuristic_Euclid> AStar;
+  const Raven_Map::NavHierarchy* pHierarchy = m_pOwner->GetWorld()->GetMap()->GetNavHierarchy();
+
+  //if shut doors have a cost the path is searched for incrementally so that
+  //it can be repaired as they open and shut (see DoorsChanged). The path
+  //cache isn't used, as its paths ignore the doors
+  if (script->Params().ClosedDoorCost > 0 && !pHierarchy &&
+      !m_pOwner->GetWorld()->GetPathManager()->isAsync())
+  {
+    m_pIncrementalSearch = new IncrementalSearch(m_SearchGraph,
+                                                 ClosestNodeToBot,
+                                                 ClosestNodeToTarget);
+
+    m_pCurrentSearch = m_pIncrementalSearch;
+
+    m_pOwner->GetWorld()->GetPathManager()->Register(this);
+
+    return true;
+  }
+
+  //on a small map the path is looked up in the map's routing table. (So
+  //the flow fields, the path cache and the landmark heuristic below are
+  //only used for paths to positions on maps too large for one)
+  if (AnswerFromRoutes(ClosestNodeToBot, ClosestNodeToTarget))
+  {
+    return true;
+  }
+
+  //if enough bots are heading for the same node they share a flow field
+  //leading there, and the path is read off it. The bot whose request calls
+  //for the field makes it, with a search the path manager runs like any
+  //other
+  Raven_Map::FlowFields& FlowFields = m_pOwner->GetWorld()->GetMap()->GetFlowFields();
+
+  bool bBuildField = false;
+
+  const Raven_Map::FlowFields::FlowField* pFlowField = FlowFields.Request(ClosestNodeToTarget,
+                                                                          m_pOwner->ID(),
+                                                                          bBuildField);
+
+  if (pFlowField && pFlowField->Cost(ClosestNodeToBot) < MaxDouble)
+  {
+    FollowField(*pFlowField, ClosestNodeToBot, Graph_SearchTimeSliced<EdgeType>::AStar);
+
+    return true;
+  }
+
+  if (bBuildField)
+  {
+    m_pFieldSearch   = FlowFields.NewFieldSearch(ClosestNodeToBot, ClosestNodeToTarget);
+    m_pCurrentSearch = m_pFieldSearch;
+
+    m_pOwner->GetWorld()->GetPathManager()->Register(this);
+
+    return true;
+  }
+
+  //another bot may already have found the path
+  if (AnswerFromCache(ClosestNodeToBot,
+                      ClosestNodeToTarget,
+                      Graph_SearchTimeSliced<EdgeType>::AStar))
+  {
+    return true;
+  }
+
+  //on a large map search the clustered navgraph, otherwise create an
+  //instance of a the distributed A* search class
+  if (pHierarchy)
+  {
+    typedef Graph_SearchHPA_TS<Raven_Map::FrozenNavGraph, Heuristic_ALT<Raven_Map::FrozenNavGraph> > HPAStar;
+
+    m_pCurrentSearch = new HPAStar(*pHierarchy,
+                                   ClosestNodeToBot,
+                                   ClosestNodeToTarget,
+                                   &m_pOwner->GetWorld()->GetPathManager()->GetAbstractWorkspacePool());
+  }
+  else
+  {
+    typedef Graph_SearchAStar_TS<Raven_Map::FrozenNavGraph, Heuristic_ALT<Raven_Map::FrozenNavGraph> > AStar;
    
-  m_pCurrentSearch = new AStar(m_NavGraph,
-                               ClosestNodeToBot,
-                               ClosestNodeToTarget);
+    m_pCurrentSearch = new AStar(m_SearchGraph,
+                                 ClosestNodeToBot,
+                                 ClosestNodeToTarget,
+                                 &m_pOwner->GetWorld()->GetPathManager()->GetWorkspacePool());
+
+    //(the hierarchical search only refines its path as the bot follows it,
+    //so there's no complete path of its to cache)
+    m_iSearchSource = ClosestNodeToBot;
+    m_bCacheResult  = true;
+  }
 
   //and register the search with the path manager
   m_pOwner->GetWorld()->GetPathManager()->Register(this);
@@ -405,18 +652,76 @@ bool Raven_PathPlanner::RequestPathToPosition(Vector2D TargetPos)
 }
 
 
+//------------------------------ DoorsChanged ---------------------------------
+//
+//  the search is moved on to the node the bot is now closest to, then told
+//  which nodes have edges through the doors that changed, and run again by
+//  the path manager. Only the part of the search the doors affect is redone.
+//  This is done whether or not the search has finished, as one that is still
+//  running would otherwise go on with the old door costs
+//-----------------------------------------------------------------------------
+void Raven_PathPlanner::DoorsChanged(const std::vector<int>& doors)
+{
+  if (!m_pIncrementalSearch) return;
+
+  bool bDelivered = !m_DeliveredNodes.empty();
+
+  //there's nothing to repair once the bot can see its destination
+  if (bDelivered && m_pOwner->canWalkTo(m_vDestinationPos)) return;
+
+  std::vector<int> nodes;
+
+  for (unsigned int d=0; d<doors.size(); ++d)
+  {
+    const std::vector<int>& DoorNodes = m_pOwner->GetWorld()->GetMap()->GetDoorNodes(doors[d]);
+
+    nodes.insert(nodes.end(), DoorNodes.begin(), DoorNodes.end());
+  }
+
+  if (nodes.empty()) return;
+
+  int ClosestNodeToBot = GetClosestNodeToPosition(m_pOwner->Pos());
+
+  if (ClosestNodeToBot != no_closest_node_found)
+  {
+    m_pIncrementalSearch->SetStart(ClosestNodeToBot);
+  }
+
+  m_pIncrementalSearch->EdgeCostsChanged(nodes);
+
+  //(a search that hasn't handed out a path yet has nothing to compare with)
+  m_bRepairing = bDelivered;
+
+  //this does nothing if the search is still registered
+  m_pOwner->GetWorld()->GetPathManager()->Register(this);
+}
+
+
+//------------------------------- AbandonPath ---------------------------------
+//-----------------------------------------------------------------------------
+void Raven_PathPlanner::AbandonPath(int PathID)
+{
+  if (PathID == m_iPathID) GetReadyForNewSearch();
+}
+
+
 //------------------------------ RequestPathToItem -----------------------------
 //
 // Given an item type, this method determines the closest reachable graph node
-// to the bot's position and then creates a instance of the time-sliced 
-// Dijkstra's algorithm, which it registers with the search manager
+// to the bot's position. The path from there to the nearest item is taken
+// from the map's field for the type if it can be, otherwise an instance of
+// the time-sliced Dijkstra's algorithm is created and registered with the
+// search manager
 //
 //-----------------------------------------------------------------------------
-bool Raven_PathPlanner::RequestPathToItem(unsigned int ItemType)
+bool Raven_PathPlanner::RequestPathToItem(unsigned int    ItemType,
+                                          search_priority priority)
 {    
   //clear the waypoint list and delete any active search
   GetReadyForNewSearch();
 
+  SetPriority(priority);
+
   //find the closest visible node to the bots position
   int ClosestNodeToBot = GetClosestNodeToPosition(m_pOwner->Pos());
 
@@ -433,13 +738,54 @@ bool Raven_PathPlanner::RequestPathToItem(unsigned int ItemType)
     return false; 
   }
 
+  //the map keeps the way to the nearest item of each type from every node
+  if (AnswerFromItemField(ClosestNodeToBot, ItemType))
+  {
+    return true;
+  }
+
+  //if paths from this node have been cached, one may lead to the item the
+  //search would find
+  if (m_pOwner->GetWorld()->GetMap()->GetPathCache().HasPathsFrom(ClosestNodeToBot))
+  {
+    int ItemNode = GetClosestActiveItemNode(ClosestNodeToBot, ItemType);
+
+    if (ItemNode != no_closest_node_found &&
+        AnswerFromCache(ClosestNodeToBot,
+                        ItemNode,
+                        Graph_SearchTimeSliced<EdgeType>::Dijkstra))
+    {
+      return true;
+    }
+  }
+
   //create an instance of the search algorithm
-  typedef FindActiveTrigger<Trigger<Raven_Bot> > t_con; 
-  typedef Graph_SearchDijkstras_TS<Raven_Map::NavGraph, t_con> DijSearch;
+  if (m_pOwner->GetWorld()->GetPathManager()->isAsync())
+  {
+    //the worker threads mustn't look at the triggers while the game is
+    //updating them, so the search is for the node of the item it would
+    //have found. (If there is no active item the search fails, as it would
+    //have)
+    typedef Graph_SearchDijkstras_TS<Raven_Map::FrozenNavGraph, FindNodeIndex> DijSearch;
+
+    m_pCurrentSearch = new DijSearch(m_SearchGraph,
+                                     ClosestNodeToBot,
+                                     GetClosestActiveItemNode(ClosestNodeToBot, ItemType),
+                                     &m_pOwner->GetWorld()->GetPathManager()->GetWorkspacePool());
+  }
+  else
+  {
+    typedef FindActiveTrigger<Trigger<Raven_Bot> > t_con; 
+    typedef Graph_SearchDijkstras_TS<Raven_Map::FrozenNavGraph, t_con> DijSearch;
   
-  m_pCurrentSearch = new DijSearch(m_NavGraph,
-                                   ClosestNodeToBot,
-                                   ItemType);  
+    m_pCurrentSearch = new DijSearch(m_SearchGraph,
+                                     ClosestNodeToBot,
+                                     ItemType,
+                                     &m_pOwner->GetWorld()->GetPathManager()->GetWorkspacePool());  
+  }
+
+  m_iSearchSource = ClosestNodeToBot;
+  m_bCacheResult  = true;
 
   //register the search with the path manager
   m_pOwner->GetWorld()->GetPathManager()->Register(this);
@@ -447,6 +793,190 @@ bool Raven_PathPlanner::RequestPathToItem(unsigned int ItemType)
   return true;
 }
 
+//------------------------------- SetPriority ---------------------------------
+//-----------------------------------------------------------------------------
+void Raven_PathPlanner::SetPriority(search_priority requested)
+{
+  m_iPriority = requested;
+
+  if (m_pOwner->isPossessed())
+  {
+    m_iPriority = priority_possessed;
+  }
+
+  else if (m_pOwner->isHit() && m_iPriority < priority_under_fire)
+  {
+    m_iPriority = priority_under_fire;
+  }
+}
+
+//----------------------------- SetSearchStats --------------------------------
+//-----------------------------------------------------------------------------
+void Raven_PathPlanner::SetSearchStats(const PathSearchStats& stats)
+{
+  m_LastSearchStats = stats;
+
+#ifdef SHOW_NAVINFO
+  debug_con << "Bot " << m_pOwner->ID() << " path request (priority " << stats.iPriority
+            << ") waited " << stats.dQueueLatency << "ms and took " << stats.dTotalLatency
+            << "ms over " << stats.iNumCycles << " cycles" << "";
+#endif
+}
+
+//------------------------------ AnswerFromCache ------------------------------
+//-----------------------------------------------------------------------------
+bool Raven_PathPlanner::AnswerFromCache(int                                         source,
+                                        int                                         target,
+                                        Graph_SearchTimeSliced<EdgeType>::SearchType type)
+{
+  const PathCache::CachedPath* pCached =
+                 m_pOwner->GetWorld()->GetMap()->GetPathCache().Find(source, target);
+
+  if (!pCached) return false;
+
+  m_pCurrentSearch = new Graph_CachedSearch_TS<EdgeType>(type,
+                                                         pCached->Nodes,
+                                                         pCached->Edges,
+                                                         pCached->dCost);
+
+  m_pOwner->GetWorld()->GetPathManager()->RegisterAnswered(this);
+
+  return true;
+}
+
+//------------------------- GetClosestActiveItemNode --------------------------
+//
+//  finds the item a search for ItemType would terminate at (see
+//  FindActiveTrigger). That's the nearest in the map's field for the type
+//  unless an item belonging to a team is nearer
+//-----------------------------------------------------------------------------
+int Raven_PathPlanner::GetClosestActiveItemNode(int nd, unsigned int ItemType)const
+{
+  double ClosestSoFar = MaxDouble;
+  int    ClosestNode  = no_closest_node_found;
+
+  const Raven_Map::ItemField* pField = m_pOwner->GetWorld()->GetMap()->GetItemField(ItemType);
+
+  if (pField && pField->NearestSource(nd) != invalid_node_index)
+  {
+    ClosestSoFar = pField->Cost(nd);
+    ClosestNode  = pField->NearestSource(nd);
+  }
+
+  const std::vector<Raven_Map::TriggerType*>& TeamItems = m_pOwner->GetWorld()->GetMap()->GetTeamItems();
+
+  for (unsigned int i=0; i<TeamItems.size(); ++i)
+  {
+    if ( (TeamItems[i]->EntityType() == ItemType) && TeamItems[i]->isActive() &&
+         (m_NavGraph.GetNode(TeamItems[i]->GraphNodeIndex()).ExtraInfo() == TeamItems[i]) )
+    {
+      double cost = m_pOwner->GetWorld()->GetMap()->CalculateCostToTravelBetweenNodes(nd,
+                                                             TeamItems[i]->GraphNodeIndex());
+
+      if (cost < ClosestSoFar)
+      {
+        ClosestSoFar = cost;
+        ClosestNode  = TeamItems[i]->GraphNodeIndex();
+      }
+    }
+  }
+
+  return ClosestNode;
+}
+
+//------------------------------ AnswerFromRoutes ----------------------------
+//
+//  the path is built a step at a time from the next node on the way to the
+//  target from each node
+//-----------------------------------------------------------------------------
+bool Raven_PathPlanner::AnswerFromRoutes(int source, int target)
+{
+  const Raven_Map::Routes* pRoutes = m_pOwner->GetWorld()->GetMap()->GetRoutes();
+
+  //(if there's no path the search is left to report it)
+  if (!pRoutes || pRoutes->NextHop(source, target) == invalid_node_index) return false;
+
+  std::list<int> nodes;
+  Path           edges;
+  double         cost = 0;
+
+  nodes.push_back(source);
+
+  for (const EdgeType* pE = pRoutes->NextEdge(source, target); pE; pE = pRoutes->NextEdge(pE->To(), target))
+  {
+    edges.push_back(PathEdge(m_SearchGraph.GetNode(pE->From()).Pos(),
+                             m_SearchGraph.GetNode(pE->To()).Pos(),
+                             pE->Flags(),
+                             pE->IDofIntersectingEntity()));
+
+    nodes.push_back(pE->To());
+
+    cost += pE->Cost();
+  }
+
+  m_pCurrentSearch = new Graph_CachedSearch_TS<EdgeType>(Graph_SearchTimeSliced<EdgeType>::AStar,
+                                                         nodes,
+                                                         edges,
+                                                         cost);
+
+  m_pOwner->GetWorld()->GetPathManager()->RegisterAnswered(this);
+
+  return true;
+}
+
+//----------------------------- AnswerFromItemField ---------------------------
+//-----------------------------------------------------------------------------
+bool Raven_PathPlanner::AnswerFromItemField(int source, unsigned int ItemType)
+{
+  const Raven_Map::ItemField* pField = m_pOwner->GetWorld()->GetMap()->GetItemField(ItemType);
+
+  if (!pField) return false;
+
+  //the search would find an item belonging to a team if one were nearer
+  int ItemNode = GetClosestActiveItemNode(source, ItemType);
+
+  if (ItemNode == no_closest_node_found || ItemNode != pField->NearestSource(source))
+  {
+    return false;
+  }
+
+  FollowField(*pField, source, Graph_SearchTimeSliced<EdgeType>::Dijkstra);
+
+  return true;
+}
+
+//------------------------------- FollowField ---------------------------------
+//
+//  the path is read off the field by following the next edge from each
+//  node, so no search is needed
+//-----------------------------------------------------------------------------
+void Raven_PathPlanner::FollowField(const DistanceField<Raven_Map::FrozenNavGraph>& field,
+                                    int                                         source,
+                                    Graph_SearchTimeSliced<EdgeType>::SearchType type)
+{
+  std::list<int> nodes;
+  Path           edges;
+
+  nodes.push_back(source);
+
+  for (const EdgeType* pE = field.NextEdge(source); pE; pE = field.NextEdge(pE->To()))
+  {
+    edges.push_back(PathEdge(m_SearchGraph.GetNode(pE->From()).Pos(),
+                             m_SearchGraph.GetNode(pE->To()).Pos(),
+                             pE->Flags(),
+                             pE->IDofIntersectingEntity()));
+
+    nodes.push_back(pE->To());
+  }
+
+  m_pCurrentSearch = new Graph_CachedSearch_TS<EdgeType>(type,
+                                                         nodes,
+                                                         edges,
+                                                         field.Cost(source));
+
+  m_pOwner->GetWorld()->GetPathManager()->RegisterAnswered(this);
+}
+
 //------------------------------ GetNodePosition ------------------------------
 //
 //  used to retrieve the position of a graph node from its index. (takes
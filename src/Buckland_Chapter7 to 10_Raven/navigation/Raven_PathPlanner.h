@@ -10,10 +10,12 @@
 //  Desc:   class to handle the creation of paths through a navigation graph
 //-----------------------------------------------------------------------------
 #include <list>
+#include <vector>
 #include "TimeSlicedGraphAlgorithms.h"
 #include "Graph/GraphAlgorithms.h"
 #include "Graph/SparseGraph.h"
 #include "PathEdge.h"
+#include "PathManager.h"
 #include "../Raven_Map.h"
 
 class Raven_Bot;
@@ -32,7 +34,22 @@ public:
   //for ease of use typdef the graph edge/node types used by the navgraph
   typedef Raven_Map::NavGraph::EdgeType           EdgeType;
   typedef Raven_Map::NavGraph::NodeType           NodeType;
+  typedef Raven_Map::NavHierarchy::AbstractEdge   AbstractEdgeType;
   typedef std::list<PathEdge>                     Path;
+
+  //the search used for paths to positions when closed doors have a cost
+  typedef Graph_SearchDStarLite_TS<Raven_Map::FrozenNavGraph,
+                                   Heuristic_ALT<Raven_Map::FrozenNavGraph>,
+                                   EdgeCost_Doors<EdgeType> >  IncrementalSearch;
+
+  //the priorities of path requests, lowest first (see PathManager)
+  enum search_priority
+  {
+    priority_explore,
+    priority_normal,
+    priority_under_fire,
+    priority_possessed
+  };
   
 private:
 
@@ -42,29 +59,105 @@ private:
   //a reference to the navgraph
   const Raven_Map::NavGraph&          m_NavGraph;
 
+  //and to the frozen copy of it the searches are run on
+  const Raven_Map::FrozenNavGraph&    m_SearchGraph;
+
   //a pointer to an instance of the current graph search algorithm.
   Graph_SearchTimeSliced<EdgeType>*  m_pCurrentSearch;
   
   //this is the position the bot wishes to plan a path to reach
   Vector2D                            m_vDestinationPos;
 
+  //incremented with every new search, so a path can be matched with the
+  //search that produced it (see ExtendPath)
+  int                                 m_iPathID;
+
+  //the node the current search started from, and whether its result
+  //should be added to the map's path cache when it completes
+  int                                 m_iSearchSource;
+  bool                                m_bCacheResult;
+
+  //the current search if it's an incremental one (it is also
+  //m_pCurrentSearch), which is repaired as the doors open and shut
+  IncrementalSearch*                  m_pIncrementalSearch;
+
+  //the nodes of the last path the incremental search handed the bot, and
+  //whether the search is now being repaired. A repaired path is only
+  //handed out if it differs from what remains of that one
+  mutable std::list<int>              m_DeliveredNodes;
+  mutable bool                        m_bRepairing;
+
+  //the current search if it's making a flow field for the map's cache (it
+  //is also m_pCurrentSearch). The field is handed to the cache when the
+  //search completes
+  Raven_Map::FlowFields::FieldSearch* m_pFieldSearch;
+
+  //the priority of the current request
+  int                                 m_iPriority;
+
+  //the timings of the last request to complete
+  PathSearchStats                     m_LastSearchStats;
+
+  //scratch storage for the path smoothers, kept between paths so that
+  //smoothing doesn't allocate
+  std::vector<PathEdge>               m_SmoothBuffer;
+  std::vector<int>                    m_SmoothRunEnd;
+
+  //sets m_iPriority from the priority asked for, raised if the bot is
+  //possessed or under fire
+  void  SetPriority(search_priority requested);
+
 
   //returns the index of the closest visible and unobstructed graph node to
   //the given position
   int   GetClosestNodeToPosition(Vector2D pos)const;
 
+  //adds the final edge to the destination if the current search is
+  //complete and was for a position, then smooths the path as set by the
+  //user options
+  void  FinishPath(Path& path);
+
   //smooths a path by removing extraneous edges. (may not remove all
   //extraneous edges)
   void  SmoothPathEdgesQuick(Path& path);
 
-  //smooths a path by removing extraneous edges. (removes *all* extraneous
-  //edges)
+  //smooths a path by removing extraneous edges. (removes nearly all
+  //extraneous edges)
   void  SmoothPathEdgesPrecise(Path& path);
 
+  //replaces the path with the first NumEdges edges of m_SmoothBuffer
+  void  CopySmoothedPath(Path& path, int NumEdges)const;
+
   //called at the commencement of a new search request. It clears up the 
   //appropriate lists and memory in preparation for a new search request
   void  GetReadyForNewSearch();
 
+  //if the map's path cache holds a path from source to target this makes
+  //it the result of the current request, registers the request with the
+  //path manager as already answered and returns true
+  bool  AnswerFromCache(int source, int target, Graph_SearchTimeSliced<EdgeType>::SearchType type);
+
+  //returns the node of the active item of the given type with the cheapest
+  //path from nd, or no_closest_node_found if there isn't one
+  int   GetClosestActiveItemNode(int nd, unsigned int ItemType)const;
+
+  //if the map has a routing table this makes the path it gives from source
+  //to target the result of the current request, registers the request with
+  //the path manager as already answered and returns true
+  bool  AnswerFromRoutes(int source, int target);
+
+  //if the map's field for ItemType leads from source to the item a search
+  //would find this makes that path the result of the current request,
+  //registers the request as already answered and returns true
+  bool  AnswerFromItemField(int source, unsigned int ItemType);
+
+  //makes the path from source that the field leads along the result of the
+  //current request, and registers the request with the path manager as
+  //already answered
+  void  FollowField(const DistanceField<Raven_Map::FrozenNavGraph>& field,
+                    int                                         source,
+                    Graph_SearchTimeSliced<EdgeType>::SearchType type);
+
 
 
 public:
@@ -75,11 +168,13 @@ public:
 
   //creates an instance of the A* time-sliced search and registers it with
   //the path manager
-  bool       RequestPathToItem(unsigned int ItemType);
+  bool       RequestPathToItem(unsigned int    ItemType,
+                                search_priority priority = priority_normal);
 
   //creates an instance of the Dijkstra's time-sliced search and registers 
   //it with the path manager
-  bool       RequestPathToPosition(Vector2D TargetPos);
+  bool       RequestPathToPosition(Vector2D        TargetPos,
+                                    search_priority priority = priority_normal);
 
   //called by an agent after it has been notified that a search has terminated
   //successfully. The method extracts the path from m_pCurrentSearch, adds
@@ -87,6 +182,22 @@ public:
   //PathEdges.
   Path       GetPath();
 
+  //a hierarchical search hands out its path a cluster at a time. If the
+  //current search has the ID PathID and there is more of its path to come
+  //this appends the next piece to path. Returns false if the rest of the
+  //path couldn't be found, in which case the path stops short of its
+  //destination and should be abandoned
+  bool       ExtendPath(Path& path, int PathID);
+
+  int        GetPathID()const{return m_iPathID;}
+
+  //called by a goal that requested a path when it's done with it. If the
+  //request with the ID PathID is still the current one its search is
+  //stopped and deleted, so it can't send the bot any more paths (an
+  //incremental search would otherwise go on being repaired as the doors
+  //open and shut)
+  void       AbandonPath(int PathID);
+
   //returns the cost to travel from the bot's current position to a specific 
   //graph node. This method makes use of the pre-calculated lookup table
   //created by Raven_Game
@@ -104,6 +215,24 @@ public:
   //msg_PathReady messages
   int        CycleOnce()const;
 
+  //messages the owner as above once the current search has terminated with
+  //the given result. Called directly by the path manager when the search
+  //was run by one of its worker threads
+  void       SearchFinished(int result)const;
+
+  Graph_SearchTimeSliced<EdgeType>* GetSearch()const{return m_pCurrentSearch;}
+
+  //used by the path manager to schedule the request and report on it
+  int        GetSearchPriority()const{return m_iPriority;}
+  void       SetSearchStats(const PathSearchStats& stats);
+
+  const PathSearchStats& GetLastSearchStats()const{return m_LastSearchStats;}
+
+  //called when the given doors have opened or shut. If the current path
+  //was found by an incremental search the search is repaired, and if the
+  //best path has changed the bot is sent the new one
+  void       DoorsChanged(const std::vector<int>& doors);
+
   Vector2D   GetDestination()const{return m_vDestinationPos;}
   void       SetDestination(Vector2D NewPos){m_vDestinationPos = NewPos;}
 
@@ -0,0 +1,200 @@
+#ifndef SEARCH_WORKSPACE_H
+#define SEARCH_WORKSPACE_H
+#pragma warning (disable:4786)
+//-----------------------------------------------------------------------------
+//
+//  Name:   SearchWorkspace.h
+//
+//  Desc:   the per-node bookkeeping of a time-sliced A* or Dijkstra search
+//          (costs, shortest path tree, frontier and priority queue), kept
+//          apart from the search so it can be reused by the next one.
+//
+//          Each node's entries are stamped with the generation of the search
+//          that wrote them. Starting a new search just increments the
+//          generation, which invalidates every entry at once, so a reset is
+//          O(1) rather than O(NumNodes). An entry whose stamp is out of date
+//          reads as it would in a freshly constructed search (zero costs,
+//          no edges).
+//
+//          SearchWorkspacePool keeps the workspaces of finished searches for
+//          the next ones, so once the pool has warmed up, starting a search
+//          allocates nothing however large the graph.
+//-----------------------------------------------------------------------------
+#include <vector>
+#include <algorithm>
+#include <cassert>
+
+#include "misc/PriorityQueue.h"
+
+
+template <class edge_type>
+class SearchWorkspace
+{
+private:
+
+  //the generation each node's entries were written in
+  std::vector<unsigned int>        m_Stamps;
+  unsigned int                     m_iGeneration;
+
+  std::vector<double>              m_GCosts;
+
+  //the priority queue is keyed on these. A* stores G+H here and Dijkstra
+  //stores G
+  std::vector<double>              m_FCosts;
+
+  std::vector<const edge_type*>    m_ShortestPathTree;
+  std::vector<const edge_type*>    m_SearchFrontier;
+
+  IndexedPriorityQLow<double>*     m_pPQ;
+
+  int                              m_iNumNodes;
+
+  SearchWorkspace(const SearchWorkspace&);
+  SearchWorkspace& operator=(const SearchWorkspace&);
+
+public:
+
+  SearchWorkspace():m_iGeneration(0), m_pPQ(NULL), m_iNumNodes(0){}
+
+  ~SearchWorkspace(){delete m_pPQ;}
+
+  //readies the workspace for a search of a graph of NumNodes nodes. Only
+  //grows the storage if the graph is larger than any searched before
+  void Reset(int NumNodes)
+  {
+    if (NumNodes > (int)m_Stamps.size())
+    {
+      m_Stamps.resize(NumNodes, 0);
+      m_GCosts.resize(NumNodes);
+      m_FCosts.resize(NumNodes);
+      m_ShortestPathTree.resize(NumNodes);
+      m_SearchFrontier.resize(NumNodes);
+
+      delete m_pPQ;
+      m_pPQ = new IndexedPriorityQLow<double>(m_FCosts, NumNodes);
+    }
+
+    m_iNumNodes = NumNodes;
+
+    m_pPQ->clear();
+
+    //when the generation wraps round the stamps have to be cleared for real
+    if (++m_iGeneration == 0)
+    {
+      std::fill(m_Stamps.begin(), m_Stamps.end(), 0);
+
+      m_iGeneration = 1;
+    }
+  }
+
+  int  NumNodes()const{return m_iNumNodes;}
+
+  //true if the node has been written to by the current search
+  bool isTouched(int nd)const{return m_Stamps[nd] == m_iGeneration;}
+
+  //gives the node fresh entries for the current search
+  void Touch(int nd)
+  {
+    m_Stamps[nd]           = m_iGeneration;
+    m_GCosts[nd]           = 0.0;
+    m_FCosts[nd]           = 0.0;
+    m_ShortestPathTree[nd] = NULL;
+    m_SearchFrontier[nd]   = NULL;
+  }
+
+  double           GCost(int nd)const{return isTouched(nd) ? m_GCosts[nd] : 0.0;}
+  double           FCost(int nd)const{return isTouched(nd) ? m_FCosts[nd] : 0.0;}
+  const edge_type* SPT(int nd)const{return isTouched(nd) ? m_ShortestPathTree[nd] : NULL;}
+  const edge_type* Frontier(int nd)const{return isTouched(nd) ? m_SearchFrontier[nd] : NULL;}
+
+  //these may only be used on a node that has been touched
+  void SetGCost(int nd, double cost){assert(isTouched(nd)); m_GCosts[nd] = cost;}
+  void SetFCost(int nd, double cost){assert(isTouched(nd)); m_FCosts[nd] = cost;}
+  void SetSPT(int nd, const edge_type* pE){assert(isTouched(nd)); m_ShortestPathTree[nd] = pE;}
+  void SetFrontier(int nd, const edge_type* pE){assert(isTouched(nd)); m_SearchFrontier[nd] = pE;}
+
+  IndexedPriorityQLow<double>& PQ(){return *m_pPQ;}
+
+  //the shortest path tree as a vector indexed by node
+  std::vector<const edge_type*> GetSPT()const
+  {
+    std::vector<const edge_type*> spt(m_iNumNodes);
+
+    for (int nd=0; nd<m_iNumNodes; ++nd) spt[nd] = SPT(nd);
+
+    return spt;
+  }
+};
+
+
+//---------------------------- SearchWorkspacePool ----------------------------
+//
+//  hands out workspaces and takes them back when a search is done with them.
+//  Every workspace acquired must be released before the pool is destroyed
+//-----------------------------------------------------------------------------
+template <class edge_type>
+class SearchWorkspacePool
+{
+public:
+
+  typedef SearchWorkspace<edge_type> Workspace;
+
+private:
+
+  std::vector<Workspace*>  m_Free;
+
+  //the number of workspaces currently acquired
+  int                      m_iNumInUse;
+
+  SearchWorkspacePool(const SearchWorkspacePool&);
+  SearchWorkspacePool& operator=(const SearchWorkspacePool&);
+
+public:
+
+  SearchWorkspacePool():m_iNumInUse(0){}
+
+  ~SearchWorkspacePool()
+  {
+    assert (m_iNumInUse == 0 && "<SearchWorkspacePool::dtor>: workspaces still in use");
+
+    for (unsigned int w=0; w<m_Free.size(); ++w) delete m_Free[w];
+  }
+
+  //returns a workspace reset for a graph of NumNodes nodes
+  Workspace* Acquire(int NumNodes)
+  {
+    Workspace* pWorkspace;
+
+    if (m_Free.empty())
+    {
+      pWorkspace = new Workspace();
+    }
+    else
+    {
+      pWorkspace = m_Free.back();
+
+      m_Free.pop_back();
+    }
+
+    pWorkspace->Reset(NumNodes);
+
+    ++m_iNumInUse;
+
+    return pWorkspace;
+  }
+
+  void Release(Workspace* pWorkspace)
+  {
+    assert (pWorkspace && m_iNumInUse > 0 && "<SearchWorkspacePool::Release>: bad release");
+
+    --m_iNumInUse;
+
+    m_Free.push_back(pWorkspace);
+  }
+
+  int NumInUse()const{return m_iNumInUse;}
+  int NumFree()const{return (int)m_Free.size();}
+};
+
+
+#endif
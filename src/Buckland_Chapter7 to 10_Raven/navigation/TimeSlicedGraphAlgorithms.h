@@ -18,12 +18,16 @@
 #include <list>
 #include <queue>
 #include <stack>
+#include <functional>
 
 #include "graph/SparseGraph.h"
 #include "misc/PriorityQueue.h"
 #include "Graph/AStarHeuristicPolicies.h"
 #include "SearchTerminationPolicies.h"
+#include "EdgeCostPolicies.h"
 #include "PathEdge.h"
+#include "SearchWorkspace.h"
+#include "Graph/HierarchicalGraph.h"
 
 
 
@@ -73,6 +77,18 @@ public:
   //returns the path as a list of PathEdges
   virtual std::list<PathEdge>           GetPathAsPathEdges()const=0;
 
+  //a search may hand out its path a piece at a time (see
+  //Graph_SearchHPA_TS). If so, this returns true while there are pieces
+  //left that GetPathAsPathEdges didn't return...
+  virtual bool                          HasUnrefinedPath()const{return false;}
+
+  //...and this appends the next of them to path
+  virtual void                          RefineNextSegment(std::list<PathEdge>& path){}
+
+  //true if a piece of the path could not be refined (the graph has changed
+  //under the search). The path handed out then stops short of the target
+  virtual bool                          RefinementFailed()const{return false;}
+
   SearchType                            GetType()const{return m_SearchType;}
 };
 
@@ -82,6 +98,10 @@ public:
 //-------------------------- Graph_SearchAStar_TS -----------------------------
 //
 //  a A* class that enables a search to be completed over multiple update-steps
+//
+//  The search's per-node data is held in a SearchWorkspace. If a pool is
+//  given to the constructor the workspace is taken from it and given back
+//  when the search is deleted, otherwise the search creates its own.
 //-----------------------------------------------------------------------------
 template <class graph_type, class heuristic>
 class Graph_SearchAStar_TS : public Graph_SearchTimeSliced<typename graph_type::EdgeType>
@@ -92,51 +112,58 @@ private:
   typedef typename graph_type::EdgeType Edge;
   typedef typename graph_type::NodeType Node;
 
+  typedef SearchWorkspacePool<Edge>     WorkspacePool;
+  typedef SearchWorkspace<Edge>         Workspace;
+
 private:
 
   const graph_type&              m_Graph;
 
-  //indexed into my node. Contains the 'real' accumulative cost to that node
-  std::vector<double>            m_GCosts; 
-
-  //indexed into by node. Contains the cost from adding m_GCosts[n] to
-  //the heuristic cost from n to the target node. This is the vector the
-  //iPQ indexes into.
-  std::vector<double>            m_FCosts;
+  //holds the G and F costs, the SPT, the search frontier and the PQ (which
+  //is keyed on the F costs)
+  Workspace*                     m_pWorkspace;
 
-  std::vector<const Edge*>       m_ShortestPathTree;
-  std::vector<const Edge*>       m_SearchFrontier;
+  //the pool the workspace came from (NULL if the search owns it)
+  WorkspacePool*                 m_pPool;
 
   int                            m_iSource;
   int                            m_iTarget;
 
-  //create an indexed priority queue of nodes. The nodes with the
-  //lowest overall F cost (G+H) are positioned at the front.
-  IndexedPriorityQLow<double>*    m_pPQ;
-
  
 public:
 
   Graph_SearchAStar_TS(const graph_type& G,
                       int                source,
-                      int                target):Graph_SearchTimeSliced<Edge>(AStar),
+                      int                target,
+                      WorkspacePool*     pPool = NULL):Graph_SearchTimeSliced<Edge>(AStar),
   
                                               m_Graph(G),
-                                              m_ShortestPathTree(G.NumNodes()),                              
-                                              m_SearchFrontier(G.NumNodes()),
-                                              m_GCosts(G.NumNodes(), 0.0),
-                                              m_FCosts(G.NumNodes(), 0.0),
+                                              m_pPool(pPool),
                                               m_iSource(source),
                                               m_iTarget(target)
   { 
-     //create the PQ   
-     m_pPQ =new IndexedPriorityQLow<double>(m_FCosts, m_Graph.NumNodes());
+    if (m_pPool)
+    {
+      m_pWorkspace = m_pPool->Acquire(G.NumNodes());
+    }
+    else
+    {
+      m_pWorkspace = new Workspace();
+
+      m_pWorkspace->Reset(G.NumNodes());
+    }
 
     //put the source node on the queue
-    m_pPQ->insert(m_iSource);
+    m_pWorkspace->Touch(m_iSource);
+
+    m_pWorkspace->PQ().insert(m_iSource);
   }
 
-   ~Graph_SearchAStar_TS(){delete m_pPQ;}
+  ~Graph_SearchAStar_TS()
+  {
+    if (m_pPool) m_pPool->Release(m_pWorkspace);
+    else         delete m_pWorkspace;
+  }
 
 
   //When called, this method pops the next node off the PQ and examines all
@@ -145,7 +172,7 @@ public:
   int                      CycleOnce();
 
   //returns the vector of edges that the algorithm has examined
-  std::vector<const Edge*> GetSPT()const{return m_ShortestPathTree;}
+  std::vector<const Edge*> GetSPT()const{return m_pWorkspace->GetSPT();}
 
   //returns a vector of node indexes that comprise the shortest path
   //from the source to the target
@@ -155,24 +182,26 @@ public:
   std::list<PathEdge>    GetPathAsPathEdges()const;
 
   //returns the total cost to the target
-  double            GetCostToTarget()const{return m_GCosts[m_iTarget];}
+  double            GetCostToTarget()const{return m_pWorkspace->GCost(m_iTarget);}
 };
 
 //-----------------------------------------------------------------------------
 template <class graph_type, class heuristic>
 int Graph_SearchAStar_TS<graph_type, heuristic>::CycleOnce()
 {
+  Workspace& ws = *m_pWorkspace;
+
   //if the PQ is empty the target has not been found
-  if (m_pPQ->empty())
+  if (ws.PQ().empty())
   {
     return target_not_found;
   }
 
   //get lowest cost node from the queue
-  int NextClosestNode = m_pPQ->Pop();
+  int NextClosestNode = ws.PQ().Pop();
 
   //put the node on the SPT
-  m_ShortestPathTree[NextClosestNode] = m_SearchFrontier[NextClosestNode];
+  ws.SetSPT(NextClosestNode, ws.Frontier(NextClosestNode));
 
   //if the target has been found exit
   if (NextClosestNode == m_iTarget)
@@ -186,35 +215,39 @@ int Graph_SearchAStar_TS<graph_type, heuristic>::CycleOnce()
       !ConstEdgeItr.end();
        pE=ConstEdgeItr.next())
   {
+    int to = pE->To();
+
     //calculate the heuristic cost from this node to the target (H)                       
-    double HCost = heuristic::Calculate(m_Graph, m_iTarget, pE->To()); 
+    double HCost = heuristic::Calculate(m_Graph, m_iTarget, to); 
 
     //calculate the 'real' cost to this node from the source (G)
-    double GCost = m_GCosts[NextClosestNode] + pE->Cost();
+    double GCost = ws.GCost(NextClosestNode) + pE->Cost();
 
-    //if the node has not been added to the frontier, add it and update
-    //the G and F costs
-    if (m_SearchFrontier[pE->To()] == NULL)
+    //if the node has not been reached by this search yet, add it to the
+    //frontier and set its G and F costs
+    if (!ws.isTouched(to))
     {
-      m_FCosts[pE->To()] = GCost + HCost;
-      m_GCosts[pE->To()] = GCost;
+      ws.Touch(to);
+
+      ws.SetFCost(to, GCost + HCost);
+      ws.SetGCost(to, GCost);
 
-      m_pPQ->insert(pE->To());
+      ws.PQ().insert(to);
 
-      m_SearchFrontier[pE->To()] = pE;
+      ws.SetFrontier(to, pE);
     }
 
     //if this node is already on the frontier but the cost to get here
     //is cheaper than has been found previously, update the node
     //costs and frontier accordingly.
-    else if ((GCost < m_GCosts[pE->To()]) && (m_ShortestPathTree[pE->To()]==NULL))
+    else if ((GCost < ws.GCost(to)) && (ws.SPT(to)==NULL) && (to != m_iSource))
     {
-      m_FCosts[pE->To()] = GCost + HCost;
-      m_GCosts[pE->To()] = GCost;
+      ws.SetFCost(to, GCost + HCost);
+      ws.SetGCost(to, GCost);
 
-      m_pPQ->ChangePriority(pE->To());
+      ws.PQ().ChangePriority(to);
 
-      m_SearchFrontier[pE->To()] = pE;
+      ws.SetFrontier(to, pE);
     }
   }
   
@@ -236,9 +269,9 @@ Graph_SearchAStar_TS<graph_type, heuristic>::GetPathToTarget()const
 
   path.push_back(nd);
     
-  while ((nd != m_iSource) && (m_ShortestPathTree[nd] != 0))
+  while ((nd != m_iSource) && (m_pWorkspace->SPT(nd) != 0))
   {
-    nd = m_ShortestPathTree[nd]->From();
+    nd = m_pWorkspace->SPT(nd)->From();
 
     path.push_front(nd);
   }
@@ -262,14 +295,16 @@ Graph_SearchAStar_TS<graph_type, heuristic>::GetPathAsPathEdges()const
 
   int nd = m_iTarget;
     
-  while ((nd != m_iSource) && (m_ShortestPathTree[nd] != 0))
+  while ((nd != m_iSource) && (m_pWorkspace->SPT(nd) != 0))
   {
-    path.push_front(PathEdge(m_Graph.GetNode(m_ShortestPathTree[nd]->From()).Pos(),
-                             m_Graph.GetNode(m_ShortestPathTree[nd]->To()).Pos(),
-                             m_ShortestPathTree[nd]->Flags(),
-                             m_ShortestPathTree[nd]->IDofIntersectingEntity()));
+    const Edge* pE = m_pWorkspace->SPT(nd);
 
-    nd = m_ShortestPathTree[nd]->From();
+    path.push_front(PathEdge(m_Graph.GetNode(pE->From()).Pos(),
+                             m_Graph.GetNode(pE->To()).Pos(),
+                             pE->Flags(),
+                             pE->IDofIntersectingEntity()));
+
+    nd = pE->From();
   }
 
   return path;
@@ -278,7 +313,8 @@ Graph_SearchAStar_TS<graph_type, heuristic>::GetPathAsPathEdges()const
 //-------------------------- Graph_SearchDijkstras_TS -------------------------
 //
 //  Dijkstra's algorithm class modified to spread a search over multiple
-//  update-steps
+//  update-steps. Its per-node data is held in a SearchWorkspace in the same
+//  way as Graph_SearchAStar_TS's.
 //-----------------------------------------------------------------------------
 template <class graph_type, class termination_condition>
 class Graph_SearchDijkstras_TS : public Graph_SearchTimeSliced<typename graph_type::EdgeType>
@@ -289,51 +325,58 @@ private:
   typedef typename graph_type::EdgeType Edge;
   typedef typename graph_type::NodeType Node;
 
+  typedef SearchWorkspacePool<Edge>     WorkspacePool;
+  typedef SearchWorkspace<Edge>         Workspace;
+
 private:
 
-  const graph_type&                   m_Graph;
+  const graph_type&              m_Graph;
 
-  //indexed into my node. Contains the accumulative cost to that node
-  std::vector<double>             m_CostToThisNode; 
+  //holds the cost to each node (as the G costs, which the PQ is keyed on
+  //through the F costs), the SPT, the search frontier and the PQ
+  Workspace*                     m_pWorkspace;
 
-  std::vector<const Edge*>  m_ShortestPathTree;
-  std::vector<const Edge*>  m_SearchFrontier;
+  //the pool the workspace came from (NULL if the search owns it)
+  WorkspacePool*                 m_pPool;
 
   int                            m_iSource;
   int                            m_iTarget;
 
-  //create an indexed priority queue of nodes. The nodes with the
-  //lowest overall F cost (G+H) are positioned at the front.
-  IndexedPriorityQLow<double>*     m_pPQ;
-
  
 
 public:
 
   Graph_SearchDijkstras_TS(const graph_type&  G,
                           int                   source,
-                          int                   target):Graph_SearchTimeSliced<Edge>(Dijkstra),
+                          int                   target,
+                          WorkspacePool*        pPool = NULL):Graph_SearchTimeSliced<Edge>(Dijkstra),
   
                                               m_Graph(G),
-                                              m_ShortestPathTree(G.NumNodes()),                              
-                                              m_SearchFrontier(G.NumNodes()),
-                                              m_CostToThisNode(G.NumNodes(), 0.0),
+                                              m_pPool(pPool),
                                               m_iSource(source),
                                               m_iTarget(target)
   { 
-     //create the PQ         ,
-     m_pPQ =new IndexedPriorityQLow<double>(m_CostToThisNode, m_Graph.NumNodes());
+    if (m_pPool)
+    {
+      m_pWorkspace = m_pPool->Acquire(G.NumNodes());
+    }
+    else
+    {
+      m_pWorkspace = new Workspace();
+
+      m_pWorkspace->Reset(G.NumNodes());
+    }
 
     //put the source node on the queue
-    m_pPQ->insert(m_iSource);
+    m_pWorkspace->Touch(m_iSource);
+
+    m_pWorkspace->PQ().insert(m_iSource);
   }
 
-  //let the search class take care of tidying up memory (the wary amongst
-  //you may prefer to use std::auto_ptr or similar to replace the pointer
-  //to the termination condition)
    ~Graph_SearchDijkstras_TS()
    {
-     delete m_pPQ;
+     if (m_pPool) m_pPool->Release(m_pWorkspace);
+     else         delete m_pWorkspace;
    }
 
 
@@ -343,7 +386,7 @@ public:
   int              CycleOnce();
 
   //returns the vector of edges that the algorithm has examined
-  std::vector<const Edge*> GetSPT()const{return m_ShortestPathTree;}
+  std::vector<const Edge*> GetSPT()const{return m_pWorkspace->GetSPT();}
 
   //returns a vector of node indexes that comprise the shortest path
   //from the source to the target
@@ -353,24 +396,26 @@ public:
   std::list<PathEdge>    GetPathAsPathEdges()const;
 
   //returns the total cost to the target
-  double            GetCostToTarget()const{return m_CostToThisNode[m_iTarget];}
+  double            GetCostToTarget()const{return m_pWorkspace->GCost(m_iTarget);}
 };
 
 //-----------------------------------------------------------------------------
 template <class graph_type, class termination_condition>
 int Graph_SearchDijkstras_TS<graph_type, termination_condition>::CycleOnce()
 {
+  Workspace& ws = *m_pWorkspace;
+
   //if the PQ is empty the target has not been found
-  if (m_pPQ->empty())
+  if (ws.PQ().empty())
   {
     return target_not_found;
   }
 
   //get lowest cost node from the queue
-  int NextClosestNode = m_pPQ->Pop();
+  int NextClosestNode = ws.PQ().Pop();
 
   //move this node from the frontier to the spanning tree
-  m_ShortestPathTree[NextClosestNode] = m_SearchFrontier[NextClosestNode];
+  ws.SetSPT(NextClosestNode, ws.Frontier(NextClosestNode));
 
   //if the target has been found exit
   if (termination_condition::isSatisfied(m_Graph, m_iTarget, NextClosestNode))
@@ -389,20 +434,25 @@ int Graph_SearchDijkstras_TS<graph_type, termination_condition>::CycleOnce()
       !ConstEdgeItr.end();
        pE=ConstEdgeItr.next())
   {
+    int to = pE->To();
+
     //the total cost to the node this edge points to is the cost to the
     //current node plus the cost of the edge connecting them.
-    double NewCost = m_CostToThisNode[NextClosestNode] + pE->Cost();
+    double NewCost = ws.GCost(NextClosestNode) + pE->Cost();
 
-    //if this edge has never been on the frontier make a note of the cost
-    //to get to the node it points to, then add the edge to the frontier
-    //and the destination node to the PQ.
-    if (m_SearchFrontier[pE->To()] == 0)
+    //if this node has never been reached by this search make a note of the
+    //cost to get to it, then add the edge to the frontier and the node to
+    //the PQ.
+    if (!ws.isTouched(to))
     {
-      m_CostToThisNode[pE->To()] = NewCost;
+      ws.Touch(to);
 
-      m_pPQ->insert(pE->To());
+      ws.SetGCost(to, NewCost);
+      ws.SetFCost(to, NewCost);
 
-      m_SearchFrontier[pE->To()] = pE;
+      ws.PQ().insert(to);
+
+      ws.SetFrontier(to, pE);
     }
 
     //else test to see if the cost to reach the destination node via the
@@ -410,16 +460,17 @@ int Graph_SearchDijkstras_TS<graph_type, termination_condition>::CycleOnce()
     //this path is cheaper, we assign the new cost to the destination
     //node, update its entry in the PQ to reflect the change and add the
     //edge to the frontier
-    else if ( (NewCost < m_CostToThisNode[pE->To()]) &&
-              (m_ShortestPathTree[pE->To()] == 0) )
+    else if ( (NewCost < ws.GCost(to)) &&
+              (ws.SPT(to) == 0) && (to != m_iSource) )
     {
-      m_CostToThisNode[pE->To()] = NewCost;
+      ws.SetGCost(to, NewCost);
+      ws.SetFCost(to, NewCost);
 
       //because the cost is less than it was previously, the PQ must be
       //re-sorted to account for this.
-      m_pPQ->ChangePriority(pE->To());
+      ws.PQ().ChangePriority(to);
 
-      m_SearchFrontier[pE->To()] = pE;
+      ws.SetFrontier(to, pE);
     }
   }
   
@@ -441,9 +492,9 @@ Graph_SearchDijkstras_TS<graph_type, termination_condition>::GetPathToTarget()co
 
   path.push_back(nd);
     
-  while ((nd != m_iSource) && (m_ShortestPathTree[nd] != 0))
+  while ((nd != m_iSource) && (m_pWorkspace->SPT(nd) != 0))
   {
-    nd = m_ShortestPathTree[nd]->From();
+    nd = m_pWorkspace->SPT(nd)->From();
 
     path.push_front(nd);
   }
@@ -467,17 +518,727 @@ Graph_SearchDijkstras_TS<graph_type, termination_condition>::GetPathAsPathEdges(
 
   int nd = m_iTarget;
     
-  while ((nd != m_iSource) && (m_ShortestPathTree[nd] != 0))
+  while ((nd != m_iSource) && (m_pWorkspace->SPT(nd) != 0))
   {
-    path.push_front(PathEdge(m_Graph.GetNode(m_ShortestPathTree[nd]->From()).Pos(),
-                             m_Graph.GetNode(m_ShortestPathTree[nd]->To()).Pos(),
-                             m_ShortestPathTree[nd]->Flags(),
-                             m_ShortestPathTree[nd]->IDofIntersectingEntity()));
+    const Edge* pE = m_pWorkspace->SPT(nd);
+
+    path.push_front(PathEdge(m_Graph.GetNode(pE->From()).Pos(),
+                             m_Graph.GetNode(pE->To()).Pos(),
+                             pE->Flags(),
+                             pE->IDofIntersectingEntity()));
     
-    nd = m_ShortestPathTree[nd]->From();
+    nd = pE->From();
+  }
+
+  return path;
+}
+
+//---------------------------- Graph_SearchHPA_TS -----------------------------
+//
+//  hierarchical A* (see HierarchicalGraph.h) spread over multiple
+//  update-steps. The first cycle links the source and target to the
+//  entrances of their clusters, and every cycle after that expands one node
+//  of the abstract graph.
+//
+//  Once the target is found the abstract path is refined into graph edges
+//  lazily. GetPathAsPathEdges returns the path as far as the first cluster
+//  crossing and each call to RefineNextSegment adds the path through the
+//  next cluster, so a bot only pays for the refinement of the part of the
+//  path it actually follows.
+//
+//  The abstract search is keyed on graph node indices, so its workspace
+//  comes from a pool of workspaces over abstract edges.
+//-----------------------------------------------------------------------------
+template <class graph_type, class heuristic>
+class Graph_SearchHPA_TS : public Graph_SearchTimeSliced<typename graph_type::EdgeType>
+{
+public:
+
+  typedef HierarchicalGraph<graph_type>         Hierarchy;
+  typedef typename Hierarchy::AbstractEdge      AbstractEdge;
+  typedef SearchWorkspacePool<AbstractEdge>     WorkspacePool;
+
+private:
+
+  typedef typename graph_type::EdgeType         Edge;
+  typedef typename Hierarchy::AbstractEdgeList  AbstractEdgeList;
+  typedef SearchWorkspace<AbstractEdge>         Workspace;
+
+private:
+
+  const Hierarchy&               m_Hierarchy;
+  const graph_type&              m_Graph;
+
+  Workspace*                     m_pWorkspace;
+
+  //the pool the workspace came from (NULL if the search owns it)
+  WorkspacePool*                 m_pPool;
+
+  int                            m_iSource;
+  int                            m_iTarget;
+
+  //true once the source and target have been linked into the abstract graph
+  bool                           m_bLinked;
+
+  //the abstract edges from the source to its cluster's entrances (plus one
+  //straight to the target if they share a cluster), and from the target's
+  //cluster's entrances to the target
+  AbstractEdgeList               m_SourceEdges;
+  AbstractEdgeList               m_TargetEdges;
+
+  //the abstract path from source to target, filled in when the target is
+  //found, and the index of the first of its edges not yet refined
+  std::vector<const AbstractEdge*>  m_AbstractPath;
+  mutable unsigned int              m_iNextToRefine;
+
+  //set if an abstract edge of the path couldn't be refined
+  mutable bool                      m_bRefinementFailed;
+
+
+  //relaxes an abstract edge leaving the node just taken off the PQ
+  void                   Relax(const AbstractEdge& edge);
+
+  //refines the abstract path from m_iNextToRefine up to and including the
+  //next edge that crosses into another cluster
+  std::list<PathEdge>    RefineNextLeg()const;
+
+public:
+
+  Graph_SearchHPA_TS(const Hierarchy& H,
+                     int              source,
+                     int              target,
+                     WorkspacePool*   pPool = NULL):Graph_SearchTimeSliced<Edge>(Graph_SearchTimeSliced<Edge>::AStar),
+
+                                              m_Hierarchy(H),
+                                              m_Graph(H.Graph()),
+                                              m_pPool(pPool),
+                                              m_iSource(source),
+                                              m_iTarget(target),
+                                              m_bLinked(false),
+                                              m_iNextToRefine(0),
+                                              m_bRefinementFailed(false)
+  {
+    if (m_pPool)
+    {
+      m_pWorkspace = m_pPool->Acquire(m_Graph.NumNodes());
+    }
+    else
+    {
+      m_pWorkspace = new Workspace();
+
+      m_pWorkspace->Reset(m_Graph.NumNodes());
+    }
+
+    //put the source node on the queue
+    m_pWorkspace->Touch(m_iSource);
+
+    m_pWorkspace->PQ().insert(m_iSource);
+  }
+
+  ~Graph_SearchHPA_TS()
+  {
+    if (m_pPool) m_pPool->Release(m_pWorkspace);
+    else         delete m_pWorkspace;
+  }
+
+  int                      CycleOnce();
+
+  //the abstract search only examines cluster crossings, so the returned SPT
+  //holds just the graph edges of the crossings it has settled
+  std::vector<const Edge*> GetSPT()const;
+
+  //returns the nodes of the abstract path: the source, the entrances it
+  //passes through and the target
+  std::list<int>           GetPathToTarget()const;
+
+  //returns the refined path as far as the first cluster crossing
+  std::list<PathEdge>      GetPathAsPathEdges()const;
+
+  bool                     HasUnrefinedPath()const{return m_iNextToRefine < m_AbstractPath.size();}
+
+  void                     RefineNextSegment(std::list<PathEdge>& path)
+  {
+    path.splice(path.end(), RefineNextLeg());
+  }
+
+  bool                     RefinementFailed()const{return m_bRefinementFailed;}
+
+  double                   GetCostToTarget()const{return m_pWorkspace->GCost(m_iTarget);}
+};
+
+//-----------------------------------------------------------------------------
+template <class graph_type, class heuristic>
+int Graph_SearchHPA_TS<graph_type, heuristic>::CycleOnce()
+{
+  //the first cycle is spent searching the source and target clusters
+  if (!m_bLinked)
+  {
+    m_Hierarchy.ConnectToCluster(m_iSource, false, m_SourceEdges);
+    m_Hierarchy.ConnectToCluster(m_iTarget, true,  m_TargetEdges);
+
+    double cost;
+
+    if (m_iSource != m_iTarget && m_Hierarchy.CostInsideCluster(m_iSource, m_iTarget, cost))
+    {
+      m_SourceEdges.push_back(AbstractEdge(m_iSource, m_iTarget, cost, NULL));
+    }
+
+    m_bLinked = true;
+
+    return search_incomplete;
+  }
+
+  Workspace& ws = *m_pWorkspace;
+
+  //if the PQ is empty the target has not been found
+  if (ws.PQ().empty())
+  {
+    return target_not_found;
+  }
+
+  //get lowest cost node from the queue and put it on the SPT
+  int NextClosestNode = ws.PQ().Pop();
+
+  ws.SetSPT(NextClosestNode, ws.Frontier(NextClosestNode));
+
+  //if the target has been found make a note of the abstract path and exit
+  if (NextClosestNode == m_iTarget)
+  {
+    for (int nd = m_iTarget; nd != m_iSource; nd = ws.SPT(nd)->From())
+    {
+      m_AbstractPath.push_back(ws.SPT(nd));
+    }
+
+    std::reverse(m_AbstractPath.begin(), m_AbstractPath.end());
+
+    return target_found;
+  }
+
+  typename AbstractEdgeList::const_iterator it;
+
+  if (NextClosestNode == m_iSource)
+  {
+    for (it = m_SourceEdges.begin(); it != m_SourceEdges.end(); ++it) Relax(*it);
+  }
+
+  const AbstractEdgeList& edges = m_Hierarchy.AbstractEdges(NextClosestNode);
+
+  for (it = edges.begin(); it != edges.end(); ++it) Relax(*it);
+
+  if (m_Hierarchy.ClusterOf(NextClosestNode) == m_Hierarchy.ClusterOf(m_iTarget))
+  {
+    for (it = m_TargetEdges.begin(); it != m_TargetEdges.end(); ++it)
+    {
+      if (it->From() == NextClosestNode) Relax(*it);
+    }
+  }
+
+  //there are still nodes to explore
+  return search_incomplete;
+}
+
+//-----------------------------------------------------------------------------
+template <class graph_type, class heuristic>
+void Graph_SearchHPA_TS<graph_type, heuristic>::Relax(const AbstractEdge& edge)
+{
+  Workspace& ws = *m_pWorkspace;
+
+  int to = edge.To();
+
+  double HCost = heuristic::Calculate(m_Graph, m_iTarget, to);
+  double GCost = ws.GCost(edge.From()) + edge.Cost();
+
+  if (!ws.isTouched(to))
+  {
+    ws.Touch(to);
+
+    ws.SetFCost(to, GCost + HCost);
+    ws.SetGCost(to, GCost);
+
+    ws.PQ().insert(to);
+
+    ws.SetFrontier(to, &edge);
+  }
+
+  else if ((GCost < ws.GCost(to)) && (ws.SPT(to)==NULL) && (to != m_iSource))
+  {
+    ws.SetFCost(to, GCost + HCost);
+    ws.SetGCost(to, GCost);
+
+    ws.PQ().ChangePriority(to);
+
+    ws.SetFrontier(to, &edge);
+  }
+}
+
+//-----------------------------------------------------------------------------
+template <class graph_type, class heuristic>
+std::vector<const typename graph_type::EdgeType*>
+Graph_SearchHPA_TS<graph_type, heuristic>::GetSPT()const
+{
+  std::vector<const Edge*> spt(m_Graph.NumNodes(), (const Edge*)NULL);
+
+  for (int nd=0; nd<m_Graph.NumNodes(); ++nd)
+  {
+    if (m_pWorkspace->SPT(nd)) spt[nd] = m_pWorkspace->SPT(nd)->m_pEdge;
+  }
+
+  return spt;
+}
+
+//-----------------------------------------------------------------------------
+template <class graph_type, class heuristic>
+std::list<int>
+Graph_SearchHPA_TS<graph_type, heuristic>::GetPathToTarget()const
+{
+  std::list<int> path;
+
+  //just return an empty path if no target or no path found
+  if (m_iTarget < 0)  return path;
+
+  path.push_back(m_iSource);
+
+  for (unsigned int e=0; e<m_AbstractPath.size(); ++e)
+  {
+    path.push_back(m_AbstractPath[e]->To());
+  }
+
+  return path;
+}
+
+//-------------------------- GetPathAsPathEdges -------------------------------
+//-----------------------------------------------------------------------------
+template <class graph_type, class heuristic>
+std::list<PathEdge>
+Graph_SearchHPA_TS<graph_type, heuristic>::GetPathAsPathEdges()const
+{
+  m_iNextToRefine     = 0;
+  m_bRefinementFailed = false;
+
+  return RefineNextLeg();
+}
+
+//------------------------------ RefineNextLeg --------------------------------
+//-----------------------------------------------------------------------------
+template <class graph_type, class heuristic>
+std::list<PathEdge>
+Graph_SearchHPA_TS<graph_type, heuristic>::RefineNextLeg()const
+{
+  std::list<PathEdge>        path;
+  std::vector<const Edge*>   edges;
+
+  while (m_iNextToRefine < m_AbstractPath.size())
+  {
+    const AbstractEdge* pAbstract = m_AbstractPath[m_iNextToRefine++];
+
+    //the graph has changed under the search. Give up on the rest of the path
+    if (!m_Hierarchy.RefineEdge(*pAbstract, edges))
+    {
+      m_iNextToRefine     = m_AbstractPath.size();
+      m_bRefinementFailed = true;
+
+      break;
+    }
+
+    if (pAbstract->isInterCluster()) break;
+  }
+
+  for (unsigned int e=0; e<edges.size(); ++e)
+  {
+    const Edge* pE = edges[e];
+
+    path.push_back(PathEdge(m_Graph.GetNode(pE->From()).Pos(),
+                            m_Graph.GetNode(pE->To()).Pos(),
+                            pE->Flags(),
+                            pE->IDofIntersectingEntity()));
+  }
+
+  return path;
+}
+
+//------------------------ Graph_SearchDStarLite_TS ---------------------------
+//
+//  an incremental search (D* Lite) of an undirected graph whose edge costs
+//  may change while an agent follows the path it found.
+//
+//  The search runs backwards, from the target to the agent, and is kept
+//  once it has completed. If the costs of some edges change (a door opens,
+//  for example) EdgeCostsChanged marks the nodes at their ends for repair,
+//  and running the search again only reworks the part of the search tree
+//  the change affects. SetStart moves the start of the path as the agent
+//  moves along it. Edge costs are given by the edge_cost policy (see
+//  EdgeCostPolicies.h) and the heuristic must never overestimate them.
+//-----------------------------------------------------------------------------
+template <class graph_type, class heuristic, class edge_cost>
+class Graph_SearchDStarLite_TS : public Graph_SearchTimeSliced<typename graph_type::EdgeType>
+{
+private:
+
+  typedef typename graph_type::EdgeType  Edge;
+
+  //a queue entry is keyed on a pair of costs, compared lexicographically
+  typedef std::pair<double, double>      Key;
+  typedef std::pair<Key, int>            QueueEntry;
+
+  const graph_type&                m_Graph;
+
+  int                              m_iStart;
+  int                              m_iTarget;
+
+  //the start when the edge costs last changed, and the amount the keys
+  //have been offset by as the start has moved since the search began
+  int                              m_iLastStart;
+  double                           m_dKeyOffset;
+
+  //the cost of the path from each node to the target found so far, and
+  //the cost one step ahead of that (the rhs value). A node is consistent
+  //if they are equal
+  std::vector<double>              m_G;
+  std::vector<double>              m_RHS;
+
+  //the inconsistent nodes, lowest key first. Entries aren't removed when a
+  //node's key changes, so a node may have several and stale ones are
+  //skipped as they come to the top
+  std::priority_queue<QueueEntry,
+                      std::vector<QueueEntry>,
+                      std::greater<QueueEntry> >  m_Queue;
+
+
+  //the heuristic is scaled down a touch. The nodes on the shortest path all
+  //need keys below the start's to be finished, but with an exact heuristic
+  //they tie with it and rounding may tip them above it (the navgraph's edge
+  //costs are rounded, so the straight line distance can exceed them by a
+  //hair)
+  static double Estimate(const graph_type& G, int nd1, int nd2)
+  {
+    return heuristic::Calculate(G, nd1, nd2) * 0.9999;
+  }
+
+  Key  CalculateKey(int nd)const
+  {
+    double k = (std::min)(m_G[nd], m_RHS[nd]);
+
+    return Key(k + Estimate(m_Graph, m_iStart, nd) + m_dKeyOffset, k);
+  }
+
+  //the search goes wrong if any edge costs nothing, as two nodes joined by
+  //such an edge can hold each other's costs down when they should rise. Some
+  //navgraphs join nodes at the same position, so every edge is made to cost
+  //at least a little
+  static double Cost(const Edge& edge)
+  {
+    const double MinEdgeCost = 1e-3;
+
+    double cost = edge_cost::Cost(edge);
+
+    return cost > MinEdgeCost ? cost : MinEdgeCost;
+  }
+
+  //recalculates the rhs value of a node and queues it if it's now
+  //inconsistent
+  void UpdateNode(int nd);
+
+  //removes any entries for consistent nodes from the top of the queue
+  void DiscardStaleEntries();
+
+  //the node after nd on the path to the target (or invalid_node_index),
+  //and the edge leading to it
+  int  NextNodeOnPath(int nd, const Edge*& pEdge)const;
+
+public:
+
+  Graph_SearchDStarLite_TS(const graph_type& G,
+                           int               source,
+                           int               target):Graph_SearchTimeSliced<Edge>(Graph_SearchTimeSliced<Edge>::AStar),
+                                                     m_Graph(G),
+                                                     m_iStart(source),
+                                                     m_iTarget(target),
+                                                     m_iLastStart(source),
+                                                     m_dKeyOffset(0),
+                                                     m_G(G.NumNodes(), MaxDouble),
+                                                     m_RHS(G.NumNodes(), MaxDouble)
+  {
+    m_RHS[m_iTarget] = 0;
+
+    m_Queue.push(QueueEntry(CalculateKey(m_iTarget), m_iTarget));
+  }
+
+  //processes the inconsistent node with the lowest key. The search is
+  //complete when no node left in the queue could change the cost from the
+  //start
+  int                      CycleOnce();
+
+  //the agent's path now starts from nd
+  void                     SetStart(int nd){m_iStart = nd;}
+
+  int                      GetStart()const{return m_iStart;}
+
+  //the costs of some of the edges of these nodes have changed. The search
+  //must be run again (until CycleOnce no longer returns search_incomplete)
+  //before the path is used
+  void                     EdgeCostsChanged(const std::vector<int>& nodes);
+
+  //returns the edges of the path
+  std::vector<const Edge*> GetSPT()const;
+
+  std::list<int>           GetPathToTarget()const;
+
+  std::list<PathEdge>      GetPathAsPathEdges()const;
+
+  double                   GetCostToTarget()const{return m_G[m_iStart];}
+};
+
+//------------------------------ UpdateNode -----------------------------------
+//-----------------------------------------------------------------------------
+template <class graph_type, class heuristic, class edge_cost>
+void Graph_SearchDStarLite_TS<graph_type, heuristic, edge_cost>::UpdateNode(int nd)
+{
+  if (nd != m_iTarget)
+  {
+    double rhs = MaxDouble;
+
+    graph_type::ConstEdgeIterator ConstEdgeItr(m_Graph, nd);
+    for (const Edge* pE=ConstEdgeItr.begin();
+        !ConstEdgeItr.end();
+         pE=ConstEdgeItr.next())
+    {
+      if (m_G[pE->To()] == MaxDouble) continue;
+
+      double cost = Cost(*pE) + m_G[pE->To()];
+
+      if (cost < rhs) rhs = cost;
+    }
+
+    m_RHS[nd] = rhs;
+  }
+
+  if (m_G[nd] != m_RHS[nd])
+  {
+    m_Queue.push(QueueEntry(CalculateKey(nd), nd));
+  }
+}
+
+//-------------------------- DiscardStaleEntries ------------------------------
+//-----------------------------------------------------------------------------
+template <class graph_type, class heuristic, class edge_cost>
+void Graph_SearchDStarLite_TS<graph_type, heuristic, edge_cost>::DiscardStaleEntries()
+{
+  while (!m_Queue.empty() && m_G[m_Queue.top().second] == m_RHS[m_Queue.top().second])
+  {
+    m_Queue.pop();
+  }
+}
+
+//------------------------------- CycleOnce -----------------------------------
+//-----------------------------------------------------------------------------
+template <class graph_type, class heuristic, class edge_cost>
+int Graph_SearchDStarLite_TS<graph_type, heuristic, edge_cost>::CycleOnce()
+{
+  DiscardStaleEntries();
+
+  //the search is complete when the start is consistent and no node in the
+  //queue has a lower key
+  if (m_Queue.empty() ||
+      (!(m_Queue.top().first < CalculateKey(m_iStart)) && m_G[m_iStart] == m_RHS[m_iStart]))
+  {
+    return m_G[m_iStart] < MaxDouble ? target_found : target_not_found;
+  }
+
+  Key OldKey = m_Queue.top().first;
+  int nd     = m_Queue.top().second;
+
+  m_Queue.pop();
+
+  Key NewKey = CalculateKey(nd);
+
+  //the key is out of date (the start has moved since it was queued)
+  if (OldKey < NewKey)
+  {
+    m_Queue.push(QueueEntry(NewKey, nd));
+
+    return search_incomplete;
+  }
+
+  //the cost from nd has fallen, so its neighbours may now do better through
+  //it. If it has risen, nd and its neighbours must all be reworked
+  if (m_G[nd] > m_RHS[nd])
+  {
+    m_G[nd] = m_RHS[nd];
+  }
+  else
+  {
+    m_G[nd] = MaxDouble;
+
+    UpdateNode(nd);
+  }
+
+  //the graph is undirected, so the nodes an edge leads to from nd are those
+  //with an edge leading to nd
+  graph_type::ConstEdgeIterator ConstEdgeItr(m_Graph, nd);
+  for (const Edge* pE=ConstEdgeItr.begin();
+      !ConstEdgeItr.end();
+       pE=ConstEdgeItr.next())
+  {
+    UpdateNode(pE->To());
+  }
+
+  return search_incomplete;
+}
+
+//--------------------------- EdgeCostsChanged --------------------------------
+//-----------------------------------------------------------------------------
+template <class graph_type, class heuristic, class edge_cost>
+void Graph_SearchDStarLite_TS<graph_type, heuristic, edge_cost>::EdgeCostsChanged(const std::vector<int>& nodes)
+{
+  //the keys already queued were calculated from the old start. Rather than
+  //recalculate them all, the new keys are raised by the distance the start
+  //has moved, which keeps them in order
+  m_dKeyOffset += Estimate(m_Graph, m_iLastStart, m_iStart);
+  m_iLastStart  = m_iStart;
+
+  for (unsigned int n=0; n<nodes.size(); ++n)
+  {
+    UpdateNode(nodes[n]);
+  }
+}
+
+//---------------------------- NextNodeOnPath ---------------------------------
+//-----------------------------------------------------------------------------
+template <class graph_type, class heuristic, class edge_cost>
+int Graph_SearchDStarLite_TS<graph_type, heuristic, edge_cost>::NextNodeOnPath(int          nd,
+                                                                               const Edge*& pEdge)const
+{
+  double best = MaxDouble;
+  int    next = invalid_node_index;
+
+  pEdge = NULL;
+
+  graph_type::ConstEdgeIterator ConstEdgeItr(m_Graph, nd);
+  for (const Edge* pE=ConstEdgeItr.begin();
+      !ConstEdgeItr.end();
+       pE=ConstEdgeItr.next())
+  {
+    if (m_G[pE->To()] == MaxDouble) continue;
+
+    double cost = Cost(*pE) + m_G[pE->To()];
+
+    if (cost < best)
+    {
+      best  = cost;
+      next  = pE->To();
+      pEdge = pE;
+    }
+  }
+
+  return next;
+}
+
+//------------------------------- GetSPT --------------------------------------
+//-----------------------------------------------------------------------------
+template <class graph_type, class heuristic, class edge_cost>
+std::vector<const typename graph_type::EdgeType*>
+Graph_SearchDStarLite_TS<graph_type, heuristic, edge_cost>::GetSPT()const
+{
+  std::vector<const Edge*> edges;
+
+  if (m_G[m_iStart] == MaxDouble) return edges;
+
+  const Edge* pE = NULL;
+
+  //(the step limit guards against following a path that is being repaired)
+  for (int nd = m_iStart, steps = 0;
+       nd != m_iTarget && nd != invalid_node_index && steps < m_Graph.NumNodes();
+       ++steps)
+  {
+    nd = NextNodeOnPath(nd, pE);
+
+    if (pE) edges.push_back(pE);
+  }
+
+  return edges;
+}
+
+//---------------------------- GetPathToTarget --------------------------------
+//-----------------------------------------------------------------------------
+template <class graph_type, class heuristic, class edge_cost>
+std::list<int>
+Graph_SearchDStarLite_TS<graph_type, heuristic, edge_cost>::GetPathToTarget()const
+{
+  std::list<int> path;
+
+  std::vector<const Edge*> edges = GetSPT();
+
+  if (edges.empty() && m_iStart != m_iTarget) return path;
+
+  path.push_back(m_iStart);
+
+  for (unsigned int e=0; e<edges.size(); ++e)
+  {
+    path.push_back(edges[e]->To());
+  }
+
+  return path;
+}
+
+//-------------------------- GetPathAsPathEdges -------------------------------
+//-----------------------------------------------------------------------------
+template <class graph_type, class heuristic, class edge_cost>
+std::list<PathEdge>
+Graph_SearchDStarLite_TS<graph_type, heuristic, edge_cost>::GetPathAsPathEdges()const
+{
+  std::list<PathEdge> path;
+
+  std::vector<const Edge*> edges = GetSPT();
+
+  for (unsigned int e=0; e<edges.size(); ++e)
+  {
+    const Edge* pE = edges[e];
+
+    path.push_back(PathEdge(m_Graph.GetNode(pE->From()).Pos(),
+                            m_Graph.GetNode(pE->To()).Pos(),
+                            pE->Flags(),
+                            pE->IDofIntersectingEntity()));
   }
 
   return path;
 }
 
+//-------------------------- Graph_CachedSearch_TS ----------------------------
+//
+//  stands in for a search whose result was already known (see PathCache.h).
+//  It completes on its first cycle.
+//-----------------------------------------------------------------------------
+template <class edge_type>
+class Graph_CachedSearch_TS : public Graph_SearchTimeSliced<edge_type>
+{
+private:
+
+  std::list<int>       m_Nodes;
+  std::list<PathEdge>  m_Edges;
+
+  double               m_dCost;
+
+public:
+
+  Graph_CachedSearch_TS(typename Graph_SearchTimeSliced<edge_type>::SearchType type,
+                        const std::list<int>&      nodes,
+                        const std::list<PathEdge>& edges,
+                        double                     cost):Graph_SearchTimeSliced<edge_type>(type),
+                                                         m_Nodes(nodes),
+                                                         m_Edges(edges),
+                                                         m_dCost(cost)
+  {}
+
+  int                           CycleOnce(){return target_found;}
+
+  //nothing was searched
+  std::vector<const edge_type*> GetSPT()const{return std::vector<const edge_type*>();}
+
+  double                        GetCostToTarget()const{return m_dCost;}
+
+  std::list<int>                GetPathToTarget()const{return m_Nodes;}
+
+  std::list<PathEdge>           GetPathAsPathEdges()const{return m_Edges;}
+};
+
 #endif
\ No newline at end of file
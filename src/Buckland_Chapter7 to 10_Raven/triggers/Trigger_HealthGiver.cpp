@@ -54,8 +54,8 @@ void Trigger_HealthGiver::Read(std::ifstream& in)
   SetGraphNodeIndex(GraphNodeIndex);
 
   //create this trigger's region of fluence
-  AddCircularTriggerRegion(Pos(), script->GetDouble("DefaultGiverTriggerRange"));
+  AddCircularTriggerRegion(Pos(), script->Params().DefaultGiverTriggerRange);
 
-  SetRespawnDelay((unsigned int)(script->GetDouble("Health_RespawnDelay") * FrameRate));
+  SetRespawnDelay((unsigned int)(script->Params().Health_RespawnDelay * FrameRate));
   SetEntityType(type_health);
 }
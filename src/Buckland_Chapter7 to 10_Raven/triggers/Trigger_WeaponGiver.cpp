@@ -45,7 +45,7 @@ Trigger_WeaponGiver::Trigger_WeaponGiver(std::string nameTeam, Vector2D pos, dou
 	SetGraphNodeIndex(GraphNodeIndex);
 
 	//create this trigger's region of fluence
-	AddCircularTriggerRegion(Pos(), script->GetDouble("DefaultGiverTriggerRange"));
+	AddCircularTriggerRegion(Pos(), script->Params().DefaultGiverTriggerRange);
 
 	//create the vertex buffer for the rocket shape
 	const int NumRocketVerts = 8;
@@ -88,10 +88,10 @@ void Trigger_WeaponGiver::Read(std::ifstream& in)
 	SetGraphNodeIndex(GraphNodeIndex);
 
 	//create this trigger's region of fluence
-	AddCircularTriggerRegion(Pos(), script->GetDouble("DefaultGiverTriggerRange"));
+	AddCircularTriggerRegion(Pos(), script->Params().DefaultGiverTriggerRange);
 
 
-	SetRespawnDelay((unsigned int)(script->GetDouble("Weapon_RespawnDelay") * FrameRate));
+	SetRespawnDelay((unsigned int)(script->Params().Weapon_RespawnDelay * FrameRate));
 }
 
 
@@ -1,3 +1,5 @@
+#ifndef WALLINTERSECTIONTESTS_H
+#define WALLINTERSECTIONTESTS_H
 //-----------------------------------------------------------------------------
 //
 //  Name:   WallIntersectionTests.h
@@ -6,10 +8,15 @@
 //
 //  Desc:   a few functions for testing line segments against containers of
 //          walls
+//
+//          Each test also has a batch overload taking a WallTable2D, which
+//          checks four walls per call to the SIMD kernels in geometry.h
 //-----------------------------------------------------------------------------
 
 #include "2d/Vector2D.h"
 #include "2d/Wall2d.h"
+#include "2d/WallTable2D.h"
+#include "2d/geometry.h"
 
 
 //----------------------- doWallsObstructLineSegment --------------------------
@@ -137,4 +144,113 @@ inline bool doWallsIntersectCircle(const ContWall& walls, Vector2D p, double r)
   return false;
 }
 
+//------------------------- batch (WallTable2D) versions ----------------------
+//
+//  these behave exactly like the templates above but test the walls four at
+//  a time. The obstruction tests return as soon as any batch reports a hit.
+//-----------------------------------------------------------------------------
+inline bool doWallsObstructLineSegment(Vector2D           from,
+                                       Vector2D           to,
+                                       const WallTable2D& walls)
+{
+  const double* Cx = walls.FromX(); const double* Cy = walls.FromY();
+  const double* Dx = walls.ToX();   const double* Dy = walls.ToY();
+
+  const int NumWalls = walls.Size();
+
+  int w=0;
+  for (; w+4 <= NumWalls; w+=4)
+  {
+    if (LineIntersection2DBatch4(from, to, Cx+w, Cy+w, Dx+w, Dy+w))
+    {
+      return true;
+    }
+  }
+
+  //test any remaining walls one at a time
+  for (; w<NumWalls; ++w)
+  {
+    if (LineIntersection2D(from, to, walls.From(w), walls.To(w)))
+    {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+inline bool FindClosestPointOfIntersectionWithWalls(Vector2D           A,
+                                                    Vector2D           B,
+                                                    double&            distance,
+                                                    Vector2D&          ip,
+                                                    const WallTable2D& walls)
+{
+  distance = MaxDouble;
+
+  const double* Cx = walls.FromX(); const double* Cy = walls.FromY();
+  const double* Dx = walls.ToX();   const double* Dy = walls.ToY();
+
+  const int NumWalls = walls.Size();
+
+  for (int w=0; w<NumWalls; w+=4)
+  {
+    //a full batch is screened with the kernel. Only the walls it reports
+    //(usually none) need the scalar test that calculates the hit point
+    int mask = 0xF;
+
+    if (w+4 <= NumWalls)
+    {
+      mask = LineIntersection2DBatch4(A, B, Cx+w, Cy+w, Dx+w, Dy+w);
+    }
+
+    for (int i=0; i<4 && w+i<NumWalls; ++i)
+    {
+      if (!(mask & (1 << i))) continue;
+
+      double dist = 0.0;
+      Vector2D point;
+
+      if (LineIntersection2D(A, B, walls.From(w+i), walls.To(w+i), dist, point))
+      {
+        if (dist < distance)
+        {
+          distance = dist;
+          ip = point;
+        }
+      }
+    }
+  }
+
+  if (distance < MaxDouble) return true;
+
+  return false;
+}
+
+inline bool doWallsIntersectCircle(const WallTable2D& walls, Vector2D p, double r)
+{
+  const double* Cx = walls.FromX(); const double* Cy = walls.FromY();
+  const double* Dx = walls.ToX();   const double* Dy = walls.ToY();
+
+  const int NumWalls = walls.Size();
+
+  int w=0;
+  for (; w+4 <= NumWalls; w+=4)
+  {
+    if (LineSegmentCircleIntersectionBatch4(p, r, Cx+w, Cy+w, Dx+w, Dy+w))
+    {
+      return true;
+    }
+  }
+
+  for (; w<NumWalls; ++w)
+  {
+    if (LineSegmentCircleIntersection(walls.From(w), walls.To(w), p, r))
+    {
+      return true;
+    }
+  }
+
+  return false;
+}
 
+#endif
@@ -0,0 +1,74 @@
+#ifndef WALLTABLE2D_H
+#define WALLTABLE2D_H
+//------------------------------------------------------------------------
+//
+//  Name:   WallTable2D.h
+//
+//  Desc:   stores a collection of walls as a structure of arrays (one
+//          packed array per coordinate) so that a line segment or circle
+//          can be tested against several walls at once by the batch
+//          kernels in geometry.h. Wall i of the table mirrors the i'th
+//          Wall2D it was built from and must be refreshed with Set
+//          whenever that wall moves. Only the end points are stored: the
+//          kernels don't need the normals, which are read from the Wall2D.
+//
+//------------------------------------------------------------------------
+#include <vector>
+#include "2d/Vector2D.h"
+#include "2d/Wall2D.h"
+
+
+class WallTable2D
+{
+private:
+
+  std::vector<double>  m_FromX;
+  std::vector<double>  m_FromY;
+  std::vector<double>  m_ToX;
+  std::vector<double>  m_ToY;
+
+public:
+
+  //appends a copy of the wall's geometry and returns its index
+  int Add(const Wall2D& wall)
+  {
+    m_FromX.push_back(wall.From().x);
+    m_FromY.push_back(wall.From().y);
+    m_ToX.push_back(wall.To().x);
+    m_ToY.push_back(wall.To().y);
+
+    return Size()-1;
+  }
+
+  //overwrites the geometry stored at idx (used when a wall moves)
+  void Set(int idx, const Wall2D& wall)
+  {
+    assert (idx >= 0 && idx < Size() && "<WallTable2D::Set>: invalid index");
+
+    m_FromX[idx] = wall.From().x;
+    m_FromY[idx] = wall.From().y;
+    m_ToX[idx]   = wall.To().x;
+    m_ToY[idx]   = wall.To().y;
+  }
+
+  void Clear()
+  {
+    m_FromX.clear(); m_FromY.clear();
+    m_ToX.clear();   m_ToY.clear();
+  }
+
+  int      Size()const{return (int)m_FromX.size();}
+  bool     Empty()const{return m_FromX.empty();}
+
+  Vector2D From(int idx)const{return Vector2D(m_FromX[idx], m_FromY[idx]);}
+  Vector2D To(int idx)const{return Vector2D(m_ToX[idx], m_ToY[idx]);}
+
+  //raw access to the packed arrays for the batch kernels
+  const double* FromX()const{return m_FromX.empty() ? 0 : &m_FromX[0];}
+  const double* FromY()const{return m_FromY.empty() ? 0 : &m_FromY[0];}
+  const double* ToX()const{return m_ToX.empty() ? 0 : &m_ToX[0];}
+  const double* ToY()const{return m_ToY.empty() ? 0 : &m_ToY[0];}
+};
+
+
+#endif
@@ -17,6 +17,15 @@
 #include <math.h>
 #include <vector>
 
+//the batch wall kernels at the bottom of this file use AVX when the compiler
+//targets it and fall back to SSE2 (always present on x64) or plain C++
+#if defined(__AVX__)
+  #define GEOMETRY_USE_AVX
+  #include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+  #define GEOMETRY_USE_SSE2
+  #include <emmintrin.h>
+#endif
 
 
 
@@ -626,26 +635,222 @@ inline bool GetLineSegmentCircleClosestIntersectionPoint(Vector2D A,
   return ipFound;
 }
 
+
+//-------------------------- LineIntersection2DBatch4 -------------------------
+//
+//  tests the line segment AB against four line segments CD at once. The
+//  segments are given in structure-of-arrays form (see WallTable2D.h) and
+//  the result is a bitmask with bit i set if AB intersects segment i. Gives
+//  the same answer as the first LineIntersection2D overload for each lane.
+//-----------------------------------------------------------------------------
+#if defined(GEOMETRY_USE_SSE2)
+inline int LineIntersection2DBatch2(__m128d ax,  __m128d ay,
+                                    __m128d bax, __m128d bay,
+                                    const double* Cx, const double* Cy,
+                                    const double* Dx, const double* Dy)
+{
+  __m128d acx = _mm_sub_pd(ax, _mm_loadu_pd(Cx));
+  __m128d acy = _mm_sub_pd(ay, _mm_loadu_pd(Cy));
+  __m128d dcx = _mm_sub_pd(_mm_loadu_pd(Dx), _mm_loadu_pd(Cx));
+  __m128d dcy = _mm_sub_pd(_mm_loadu_pd(Dy), _mm_loadu_pd(Cy));
+
+  __m128d rTop = _mm_sub_pd(_mm_mul_pd(acy, dcx), _mm_mul_pd(acx, dcy));
+  __m128d sTop = _mm_sub_pd(_mm_mul_pd(acy, bax), _mm_mul_pd(acx, bay));
+  __m128d Bot  = _mm_sub_pd(_mm_mul_pd(bax, dcy), _mm_mul_pd(bay, dcx));
+
+  //parallel segments give an infinite or NaN ratio, both of which fail the
+  //range tests below
+  __m128d invBot = _mm_div_pd(_mm_set1_pd(1.0), Bot);
+  __m128d r      = _mm_mul_pd(rTop, invBot);
+  __m128d s      = _mm_mul_pd(sTop, invBot);
+
+  const __m128d zero = _mm_setzero_pd();
+  const __m128d one  = _mm_set1_pd(1.0);
+
+  __m128d hit = _mm_and_pd(_mm_and_pd(_mm_cmpgt_pd(r, zero), _mm_cmplt_pd(r, one)),
+                           _mm_and_pd(_mm_cmpgt_pd(s, zero), _mm_cmplt_pd(s, one)));
+
+  return _mm_movemask_pd(hit);
+}
 #endif
 
-              
+inline int LineIntersection2DBatch4(Vector2D A,
+                                    Vector2D B,
+                                    const double* Cx, const double* Cy,
+                                    const double* Dx, const double* Dy)
+{
+#if defined(GEOMETRY_USE_AVX)
 
+  __m256d ax  = _mm256_set1_pd(A.x);
+  __m256d ay  = _mm256_set1_pd(A.y);
+  __m256d bax = _mm256_set1_pd(B.x - A.x);
+  __m256d bay = _mm256_set1_pd(B.y - A.y);
 
+  __m256d cx  = _mm256_loadu_pd(Cx);
+  __m256d cy  = _mm256_loadu_pd(Cy);
+  __m256d acx = _mm256_sub_pd(ax, cx);
+  __m256d acy = _mm256_sub_pd(ay, cy);
+  __m256d dcx = _mm256_sub_pd(_mm256_loadu_pd(Dx), cx);
+  __m256d dcy = _mm256_sub_pd(_mm256_loadu_pd(Dy), cy);
 
+  __m256d rTop = _mm256_sub_pd(_mm256_mul_pd(acy, dcx), _mm256_mul_pd(acx, dcy));
+  __m256d sTop = _mm256_sub_pd(_mm256_mul_pd(acy, bax), _mm256_mul_pd(acx, bay));
+  __m256d Bot  = _mm256_sub_pd(_mm256_mul_pd(bax, dcy), _mm256_mul_pd(bay, dcx));
 
+  __m256d invBot = _mm256_div_pd(_mm256_set1_pd(1.0), Bot);
+  __m256d r      = _mm256_mul_pd(rTop, invBot);
+  __m256d s      = _mm256_mul_pd(sTop, invBot);
 
+  const __m256d zero = _mm256_setzero_pd();
+  const __m256d one  = _mm256_set1_pd(1.0);
 
+  __m256d hit = _mm256_and_pd(_mm256_and_pd(_mm256_cmp_pd(r, zero, _CMP_GT_OQ),
+                                            _mm256_cmp_pd(r, one,  _CMP_LT_OQ)),
+                              _mm256_and_pd(_mm256_cmp_pd(s, zero, _CMP_GT_OQ),
+                                            _mm256_cmp_pd(s, one,  _CMP_LT_OQ)));
 
+  return _mm256_movemask_pd(hit);
 
+#elif defined(GEOMETRY_USE_SSE2)
 
+  __m128d ax  = _mm_set1_pd(A.x);
+  __m128d ay  = _mm_set1_pd(A.y);
+  __m128d bax = _mm_set1_pd(B.x - A.x);
+  __m128d bay = _mm_set1_pd(B.y - A.y);
 
+  return  LineIntersection2DBatch2(ax, ay, bax, bay, Cx,   Cy,   Dx,   Dy) |
+         (LineIntersection2DBatch2(ax, ay, bax, bay, Cx+2, Cy+2, Dx+2, Dy+2) << 2);
 
+#else
 
+  int mask = 0;
 
+  for (int i=0; i<4; ++i)
+  {
+    if (LineIntersection2D(A, B, Vector2D(Cx[i], Cy[i]), Vector2D(Dx[i], Dy[i])))
+    {
+      mask |= 1 << i;
+    }
+  }
 
+  return mask;
 
+#endif
+}
 
+//------------------- LineSegmentCircleIntersectionBatch4 ---------------------
+//
+//  as LineSegmentCircleIntersection but tests the circle at P against four
+//  line segments CD at once. Returns a bitmask of the segments that
+//  intersect the circle.
+//-----------------------------------------------------------------------------
+#if defined(GEOMETRY_USE_SSE2)
+inline int LineSegmentCircleIntersectionBatch2(__m128d px, __m128d py, __m128d rSq,
+                                               const double* Cx, const double* Cy,
+                                               const double* Dx, const double* Dy)
+{
+  __m128d cx = _mm_loadu_pd(Cx);
+  __m128d cy = _mm_loadu_pd(Cy);
+  __m128d dx = _mm_loadu_pd(Dx);
+  __m128d dy = _mm_loadu_pd(Dy);
+
+  __m128d abx = _mm_sub_pd(dx, cx);
+  __m128d aby = _mm_sub_pd(dy, cy);
+  __m128d apx = _mm_sub_pd(px, cx);
+  __m128d apy = _mm_sub_pd(py, cy);
+  __m128d bpx = _mm_sub_pd(px, dx);
+  __m128d bpy = _mm_sub_pd(py, dy);
+
+  const __m128d zero = _mm_setzero_pd();
+
+  __m128d dotA = _mm_add_pd(_mm_mul_pd(apx, abx), _mm_mul_pd(apy, aby));
+  __m128d dotB = _mm_sub_pd(zero, _mm_add_pd(_mm_mul_pd(bpx, abx), _mm_mul_pd(bpy, aby)));
+
+  __m128d distA = _mm_add_pd(_mm_mul_pd(apx, apx), _mm_mul_pd(apy, apy));
+  __m128d distB = _mm_add_pd(_mm_mul_pd(bpx, bpx), _mm_mul_pd(bpy, bpy));
+
+  //distance to the closest point on the interior of the segment
+  __m128d t  = _mm_div_pd(dotA, _mm_add_pd(dotA, dotB));
+  __m128d mx = _mm_sub_pd(apx, _mm_mul_pd(abx, t));
+  __m128d my = _mm_sub_pd(apy, _mm_mul_pd(aby, t));
+  __m128d distM = _mm_add_pd(_mm_mul_pd(mx, mx), _mm_mul_pd(my, my));
+
+  //select the end point distance where the closest point is A or B
+  __m128d useA = _mm_cmple_pd(dotA, zero);
+  __m128d useB = _mm_andnot_pd(useA, _mm_cmple_pd(dotB, zero));
+  __m128d useM = _mm_andnot_pd(_mm_or_pd(useA, useB), _mm_cmpeq_pd(zero, zero));
+
+  __m128d distSq = _mm_or_pd(_mm_or_pd(_mm_and_pd(useA, distA),
+                                       _mm_and_pd(useB, distB)),
+                                       _mm_and_pd(useM, distM));
+
+  return _mm_movemask_pd(_mm_cmplt_pd(distSq, rSq));
+}
+#endif
 
+inline int LineSegmentCircleIntersectionBatch4(Vector2D P,
+                                               double   radius,
+                                               const double* Cx, const double* Cy,
+                                               const double* Dx, const double* Dy)
+{
+#if defined(GEOMETRY_USE_AVX)
+
+  __m256d px  = _mm256_set1_pd(P.x);
+  __m256d py  = _mm256_set1_pd(P.y);
+  __m256d cx  = _mm256_loadu_pd(Cx);
+  __m256d cy  = _mm256_loadu_pd(Cy);
+  __m256d dx  = _mm256_loadu_pd(Dx);
+  __m256d dy  = _mm256_loadu_pd(Dy);
+
+  __m256d abx = _mm256_sub_pd(dx, cx);
+  __m256d aby = _mm256_sub_pd(dy, cy);
+  __m256d apx = _mm256_sub_pd(px, cx);
+  __m256d apy = _mm256_sub_pd(py, cy);
+  __m256d bpx = _mm256_sub_pd(px, dx);
+  __m256d bpy = _mm256_sub_pd(py, dy);
+
+  const __m256d zero = _mm256_setzero_pd();
+
+  __m256d dotA = _mm256_add_pd(_mm256_mul_pd(apx, abx), _mm256_mul_pd(apy, aby));
+  __m256d dotB = _mm256_sub_pd(zero, _mm256_add_pd(_mm256_mul_pd(bpx, abx), _mm256_mul_pd(bpy, aby)));
+
+  __m256d distA = _mm256_add_pd(_mm256_mul_pd(apx, apx), _mm256_mul_pd(apy, apy));
+  __m256d distB = _mm256_add_pd(_mm256_mul_pd(bpx, bpx), _mm256_mul_pd(bpy, bpy));
+
+  __m256d t  = _mm256_div_pd(dotA, _mm256_add_pd(dotA, dotB));
+  __m256d mx = _mm256_sub_pd(apx, _mm256_mul_pd(abx, t));
+  __m256d my = _mm256_sub_pd(apy, _mm256_mul_pd(aby, t));
+  __m256d distSq = _mm256_add_pd(_mm256_mul_pd(mx, mx), _mm256_mul_pd(my, my));
+
+  distSq = _mm256_blendv_pd(distSq, distB, _mm256_cmp_pd(dotB, zero, _CMP_LE_OQ));
+  distSq = _mm256_blendv_pd(distSq, distA, _mm256_cmp_pd(dotA, zero, _CMP_LE_OQ));
+
+  return _mm256_movemask_pd(_mm256_cmp_pd(distSq, _mm256_set1_pd(radius*radius), _CMP_LT_OQ));
+
+#elif defined(GEOMETRY_USE_SSE2)
+
+  __m128d px  = _mm_set1_pd(P.x);
+  __m128d py  = _mm_set1_pd(P.y);
+  __m128d rSq = _mm_set1_pd(radius*radius);
 
+  return  LineSegmentCircleIntersectionBatch2(px, py, rSq, Cx,   Cy,   Dx,   Dy) |
+         (LineSegmentCircleIntersectionBatch2(px, py, rSq, Cx+2, Cy+2, Dx+2, Dy+2) << 2);
 
+#else
 
+  int mask = 0;
+
+  for (int i=0; i<4; ++i)
+  {
+    if (LineSegmentCircleIntersection(Vector2D(Cx[i], Cy[i]), Vector2D(Dx[i], Dy[i]), P, radius))
+    {
+      mask |= 1 << i;
+    }
+  }
+
+  return mask;
+
+#endif
+}
+
+#endif
@@ -1,4 +1,5 @@
 #include "BaseGameEntity.h"
+#include "Game/EntityManager.h"
 
 
 int BaseGameEntity::m_iNextValidID = 0;
@@ -13,6 +14,16 @@ BaseGameEntity::BaseGameEntity(int ID):m_dBoundingRadius(0.0),
   SetID(ID);
 }
 
+//------------------------------ dtor -----------------------------------------
+//-----------------------------------------------------------------------------
+BaseGameEntity::~BaseGameEntity()
+{
+  if (!m_Handle.isNull())
+  {
+    EntityMgr->RemoveEntity(this);
+  }
+}
+
 //----------------------------- SetID -----------------------------------------
 //
 //  this must be called within each constructor to make sure the ID is set
@@ -17,6 +17,7 @@
 #include "2D/Vector2D.h"
 #include "2D/Geometry.h"
 #include "misc/utils.h"
+#include "Game/EntityHandle.h"
 
 
 
@@ -25,6 +26,9 @@ struct Telegram;
 
 class BaseGameEntity
 {
+  //the entity manager stamps each entity with its handle on registration
+  friend class EntityManager;
+
 public:
   
   enum {default_entity_type = -1};
@@ -40,6 +44,9 @@ private:
   //this is a generic flag. 
   bool        m_bTag;
 
+  //the entity's handle in the EntityManager. Null if it isn't registered
+  EntityHandle m_Handle;
+
   //this is the next valid ID. Each time a BaseGameEntity is instantiated
   //this value is updated
   static int  m_iNextValidID;
@@ -66,7 +73,8 @@ protected:
 
 public:
 
-  virtual ~BaseGameEntity(){}
+  //an entity still registered with the EntityManager is removed from it
+  virtual ~BaseGameEntity();
 
   virtual void Update(){}; 
 
@@ -92,6 +100,7 @@ public:
   double       BRadius()const{return m_dBoundingRadius;}
   void         SetBRadius(double r){m_dBoundingRadius = r;}
   int          ID()const{return m_ID;}
+  EntityHandle Handle()const{return m_Handle;}
 
   bool         IsTagged()const{return m_bTag;}
   void         Tag(){m_bTag = true;}
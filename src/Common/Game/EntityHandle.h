@@ -0,0 +1,46 @@
+#ifndef ENTITY_HANDLE_H
+#define ENTITY_HANDLE_H
+//------------------------------------------------------------------------
+//
+//  Name:   EntityHandle.h
+//
+//  Desc:   a handle to an entity registered with the EntityManager. It
+//          names a slot in the manager's table together with the
+//          generation of that slot at the time the entity was registered.
+//          Removing the entity bumps the slot's generation so any handles
+//          still referring to it resolve to NULL instead of dangling.
+//
+//------------------------------------------------------------------------
+
+
+struct EntityHandle
+{
+  //used as the index of a handle that refers to nothing
+  static const unsigned int NullIndex = 0xffffffff;
+
+  unsigned int  Index;
+  unsigned int  Generation;
+
+  EntityHandle():Index(NullIndex), Generation(0){}
+
+  EntityHandle(unsigned int index,
+               unsigned int generation):Index(index),
+                                        Generation(generation)
+  {}
+
+  bool isNull()const{return Index == NullIndex;}
+};
+
+
+inline bool operator==(const EntityHandle& h1, const EntityHandle& h2)
+{
+  return (h1.Index == h2.Index) && (h1.Generation == h2.Generation);
+}
+
+inline bool operator!=(const EntityHandle& h1, const EntityHandle& h2)
+{
+  return !(h1 == h2);
+}
+
+
+#endif
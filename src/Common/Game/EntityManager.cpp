@@ -17,25 +17,111 @@ EntityManager* EntityManager::Instance()
 //-----------------------------------------------------------------------------
 BaseGameEntity* EntityManager::GetEntityFromID(int id)const
 {
-  //find the entity
-  EntityMap::const_iterator ent = m_EntityMap.find(id);
+  //assert that the entity is a member of the table
+  assert ( (id >= 0) && (id < (int)m_IDToSlot.size()) && (m_IDToSlot[id] >= 0) &&
+           "<EntityManager::GetEntityFromID>: invalid ID");
 
-  //assert that the entity is a member of the map
-  assert ( (ent !=  m_EntityMap.end()) && "<EntityManager::GetEntityFromID>: invalid ID");
+  return TryGetEntityFromID(id);
+}
+
+//----------------------------- FreeSlot --------------------------------------
+//
+//  removes the slot's occupant from the packed table (by moving the last
+//  entity into its place) and puts the slot on the free list
+//-----------------------------------------------------------------------------
+void EntityManager::FreeSlot(unsigned int slot)
+{
+  EntitySlot& s = m_Slots[slot];
+
+  int last = (int)m_Entities.size()-1;
+
+  if (s.PackedIndex != last)
+  {
+    m_Entities[s.PackedIndex]     = m_Entities[last];
+    m_PackedToSlot[s.PackedIndex] = m_PackedToSlot[last];
+
+    m_Slots[m_PackedToSlot[s.PackedIndex]].PackedIndex = s.PackedIndex;
+  }
 
-  return ent->second;
+  m_Entities.pop_back();
+  m_PackedToSlot.pop_back();
+
+  s.pEntity     = NULL;
+  s.PackedIndex = -1;
+  ++s.Generation;
+
+  m_FreeSlots.push_back(slot);
 }
 
 //--------------------------- RemoveEntity ------------------------------------
 //-----------------------------------------------------------------------------
 void EntityManager::RemoveEntity(BaseGameEntity* pEntity)
 {    
-  m_EntityMap.erase(m_EntityMap.find(pEntity->ID()));
+  //the entity may have been registered before the last Reset
+  if (GetEntityFromHandle(pEntity->m_Handle) == pEntity)
+  {
+    FreeSlot(pEntity->m_Handle.Index);
+
+    m_IDToSlot[pEntity->ID()] = -1;
+  }
+
+  pEntity->m_Handle = EntityHandle();
 } 
 
 //---------------------------- RegisterEntity ---------------------------------
 //-----------------------------------------------------------------------------
-void EntityManager::RegisterEntity(BaseGameEntity* NewEntity)
+EntityHandle EntityManager::RegisterEntity(BaseGameEntity* NewEntity)
+{
+  int id = NewEntity->ID();
+
+  assert ( (id >= 0) && "<EntityManager::RegisterEntity>: invalid ID");
+
+  if (id >= (int)m_IDToSlot.size())
+  {
+    m_IDToSlot.resize(id+1, -1);
+  }
+
+  assert ( (m_IDToSlot[id] < 0) && "<EntityManager::RegisterEntity>: entity already registered");
+
+  //grab a vacant slot, or grow the table if there are none
+  unsigned int slot;
+
+  if (m_FreeSlots.empty())
+  {
+    slot = (unsigned int)m_Slots.size();
+
+    m_Slots.push_back(EntitySlot());
+  }
+  else
+  {
+    slot = m_FreeSlots.back();
+
+    m_FreeSlots.pop_back();
+  }
+
+  EntitySlot& s = m_Slots[slot];
+
+  s.pEntity     = NewEntity;
+  s.PackedIndex = (int)m_Entities.size();
+
+  m_Entities.push_back(NewEntity);
+  m_PackedToSlot.push_back(slot);
+
+  m_IDToSlot[id] = slot;
+
+  NewEntity->m_Handle = EntityHandle(slot, s.Generation);
+
+  return NewEntity->m_Handle;
+}
+
+//------------------------------- Reset ---------------------------------------
+//-----------------------------------------------------------------------------
+void EntityManager::Reset()
 {
-  m_EntityMap.insert(std::make_pair(NewEntity->ID(), NewEntity));
+  while (!m_Entities.empty())
+  {
+    FreeSlot(m_PackedToSlot.back());
+  }
+
+  m_IDToSlot.clear();
 }
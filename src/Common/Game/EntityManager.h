@@ -7,12 +7,21 @@
 //
 //  Desc:   Singleton class to handle the  management of Entities.          
 //
+//          Entities are held in a slot map. Registering an entity gives it
+//          an EntityHandle (see EntityHandle.h) which stays valid until the
+//          entity is removed, after which it resolves to NULL. Code that
+//          needs to hold on to another entity should keep its handle rather
+//          than a raw pointer. The live entities are also kept packed in a
+//          vector for iteration.
+//
 //  Author: Mat Buckland (fup@ai-junkie.com)
 //
 //------------------------------------------------------------------------
-#include <map>
+#include <vector>
 #include <cassert>
 
+#include "Game/EntityHandle.h"
+
 
 class BaseGameEntity;
 
@@ -25,13 +34,39 @@ class EntityManager
 {
 private:
 
-  typedef std::map<int, BaseGameEntity*> EntityMap;
+  struct EntitySlot
+  {
+    //the entity occupying the slot (NULL if the slot is free)
+    BaseGameEntity* pEntity;
+
+    //incremented each time the slot is vacated so that handles to the
+    //previous occupant no longer match
+    unsigned int    Generation;
+
+    //the position of the entity in the packed table
+    int             PackedIndex;
+
+    EntitySlot():pEntity(NULL), Generation(0), PackedIndex(-1){}
+  };
+
+  typedef std::vector<BaseGameEntity*> EntityTable;
 
 private:
 
-  //to facilitate quick lookup the entities are stored in a std::map, in which
-  //pointers to entities are cross referenced by their identifying number
-  EntityMap m_EntityMap;
+  //the slots handles refer to
+  std::vector<EntitySlot>   m_Slots;
+
+  //indices of the vacant slots, reused before the table is grown
+  std::vector<unsigned int> m_FreeSlots;
+
+  //the live entities packed together, and the slot each one occupies
+  EntityTable               m_Entities;
+  std::vector<unsigned int> m_PackedToSlot;
+
+  //entity IDs are handed out sequentially from zero so, to facilitate
+  //quick lookup by ID, this table is indexed by ID and holds the slot of
+  //the entity with that ID (or -1)
+  std::vector<int>          m_IDToSlot;
 
   EntityManager(){}
 
@@ -39,23 +74,52 @@ private:
   EntityManager(const EntityManager&);
   EntityManager& operator=(const EntityManager&);
 
+  //vacates the slot, invalidating any handles to its occupant
+  void            FreeSlot(unsigned int slot);
+
 public:
 
   static EntityManager* Instance();
 
-  //this method stores a pointer to the entity in the std::vector
-  //m_Entities at the index position indicated by the entity's ID
-  //(makes for faster access)
-  void            RegisterEntity(BaseGameEntity* NewEntity);
+  //this method stores a pointer to the entity in a free slot and returns
+  //the entity's handle (also available from BaseGameEntity::Handle)
+  EntityHandle    RegisterEntity(BaseGameEntity* NewEntity);
 
   //returns a pointer to the entity with the ID given as a parameter
   BaseGameEntity* GetEntityFromID(int id)const;
 
-  //this method removes the entity from the list
+  //as above, but for an ID that may belong to an entity that has since
+  //been removed. Returns NULL if there is no entity with the ID
+  BaseGameEntity* TryGetEntityFromID(int id)const
+  {
+    if ((id < 0) || (id >= (int)m_IDToSlot.size()) || (m_IDToSlot[id] < 0)) return NULL;
+
+    return m_Slots[m_IDToSlot[id]].pEntity;
+  }
+
+  //returns a pointer to the entity the handle refers to, or NULL if that
+  //entity has been removed
+  BaseGameEntity* GetEntityFromHandle(EntityHandle h)const
+  {
+    if ((h.Index < m_Slots.size()) && (m_Slots[h.Index].Generation == h.Generation))
+    {
+      return m_Slots[h.Index].pEntity;
+    }
+
+    return NULL;
+  }
+
+  //returns true if the handle refers to a registered entity
+  bool            isValid(EntityHandle h)const{return GetEntityFromHandle(h) != NULL;}
+
+  //this method removes the entity from the table
   void            RemoveEntity(BaseGameEntity* pEntity);
 
-  //clears all entities from the entity map
-  void            Reset(){m_EntityMap.clear();}
+  //the registered entities (in no particular order)
+  const EntityTable& GetEntities()const{return m_Entities;}
+
+  //clears all entities from the table. Handles to them become invalid
+  void            Reset();
 };
 
 
@@ -64,4 +128,4 @@ public:
 
 
 
-#endif
\ No newline at end of file
+#endif
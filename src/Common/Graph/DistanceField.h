@@ -0,0 +1,277 @@
+#ifndef DISTANCE_FIELD_H
+#define DISTANCE_FIELD_H
+#pragma warning (disable:4786)
+//-----------------------------------------------------------------------------
+//
+//  Name:   DistanceField.h
+//
+//  Desc:   the cost of the shortest path from every node of an undirected
+//          graph to the nearest of a set of source nodes, together with the
+//          source that is and the first edge of the path to it. Once built,
+//          each of these is a lookup.
+//
+//          Sources can be added and removed at any time. Adding one only
+//          reworks the nodes it is now the nearest source of, and removing
+//          one only the nodes it was the nearest source of, so a field can
+//          follow sources that come and go (items that respawn, for example)
+//          without being rebuilt.
+//
+//          A source can also be queued and the costs around it worked out a
+//          node at a time with PropagateOnce, so a field for a large graph
+//          can be built over several update-steps.
+//
+//          The field keeps a pointer to the graph it was built for, which
+//          must outlive it (or the next call to Build or Clear).
+//-----------------------------------------------------------------------------
+#include <vector>
+#include <queue>
+#include <functional>
+
+#include "graph/NodeTypeEnumerations.h"
+#include "misc/utils.h"
+
+
+template <class graph_type>
+class DistanceField
+{
+public:
+
+  typedef typename graph_type::EdgeType  EdgeType;
+
+private:
+
+  const graph_type*             m_pGraph;
+
+  //for each node, the cost to the nearest source, that source, and the
+  //first edge on the way there (NULL at a source or if there's no source)
+  std::vector<double>           m_Cost;
+  std::vector<int>              m_Source;
+  std::vector<const EdgeType*>  m_pNextEdge;
+
+  std::vector<char>             m_bIsSource;
+
+  int                           m_iNumSources;
+
+  //the nodes whose costs are being lowered, cheapest first. Kept between
+  //updates so they don't allocate
+  typedef std::pair<double, int> QueueEntry;
+
+  std::priority_queue<QueueEntry,
+                      std::vector<QueueEntry>,
+                      std::greater<QueueEntry> >  m_Queue;
+
+  std::vector<int>              m_Region;
+
+  //runs Dijkstra's algorithm outwards from the queued nodes, lowering the
+  //cost of any node it finds a cheaper way to a source from
+  void  Propagate(){while (PropagateOnce());}
+
+public:
+
+  DistanceField():m_pGraph(NULL), m_iNumSources(0){}
+
+  //sizes the field for G, with no sources
+  void    Build(const graph_type& G);
+
+  void    Clear();
+
+  bool    isBuilt()const{return m_pGraph != NULL;}
+
+  void    AddSource(int nd);
+  void    RemoveSource(int nd);
+
+  //makes nd a source without working out the costs around it. Until
+  //PropagateOnce has been called enough times to return false the field
+  //is incomplete
+  void    QueueSource(int nd);
+
+  //lowers the costs around the cheapest queued node. Returns false once
+  //there are no queued nodes left, when the field is complete
+  bool    PropagateOnce();
+
+  bool    isSource(int nd)const{return m_bIsSource[nd] != 0;}
+  int     NumSources()const{return m_iNumSources;}
+
+  //the cost of the cheapest path from nd to a source (MaxDouble if none
+  //can be reached)
+  double  Cost(int nd)const{return m_Cost[nd];}
+
+  //the nearest source to nd, or invalid_node_index
+  int     NearestSource(int nd)const{return m_Source[nd];}
+
+  //the first edge of the path from nd to its nearest source, or NULL
+  const EdgeType* NextEdge(int nd)const{return m_pNextEdge[nd];}
+
+  //the node after nd on the way to its nearest source (nd itself at a
+  //source), or invalid_node_index
+  int     NextHop(int nd)const
+  {
+    if (m_pNextEdge[nd]) return m_pNextEdge[nd]->To();
+
+    return m_bIsSource[nd] ? nd : invalid_node_index;
+  }
+};
+
+
+//--------------------------------- Build -------------------------------------
+//-----------------------------------------------------------------------------
+template <class graph_type>
+void DistanceField<graph_type>::Build(const graph_type& G)
+{
+  m_pGraph      = &G;
+  m_iNumSources = 0;
+
+  m_Cost.assign(G.NumNodes(), MaxDouble);
+  m_Source.assign(G.NumNodes(), invalid_node_index);
+  m_pNextEdge.assign(G.NumNodes(), (const EdgeType*)NULL);
+  m_bIsSource.assign(G.NumNodes(), 0);
+}
+
+//--------------------------------- Clear -------------------------------------
+//-----------------------------------------------------------------------------
+template <class graph_type>
+void DistanceField<graph_type>::Clear()
+{
+  m_pGraph      = NULL;
+  m_iNumSources = 0;
+
+  std::vector<double>().swap(m_Cost);
+  std::vector<int>().swap(m_Source);
+  std::vector<const EdgeType*>().swap(m_pNextEdge);
+  std::vector<char>().swap(m_bIsSource);
+}
+
+//----------------------------- PropagateOnce ---------------------------------
+//-----------------------------------------------------------------------------
+template <class graph_type>
+bool DistanceField<graph_type>::PropagateOnce()
+{
+  if (m_Queue.empty()) return false;
+
+  double cost = m_Queue.top().first;
+  int    nd   = m_Queue.top().second;
+
+  m_Queue.pop();
+
+  //skip the entries of nodes that have since been lowered further
+  if (cost > m_Cost[nd]) return true;
+
+  //the graph is undirected, so the edge back from each neighbour is the
+  //reverse of the edge to it
+  graph_type::ConstEdgeIterator ConstEdgeItr(*m_pGraph, nd);
+  for (const EdgeType* pE=ConstEdgeItr.begin();
+      !ConstEdgeItr.end();
+       pE=ConstEdgeItr.next())
+  {
+    int    to      = pE->To();
+    double NewCost = cost + pE->Cost();
+
+    if (NewCost < m_Cost[to])
+    {
+      m_Cost[to]   = NewCost;
+      m_Source[to] = m_Source[nd];
+
+      //find the edge leading back
+      graph_type::ConstEdgeIterator BackItr(*m_pGraph, to);
+      for (const EdgeType* pBack=BackItr.begin(); !BackItr.end(); pBack=BackItr.next())
+      {
+        if (pBack->To() == nd) {m_pNextEdge[to] = pBack; break;}
+      }
+
+      m_Queue.push(QueueEntry(NewCost, to));
+    }
+  }
+
+  return true;
+}
+
+//------------------------------- AddSource -----------------------------------
+//
+//  the new source is the nearest for the nodes it can lower the cost of
+//-----------------------------------------------------------------------------
+template <class graph_type>
+void DistanceField<graph_type>::AddSource(int nd)
+{
+  QueueSource(nd);
+
+  Propagate();
+}
+
+//------------------------------ QueueSource ----------------------------------
+//-----------------------------------------------------------------------------
+template <class graph_type>
+void DistanceField<graph_type>::QueueSource(int nd)
+{
+  if (m_bIsSource[nd]) return;
+
+  m_bIsSource[nd] = 1;
+  ++m_iNumSources;
+
+  m_Cost[nd]      = 0;
+  m_Source[nd]    = nd;
+  m_pNextEdge[nd] = NULL;
+
+  m_Queue.push(QueueEntry(0, nd));
+}
+
+//----------------------------- RemoveSource ----------------------------------
+//
+//  the nodes nd was the nearest source of are found (they are connected to
+//  it through each other) and their costs are worked out again from their
+//  neighbours outside that region, whose costs haven't changed
+//-----------------------------------------------------------------------------
+template <class graph_type>
+void DistanceField<graph_type>::RemoveSource(int nd)
+{
+  if (!m_bIsSource[nd]) return;
+
+  m_bIsSource[nd] = 0;
+  --m_iNumSources;
+
+  m_Region.clear();
+
+  m_Region.push_back(nd);
+  m_Source[nd] = invalid_node_index;
+
+  for (unsigned int i=0; i<m_Region.size(); ++i)
+  {
+    graph_type::ConstEdgeIterator ConstEdgeItr(*m_pGraph, m_Region[i]);
+    for (const EdgeType* pE=ConstEdgeItr.begin();
+        !ConstEdgeItr.end();
+         pE=ConstEdgeItr.next())
+    {
+      if (m_Source[pE->To()] == nd)
+      {
+        m_Source[pE->To()] = invalid_node_index;
+
+        m_Region.push_back(pE->To());
+      }
+    }
+  }
+
+  for (unsigned int i=0; i<m_Region.size(); ++i)
+  {
+    m_Cost[m_Region[i]]      = MaxDouble;
+    m_pNextEdge[m_Region[i]] = NULL;
+  }
+
+  //the region's border nodes start the search again
+  for (unsigned int i=0; i<m_Region.size(); ++i)
+  {
+    graph_type::ConstEdgeIterator ConstEdgeItr(*m_pGraph, m_Region[i]);
+    for (const EdgeType* pE=ConstEdgeItr.begin();
+        !ConstEdgeItr.end();
+         pE=ConstEdgeItr.next())
+    {
+      if (m_Source[pE->To()] != invalid_node_index)
+      {
+        m_Queue.push(QueueEntry(m_Cost[pE->To()], pE->To()));
+      }
+    }
+  }
+
+  Propagate();
+}
+
+
+#endif
@@ -0,0 +1,207 @@
+#ifndef FROZEN_GRAPH_H
+#define FROZEN_GRAPH_H
+#pragma warning (disable:4786)
+//-----------------------------------------------------------------------------
+//
+//  Name:   FrozenGraph.h
+//
+//  Desc:   a read-only snapshot of the edges of a SparseGraph, laid out in
+//          compressed sparse row form: all the edges of the graph sit in one
+//          contiguous array ordered by their from-node, and node n's edges
+//          are those between m_Offsets[n] and m_Offsets[n+1]. Walking a
+//          node's edges is then a pointer increment instead of a linked list
+//          traversal.
+//
+//          A FrozenGraph offers the parts of the SparseGraph interface used
+//          by the searches (NumNodes, GetNode, ConstEdgeIterator etc) so the
+//          search templates in GraphAlgorithms.h and
+//          TimeSlicedGraphAlgorithms.h can be instantiated with it directly.
+//          The edge pointers the searches return point into the snapshot.
+//
+//          Only the edges are copied. Nodes are read from the source graph,
+//          so changes to a node's extra info are seen straight away, but
+//          any change to the edges (or the addition/removal of nodes) needs
+//          a call to Build.
+//-----------------------------------------------------------------------------
+#include <vector>
+#include <cassert>
+
+#include "graph/NodeTypeEnumerations.h"
+
+
+template <class graph_type>
+class FrozenGraph
+{
+public:
+
+  typedef typename graph_type::EdgeType  EdgeType;
+  typedef typename graph_type::NodeType  NodeType;
+
+private:
+
+  const graph_type*       m_pSource;
+
+  //the edges of every node, in node order
+  std::vector<EdgeType>   m_Edges;
+
+  //node n's edges are m_Edges[m_Offsets[n]] to m_Edges[m_Offsets[n+1]-1]
+  std::vector<int>        m_Offsets;
+
+  //the indices of the active nodes, so iterating over them doesn't have to
+  //skip the removed ones
+  std::vector<int>        m_ActiveNodes;
+
+  bool                    m_bDigraph;
+
+  FrozenGraph(const FrozenGraph&);
+  FrozenGraph& operator=(const FrozenGraph&);
+
+public:
+
+  FrozenGraph():m_pSource(NULL), m_bDigraph(false){}
+
+  explicit FrozenGraph(const graph_type& G):m_pSource(NULL), m_bDigraph(false)
+  {
+    Build(G);
+  }
+
+  //takes a snapshot of G's edges. G must outlive the snapshot
+  void  Build(const graph_type& G)
+  {
+    m_pSource  = &G;
+    m_bDigraph = G.isDigraph();
+
+    m_Edges.clear();
+    m_Offsets.clear();
+    m_ActiveNodes.clear();
+
+    m_Edges.reserve(G.NumEdges());
+    m_Offsets.reserve(G.NumNodes() + 1);
+
+    for (int n=0; n<G.NumNodes(); ++n)
+    {
+      m_Offsets.push_back((int)m_Edges.size());
+
+      if (G.GetNode(n).Index() != invalid_node_index) m_ActiveNodes.push_back(n);
+
+      typename graph_type::ConstEdgeIterator EdgeItr(G, n);
+      for (const EdgeType* pE=EdgeItr.begin(); !EdgeItr.end(); pE=EdgeItr.next())
+      {
+        m_Edges.push_back(*pE);
+      }
+    }
+
+    m_Offsets.push_back((int)m_Edges.size());
+  }
+
+  void  Clear()
+  {
+    m_pSource = NULL;
+
+    m_Edges.clear();
+    m_Offsets.clear();
+    m_ActiveNodes.clear();
+  }
+
+  bool  isBuilt()const{return m_pSource != NULL;}
+
+  const graph_type& Source()const{return *m_pSource;}
+
+  //the SparseGraph interface used by the searches
+  int   NumNodes()const{return m_Offsets.empty() ? 0 : (int)m_Offsets.size() - 1;}
+  int   NumActiveNodes()const{return (int)m_ActiveNodes.size();}
+  int   NumEdges()const{return (int)m_Edges.size();}
+  bool  isDigraph()const{return m_bDigraph;}
+  bool  isEmpty()const{return NumNodes() == 0;}
+
+  const NodeType& GetNode(int idx)const{return m_pSource->GetNode(idx);}
+
+  bool  isNodePresent(int nd)const
+  {
+    return nd >= 0 && nd < NumNodes() && GetNode(nd).Index() != invalid_node_index;
+  }
+
+  //the range of node n's edges
+  const EdgeType* EdgesBegin(int n)const{return m_Edges.empty() ? NULL : &m_Edges[0] + m_Offsets[n];}
+  const EdgeType* EdgesEnd(int n)const{return m_Edges.empty() ? NULL : &m_Edges[0] + m_Offsets[n+1];}
+
+  int   NumEdges(int n)const{return m_Offsets[n+1] - m_Offsets[n];}
+
+  const std::vector<int>& ActiveNodes()const{return m_ActiveNodes;}
+
+
+  //iterates through the edges of a node, in the same order as the
+  //SparseGraph's ConstEdgeIterator
+  class ConstEdgeIterator
+  {
+  private:
+
+    const EdgeType*  curEdge;
+    const EdgeType*  first;
+    const EdgeType*  last;
+
+  public:
+
+    ConstEdgeIterator(const FrozenGraph& graph, int node):first(graph.EdgesBegin(node)),
+                                                          last(graph.EdgesEnd(node))
+    {
+      assert ( (node >= 0) && (node < graph.NumNodes()) &&
+               "<FrozenGraph::ConstEdgeIterator>: invalid node index");
+
+      curEdge = first;
+    }
+
+    const EdgeType*  begin()
+    {
+      curEdge = first;
+
+      return end() ? NULL : curEdge;
+    }
+
+    const EdgeType*  next()
+    {
+      ++curEdge;
+
+      return end() ? NULL : curEdge;
+    }
+
+    bool end()const{return curEdge == last;}
+  };
+
+  //iterates through the active nodes
+  class ConstNodeIterator
+  {
+  private:
+
+    const FrozenGraph&                 G;
+    std::vector<int>::const_iterator   curNode;
+
+  public:
+
+    ConstNodeIterator(const FrozenGraph& graph):G(graph)
+    {
+      curNode = G.m_ActiveNodes.begin();
+    }
+
+    const NodeType*  begin()
+    {
+      curNode = G.m_ActiveNodes.begin();
+
+      return end() ? NULL : &G.GetNode(*curNode);
+    }
+
+    const NodeType*  next()
+    {
+      ++curNode;
+
+      return end() ? NULL : &G.GetNode(*curNode);
+    }
+
+    bool end()const{return curNode == G.m_ActiveNodes.end();}
+  };
+
+  friend class ConstNodeIterator;
+};
+
+
+#endif
@@ -13,6 +13,10 @@
 //          with the SparseGraph class
 //-----------------------------------------------------------------------------
 #include <iostream>
+#include <vector>
+#include <algorithm>
+#include <thread>
+#include <atomic>
 
 #include "misc/Cgdi.h"
 #include "misc/utils.h"
@@ -28,7 +32,7 @@
 //
 //  returns true if x,y is a valid position in the map
 //------------------------------------------------------------------------
-bool ValidNeighbour(int x, int y, int NumCellsX, int NumCellsY)
+inline bool ValidNeighbour(int x, int y, int NumCellsX, int NumCellsY)
 {
   return !((x < 0) || (x >= NumCellsX) || (y < 0) || (y >= NumCellsY));
 }
@@ -202,50 +206,197 @@ void WeightNavGraphNodeEdges(graph_type& graph, int node, double weight)
 }
 
 
-//----------------------- CreateAllPairsTable ---------------------------------
+//------------------------- Graph_SingleSourceSearch -------------------------
 //
-// creates a lookup table encoding the shortest path info between each node
-// in a graph to every other
+//  the Dijkstra search used to build the all-pairs tables. It works like
+//  Graph_SearchDijkstra but keeps its vectors (and priority queue) between
+//  searches, so a worker building many rows of a table allocates nothing
+//  after its first search. It also records the order in which nodes were
+//  added to the SPT, which lets the first step of every path be found in
+//  a single pass.
 //-----------------------------------------------------------------------------
 template <class graph_type>
-std::vector<std::vector<int> > CreateAllPairsTable(const graph_type& G)
+class Graph_SingleSourceSearch
 {
-  enum {no_path = -1};
-  
-  std::vector<int> row(G.NumNodes(), no_path);
-  
-  std::vector<std::vector<int> > ShortestPaths(G.NumNodes(), row);
+private:
+
+  typedef typename graph_type::EdgeType Edge;
+
+  const graph_type&             m_Graph;
+
+  std::vector<const Edge*>      m_ShortestPathTree;
+  std::vector<const Edge*>      m_SearchFrontier;
+  std::vector<double>           m_CostToThisNode;
+
+  //the nodes in the order they were added to the SPT
+  std::vector<int>              m_SettledOrder;
 
-  for (int source=0; source<G.NumNodes(); ++source)
+  IndexedPriorityQLow<double>   m_PQ;
+
+  int                           m_iSource;
+
+public:
+
+  Graph_SingleSourceSearch(const graph_type& graph):m_Graph(graph),
+                                   m_ShortestPathTree(graph.NumNodes()),
+                                   m_SearchFrontier(graph.NumNodes()),
+                                   m_CostToThisNode(graph.NumNodes()),
+                                   m_PQ(m_CostToThisNode, graph.NumNodes()),
+                                   m_iSource(-1)
+  {
+    m_SettledOrder.reserve(graph.NumNodes());
+  }
+
+  void Search(int source)
   {
-    //calculate the SPT for this node
-    Graph_SearchDijkstra<graph_type> search(G, source);
+    m_iSource = source;
 
-    std::vector<const graph_type::EdgeType*> spt = search.GetSPT();
+    std::fill(m_ShortestPathTree.begin(), m_ShortestPathTree.end(), (const Edge*)0);
+    std::fill(m_SearchFrontier.begin(), m_SearchFrontier.end(), (const Edge*)0);
+    std::fill(m_CostToThisNode.begin(), m_CostToThisNode.end(), 0.0);
+    m_SettledOrder.clear();
 
-    //now we have the SPT it's easy to work backwards through it to find
-    //the shortest paths from each node to this source node
-    for (int target = 0; target<G.NumNodes(); ++target)
+    //the queue is always emptied by the previous search
+    m_PQ.insert(source);
+
+    while (!m_PQ.empty())
     {
-      //if the source node is the same as the target just set to target
-      if (source == target)
-      {
-        ShortestPaths[source][target] = target;
-      }
+      int NextClosestNode = m_PQ.Pop();
 
-      else
+      m_ShortestPathTree[NextClosestNode] = m_SearchFrontier[NextClosestNode];
+      m_SettledOrder.push_back(NextClosestNode);
+
+      graph_type::ConstEdgeIterator ConstEdgeItr(m_Graph, NextClosestNode);
+      for (const Edge* pE=ConstEdgeItr.begin(); !ConstEdgeItr.end(); pE=ConstEdgeItr.next())
       {
-        int nd = target;
+        double NewCost = m_CostToThisNode[NextClosestNode] + pE->Cost();
 
-        while ((nd != source) && (spt[nd] != 0))
+        if (m_SearchFrontier[pE->To()] == 0 && pE->To() != source)
         {
-          ShortestPaths[spt[nd]->From][target]= nd;
+          m_CostToThisNode[pE->To()] = NewCost;
 
-          nd = spt[nd]->From;
+          m_PQ.insert(pE->To());
+
+          m_SearchFrontier[pE->To()] = pE;
+        }
+
+        else if ( (NewCost < m_CostToThisNode[pE->To()]) &&
+                  (m_ShortestPathTree[pE->To()] == 0) && pE->To() != source)
+        {
+          m_CostToThisNode[pE->To()] = NewCost;
+
+          m_PQ.ChangePriority(pE->To());
+
+          m_SearchFrontier[pE->To()] = pE;
         }
       }
-    }//next target node
-  }//next source node
+    }
+  }
+
+  double GetCostToNode(int nd)const{return m_CostToThisNode[nd];}
+
+  //true if the last search found a path to nd
+  bool   isReached(int nd)const{return nd == m_iSource || m_SearchFrontier[nd] != 0;}
+
+  //fills row with the first node to visit on the shortest path from the
+  //source to each node (no_path if there isn't a path)
+  void GetFirstSteps(std::vector<int>& row, int no_path)const
+  {
+    std::fill(row.begin(), row.end(), no_path);
+
+    //a node's parent on the SPT is always settled before the node itself,
+    //so its first step is known by the time the node is reached
+    for (unsigned int i=0; i<m_SettledOrder.size(); ++i)
+    {
+      int nd = m_SettledOrder[i];
+
+      if (nd == m_iSource)
+      {
+        row[nd] = nd;
+      }
+
+      else
+      {
+        int parent = m_ShortestPathTree[nd]->From();
+
+        row[nd] = (parent == m_iSource) ? nd : row[parent];
+      }
+    }
+  }
+};
+
+
+//------------------------ ForEachSourceInParallel ----------------------------
+//
+//  calls RowFunc(search, source) for every node index in the graph, sharing
+//  the sources out between NumThreads worker threads (0 means one per
+//  hardware thread). Each worker owns a Graph_SingleSourceSearch which it
+//  reuses for every source it takes, and the sources are handed out one at
+//  a time so the workers stay busy whatever the shape of the graph. RowFunc
+//  must only write to data belonging to its source.
+//-----------------------------------------------------------------------------
+template <class graph_type, class row_func>
+void ForEachSourceInParallel(const graph_type& G, row_func RowFunc, int NumThreads = 0)
+{
+  const int NumSources = G.NumNodes();
+
+  if (NumThreads <= 0) NumThreads = (int)std::thread::hardware_concurrency();
+  if (NumThreads > NumSources) NumThreads = NumSources;
+  if (NumThreads < 1) NumThreads = 1;
+
+  std::atomic<int> NextSource(0);
+
+  auto Worker = [&]()
+  {
+    Graph_SingleSourceSearch<graph_type> search(G);
+
+    for (int source = NextSource++; source < NumSources; source = NextSource++)
+    {
+      search.Search(source);
+
+      RowFunc(search, source);
+    }
+  };
+
+  //the calling thread does its share of the work too
+  std::vector<std::thread> workers;
+
+  for (int t=1; t<NumThreads; ++t)
+  {
+    workers.push_back(std::thread(Worker));
+  }
+
+  Worker();
+
+  for (unsigned int t=0; t<workers.size(); ++t)
+  {
+    workers[t].join();
+  }
+}
+
+
+//----------------------- CreateAllPairsTable ---------------------------------
+//
+// creates a lookup table encoding the shortest path info between each node
+// in a graph to every other. ShortestPaths[source][target] is the first node
+// to visit when travelling from source to target (or no_path).
+//-----------------------------------------------------------------------------
+template <class graph_type>
+std::vector<std::vector<int> > CreateAllPairsTable(const graph_type& G,
+                                                   int NumThreads = 0)
+{
+  enum {no_path = -1};
+  
+  std::vector<int> row(G.NumNodes(), no_path);
+  
+  std::vector<std::vector<int> > ShortestPaths(G.NumNodes(), row);
+
+  ForEachSourceInParallel(G,
+    [&](const Graph_SingleSourceSearch<graph_type>& search, int source)
+    {
+      search.GetFirstSteps(ShortestPaths[source], no_path);
+    },
+    NumThreads);
 
   return ShortestPaths;
 }
@@ -257,28 +408,26 @@ std::vector<std::vector<int> > CreateAllPairsTable(const graph_type& G)
 //  node to every other
 //-----------------------------------------------------------------------------
 template <class graph_type>
-std::vector<std::vector<double> > CreateAllPairsCostsTable(const graph_type& G)
+std::vector<std::vector<double> > CreateAllPairsCostsTable(const graph_type& G,
+                                                           int NumThreads = 0)
 {
   //create a two dimensional vector
   std::vector<double> row(G.NumNodes(), 0.0);
   std::vector<std::vector<double> > PathCosts(G.NumNodes(), row);
 
-  for (int source=0; source<G.NumNodes(); ++source)
-  {
-    //do the search
-    Graph_SearchDijkstra<graph_type> search(G, source);
-
-    //iterate through every node in the graph and grab the cost to travel to
-    //that node
-    for (int target = 0; target<G.NumNodes(); ++target)
+  ForEachSourceInParallel(G,
+    [&](const Graph_SingleSourceSearch<graph_type>& search, int source)
     {
-      if (source != target)
+      //grab the cost to travel to every node in the graph
+      for (int target = 0; target<G.NumNodes(); ++target)
       {
-        PathCosts[source][target]= search.GetCostToNode(target);
+        if (source != target)
+        {
+          PathCosts[source][target]= search.GetCostToNode(target);
+        }
       }
-    }//next target node
-    
-  }//next source node
+    },
+    NumThreads);
 
   return PathCosts;
 }
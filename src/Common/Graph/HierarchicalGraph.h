@@ -0,0 +1,394 @@
+#ifndef HIERARCHICAL_GRAPH_H
+#define HIERARCHICAL_GRAPH_H
+#pragma warning (disable:4786)
+//-----------------------------------------------------------------------------
+//
+//  Name:   HierarchicalGraph.h
+//
+//  Desc:   an abstraction of a navgraph for hierarchical path planning (HPA*).
+//
+//          The nodes of the graph are grouped into clusters by laying a grid
+//          of square cells over the map. A node with an edge leading into
+//          another cluster is an entrance, and the abstract graph links the
+//          entrances by
+//
+//            - the edges that cross between clusters, and
+//            - for each pair of entrances of the same cluster, an edge whose
+//              cost is that of the shortest path between them that stays
+//              inside the cluster
+//
+//          A search of the abstract graph visits only entrances, so it is far
+//          cheaper than a search of the full graph. Each abstract edge of the
+//          resulting path can later be refined into graph edges with
+//          RefineEdge, which only searches the one cluster.
+//
+//          The graph must be undirected and its node positions are used to
+//          assign clusters. The restricted searches share scratch storage,
+//          which is locked while a query uses it, so once built the graph
+//          may be queried from several threads (Build and Clear may not).
+//-----------------------------------------------------------------------------
+#include <vector>
+#include <map>
+#include <queue>
+#include <functional>
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <mutex>
+
+#include "graph/NodeTypeEnumerations.h"
+
+
+template <class graph_type>
+class HierarchicalGraph
+{
+public:
+
+  typedef typename graph_type::EdgeType EdgeType;
+
+  //an edge of the abstract graph
+  struct AbstractEdge
+  {
+    int              m_iFrom;
+    int              m_iTo;
+    double           m_dCost;
+
+    //the graph edge if this edge crosses between clusters, or NULL if it
+    //stands for a path through a cluster
+    const EdgeType*  m_pEdge;
+
+    AbstractEdge(int from, int to, double cost, const EdgeType* pEdge):m_iFrom(from),
+                                                                      m_iTo(to),
+                                                                      m_dCost(cost),
+                                                                      m_pEdge(pEdge)
+    {}
+
+    int    From()const{return m_iFrom;}
+    int    To()const{return m_iTo;}
+    double Cost()const{return m_dCost;}
+    bool   isInterCluster()const{return m_pEdge != NULL;}
+  };
+
+  typedef std::vector<AbstractEdge> AbstractEdgeList;
+
+private:
+
+  const graph_type*               m_pGraph;
+
+  double                          m_dClusterSize;
+
+  //the cluster of every node (-1 for removed nodes)
+  std::vector<int>                m_NodeCluster;
+
+  //the entrances of each cluster
+  std::vector<std::vector<int> >  m_ClusterEntrances;
+
+  //the abstract edges leaving each node (only entrances have any)
+  std::vector<AbstractEdgeList>   m_AbstractEdges;
+
+  int                             m_iNumAbstractEdges;
+
+  //scratch storage for the restricted searches. An entry is only valid if
+  //its stamp matches m_iGeneration
+  mutable std::vector<double>           m_Costs;
+  mutable std::vector<const EdgeType*>  m_Parents;
+  mutable std::vector<unsigned int>     m_Stamps;
+  mutable unsigned int                  m_iGeneration;
+
+  //held by ConnectToCluster, CostInsideCluster and RefineEdge while they
+  //use the scratch storage
+  mutable std::mutex                    m_ScratchMutex;
+
+
+  //Dijkstra from source that never leaves source's cluster. If target is
+  //not negative the search stops as soon as the target is reached. Returns
+  //false if target was given and not reached. The costs and parent edges
+  //are left in the scratch storage
+  bool SearchCluster(int source, int target)const;
+
+  bool Reached(int nd)const{return m_Stamps[nd] == m_iGeneration;}
+
+  HierarchicalGraph(const HierarchicalGraph&);
+  HierarchicalGraph& operator=(const HierarchicalGraph&);
+
+public:
+
+  HierarchicalGraph():m_pGraph(NULL),
+                      m_dClusterSize(0),
+                      m_iNumAbstractEdges(0),
+                      m_iGeneration(0)
+  {}
+
+  //clusters G into square cells ClusterSize wide and builds the abstract
+  //graph. G must outlive the hierarchy
+  void Build(const graph_type& G, double ClusterSize);
+
+  void Clear();
+
+  const graph_type& Graph()const{return *m_pGraph;}
+
+  int  ClusterOf(int nd)const{return m_NodeCluster[nd];}
+  int  NumClusters()const{return (int)m_ClusterEntrances.size();}
+  int  NumAbstractEdges()const{return m_iNumAbstractEdges;}
+  double ClusterSize()const{return m_dClusterSize;}
+
+  const std::vector<int>& Entrances(int cluster)const{return m_ClusterEntrances[cluster];}
+
+  bool isEntrance(int nd)const{return !m_AbstractEdges[nd].empty();}
+
+  const AbstractEdgeList& AbstractEdges(int nd)const{return m_AbstractEdges[nd];}
+
+  //appends to edges an abstract edge between nd and every entrance of its
+  //cluster that can be reached without leaving the cluster. If ToNode is
+  //true the edges lead from the entrances to nd, otherwise from nd to the
+  //entrances
+  void ConnectToCluster(int nd, bool ToNode, AbstractEdgeList& edges)const;
+
+  //if from and to share a cluster and there's a path between them inside it,
+  //returns true and sets cost to its cost
+  bool CostInsideCluster(int from, int to, double& cost)const;
+
+  //appends the graph edges making up the abstract edge to path. Returns
+  //false if the edge no longer has a path (the graph has changed)
+  bool RefineEdge(const AbstractEdge& edge, std::vector<const EdgeType*>& path)const;
+};
+
+
+//-------------------------------- Build --------------------------------------
+//-----------------------------------------------------------------------------
+template <class graph_type>
+void HierarchicalGraph<graph_type>::Build(const graph_type& G, double ClusterSize)
+{
+  assert (!G.isDigraph() && "<HierarchicalGraph::Build>: the graph must be undirected");
+  assert (ClusterSize > 0 && "<HierarchicalGraph::Build>: invalid cluster size");
+
+  Clear();
+
+  m_pGraph       = &G;
+  m_dClusterSize = ClusterSize;
+
+  const int NumNodes = G.NumNodes();
+
+  m_NodeCluster.assign(NumNodes, -1);
+  m_AbstractEdges.assign(NumNodes, AbstractEdgeList());
+
+  m_Costs.assign(NumNodes, 0.0);
+  m_Parents.assign(NumNodes, (const EdgeType*)NULL);
+  m_Stamps.assign(NumNodes, 0);
+
+  //give each occupied grid cell a cluster index
+  std::map<std::pair<int, int>, int> CellToCluster;
+
+  for (int n=0; n<NumNodes; ++n)
+  {
+    if (G.GetNode(n).Index() == invalid_node_index) continue;
+
+    std::pair<int, int> cell((int)floor(G.GetNode(n).Pos().x / ClusterSize),
+                             (int)floor(G.GetNode(n).Pos().y / ClusterSize));
+
+    std::map<std::pair<int, int>, int>::iterator it = CellToCluster.find(cell);
+
+    if (it == CellToCluster.end())
+    {
+      it = CellToCluster.insert(std::make_pair(cell, (int)CellToCluster.size())).first;
+    }
+
+    m_NodeCluster[n] = it->second;
+  }
+
+  m_ClusterEntrances.assign(CellToCluster.size(), std::vector<int>());
+
+  //the edges crossing between clusters make the entrances, and are abstract
+  //edges themselves
+  for (int n=0; n<NumNodes; ++n)
+  {
+    if (m_NodeCluster[n] < 0) continue;
+
+    typename graph_type::ConstEdgeIterator EdgeItr(G, n);
+    for (const EdgeType* pE=EdgeItr.begin(); !EdgeItr.end(); pE=EdgeItr.next())
+    {
+      if (m_NodeCluster[pE->To()] != m_NodeCluster[n])
+      {
+        if (m_AbstractEdges[n].empty()) m_ClusterEntrances[m_NodeCluster[n]].push_back(n);
+
+        m_AbstractEdges[n].push_back(AbstractEdge(n, pE->To(), pE->Cost(), pE));
+      }
+    }
+  }
+
+  //link the entrances of each cluster by the paths through it
+  for (int c=0; c<NumClusters(); ++c)
+  {
+    const std::vector<int>& entrances = m_ClusterEntrances[c];
+
+    for (unsigned int e=0; e<entrances.size(); ++e)
+    {
+      SearchCluster(entrances[e], -1);
+
+      for (unsigned int f=0; f<entrances.size(); ++f)
+      {
+        if (e != f && Reached(entrances[f]))
+        {
+          m_AbstractEdges[entrances[e]].push_back(AbstractEdge(entrances[e],
+                                                               entrances[f],
+                                                               m_Costs[entrances[f]],
+                                                               NULL));
+        }
+      }
+    }
+  }
+
+  for (int n=0; n<NumNodes; ++n) m_iNumAbstractEdges += (int)m_AbstractEdges[n].size();
+}
+
+//-------------------------------- Clear --------------------------------------
+//-----------------------------------------------------------------------------
+template <class graph_type>
+void HierarchicalGraph<graph_type>::Clear()
+{
+  m_pGraph = NULL;
+
+  m_NodeCluster.clear();
+  m_ClusterEntrances.clear();
+  m_AbstractEdges.clear();
+  m_iNumAbstractEdges = 0;
+
+  m_Costs.clear();
+  m_Parents.clear();
+  m_Stamps.clear();
+}
+
+//---------------------------- SearchCluster ----------------------------------
+//-----------------------------------------------------------------------------
+template <class graph_type>
+bool HierarchicalGraph<graph_type>::SearchCluster(int source, int target)const
+{
+  if (++m_iGeneration == 0)
+  {
+    std::fill(m_Stamps.begin(), m_Stamps.end(), 0);
+
+    m_iGeneration = 1;
+  }
+
+  const int cluster = m_NodeCluster[source];
+
+  typedef std::pair<double, int> QueueEntry;
+
+  std::priority_queue<QueueEntry, std::vector<QueueEntry>, std::greater<QueueEntry> > pq;
+
+  m_Stamps[source]  = m_iGeneration;
+  m_Costs[source]   = 0.0;
+  m_Parents[source] = NULL;
+
+  pq.push(QueueEntry(0.0, source));
+
+  while (!pq.empty())
+  {
+    QueueEntry next = pq.top(); pq.pop();
+
+    //skip entries superseded by a cheaper one
+    if (next.first > m_Costs[next.second]) continue;
+
+    if (next.second == target) return true;
+
+    typename graph_type::ConstEdgeIterator EdgeItr(*m_pGraph, next.second);
+    for (const EdgeType* pE=EdgeItr.begin(); !EdgeItr.end(); pE=EdgeItr.next())
+    {
+      int to = pE->To();
+
+      if (m_NodeCluster[to] != cluster) continue;
+
+      double cost = next.first + pE->Cost();
+
+      if (!Reached(to) || cost < m_Costs[to])
+      {
+        m_Stamps[to]  = m_iGeneration;
+        m_Costs[to]   = cost;
+        m_Parents[to] = pE;
+
+        pq.push(QueueEntry(cost, to));
+      }
+    }
+  }
+
+  return target < 0;
+}
+
+//--------------------------- ConnectToCluster --------------------------------
+//-----------------------------------------------------------------------------
+template <class graph_type>
+void HierarchicalGraph<graph_type>::ConnectToCluster(int               nd,
+                                                     bool              ToNode,
+                                                     AbstractEdgeList& edges)const
+{
+  if (m_NodeCluster[nd] < 0) return;
+
+  std::lock_guard<std::mutex> lock(m_ScratchMutex);
+
+  //the graph is undirected so the cost from an entrance to nd is the same as
+  //the cost from nd to the entrance
+  SearchCluster(nd, -1);
+
+  const std::vector<int>& entrances = m_ClusterEntrances[m_NodeCluster[nd]];
+
+  for (unsigned int e=0; e<entrances.size(); ++e)
+  {
+    int entrance = entrances[e];
+
+    if (entrance == nd || !Reached(entrance)) continue;
+
+    if (ToNode) edges.push_back(AbstractEdge(entrance, nd, m_Costs[entrance], NULL));
+    else        edges.push_back(AbstractEdge(nd, entrance, m_Costs[entrance], NULL));
+  }
+}
+
+//--------------------------- CostInsideCluster -------------------------------
+//-----------------------------------------------------------------------------
+template <class graph_type>
+bool HierarchicalGraph<graph_type>::CostInsideCluster(int from, int to, double& cost)const
+{
+  if (m_NodeCluster[from] < 0 || m_NodeCluster[from] != m_NodeCluster[to]) return false;
+
+  std::lock_guard<std::mutex> lock(m_ScratchMutex);
+
+  if (!SearchCluster(from, to)) return false;
+
+  cost = m_Costs[to];
+
+  return true;
+}
+
+//------------------------------ RefineEdge -----------------------------------
+//-----------------------------------------------------------------------------
+template <class graph_type>
+bool HierarchicalGraph<graph_type>::RefineEdge(const AbstractEdge&            edge,
+                                               std::vector<const EdgeType*>&  path)const
+{
+  if (edge.isInterCluster())
+  {
+    path.push_back(edge.m_pEdge);
+
+    return true;
+  }
+
+  if (edge.From() == edge.To()) return true;
+
+  std::lock_guard<std::mutex> lock(m_ScratchMutex);
+
+  if (!SearchCluster(edge.From(), edge.To())) return false;
+
+  //work back from the target then reverse the new part of the path
+  unsigned int first = path.size();
+
+  for (int nd = edge.To(); nd != edge.From(); nd = m_Parents[nd]->From())
+  {
+    path.push_back(m_Parents[nd]);
+  }
+
+  std::reverse(path.begin() + first, path.end());
+
+  return true;
+}
+
+
+#endif
@@ -0,0 +1,168 @@
+#ifndef LANDMARK_TABLE_H
+#define LANDMARK_TABLE_H
+#pragma warning (disable:4786)
+//-----------------------------------------------------------------------------
+//
+//  Name:   LandmarkTable.h
+//
+//  Desc:   the shortest path costs from a handful of landmark nodes to every
+//          node of an undirected graph, for the ALT heuristic (see
+//          Heuristic_ALT in AStarHeuristicPolicies.h).
+//
+//          By the triangle inequality the cost of the shortest path between
+//          a and b is at least |d(L,a) - d(L,b)| for any landmark L, and with
+//          walls in the way this bound is usually much tighter than the
+//          straight line distance. It works best with landmarks on the edges
+//          of the map, so they are picked one at a time as the node farthest
+//          (by path cost) from the landmarks already chosen.
+//-----------------------------------------------------------------------------
+#include <vector>
+#include <cassert>
+#include <cmath>
+
+#include "graph/NodeTypeEnumerations.h"
+#include "Graph/HandyGraphFunctions.h"
+#include "misc/utils.h"
+
+
+template <class graph_type>
+class LandmarkTable
+{
+private:
+
+  const graph_type*     m_pGraph;
+
+  int                   m_iNumNodes;
+
+  std::vector<int>      m_Landmarks;
+
+  //m_Costs[k*m_iNumNodes + n] is the cost of the shortest path between
+  //landmark k and node n, or negative if there isn't one
+  std::vector<double>   m_Costs;
+
+  LandmarkTable(const LandmarkTable&);
+  LandmarkTable& operator=(const LandmarkTable&);
+
+public:
+
+  LandmarkTable():m_pGraph(NULL), m_iNumNodes(0){}
+
+  //picks NumLandmarks landmarks and calculates their costs. G must outlive
+  //the table
+  void   Build(const graph_type& G, int NumLandmarks);
+
+  void   Clear();
+
+  bool   isBuiltFor(const graph_type& G)const{return m_pGraph == &G;}
+
+  //a lower bound on the cost of the shortest path between nd1 and nd2
+  double LowerBound(int nd1, int nd2)const
+  {
+    double bound = 0.0;
+
+    for (unsigned int k=0; k<m_Landmarks.size(); ++k)
+    {
+      const double* costs = &m_Costs[(size_t)k*m_iNumNodes];
+
+      if (costs[nd1] < 0 || costs[nd2] < 0) continue;
+
+      double diff = fabs(costs[nd1] - costs[nd2]);
+
+      if (diff > bound) bound = diff;
+    }
+
+    return bound;
+  }
+
+  int    NumLandmarks()const{return (int)m_Landmarks.size();}
+  int    Landmark(int k)const{return m_Landmarks[k];}
+
+  size_t MemoryUsed()const{return m_Costs.capacity() * sizeof(double);}
+};
+
+
+//--------------------------------- Build -------------------------------------
+//-----------------------------------------------------------------------------
+template <class graph_type>
+void LandmarkTable<graph_type>::Build(const graph_type& G, int NumLandmarks)
+{
+  assert (!G.isDigraph() && "<LandmarkTable::Build>: the graph must be undirected");
+
+  Clear();
+
+  m_pGraph    = &G;
+  m_iNumNodes = G.NumNodes();
+
+  //the cost from each node to the closest landmark chosen so far. Nodes
+  //no landmark can reach are the first choice for the next one
+  std::vector<double> ClosestLandmark(m_iNumNodes, MaxDouble);
+
+  Graph_SingleSourceSearch<graph_type> search(G);
+
+  //start from the node farthest from an arbitrary one
+  int next = invalid_node_index;
+
+  for (int n=0; n<m_iNumNodes; ++n)
+  {
+    if (G.GetNode(n).Index() != invalid_node_index){next = n; break;}
+  }
+
+  if (next == invalid_node_index) return;
+
+  search.Search(next);
+
+  for (int n=0; n<m_iNumNodes; ++n)
+  {
+    if (search.isReached(n) && search.GetCostToNode(n) > search.GetCostToNode(next)) next = n;
+  }
+
+  while ((int)m_Landmarks.size() < NumLandmarks)
+  {
+    m_Landmarks.push_back(next);
+
+    search.Search(next);
+
+    m_Costs.resize(m_Costs.size() + m_iNumNodes);
+
+    double* costs = &m_Costs[m_Costs.size() - m_iNumNodes];
+
+    for (int n=0; n<m_iNumNodes; ++n)
+    {
+      costs[n] = search.isReached(n) ? search.GetCostToNode(n) : -1.0;
+
+      if (costs[n] >= 0 && costs[n] < ClosestLandmark[n]) ClosestLandmark[n] = costs[n];
+    }
+
+    //the next landmark is the node farthest from all those chosen
+    double farthest = 0;
+
+    next = invalid_node_index;
+
+    for (int n=0; n<m_iNumNodes; ++n)
+    {
+      if (G.GetNode(n).Index() != invalid_node_index && ClosestLandmark[n] > farthest)
+      {
+        farthest = ClosestLandmark[n];
+        next     = n;
+      }
+    }
+
+    //every node is a landmark
+    if (next == invalid_node_index) break;
+  }
+}
+
+//--------------------------------- Clear -------------------------------------
+//-----------------------------------------------------------------------------
+template <class graph_type>
+void LandmarkTable<graph_type>::Clear()
+{
+  m_pGraph    = NULL;
+  m_iNumNodes = 0;
+
+  m_Landmarks.clear();
+  std::vector<double>().swap(m_Costs);
+}
+
+
+#endif
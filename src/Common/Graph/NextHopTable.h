@@ -0,0 +1,178 @@
+#ifndef NEXT_HOP_TABLE_H
+#define NEXT_HOP_TABLE_H
+#pragma warning (disable:4786)
+//-----------------------------------------------------------------------------
+//
+//  Name:   NextHopTable.h
+//
+//  Desc:   a routing table giving, for every pair of nodes in a graph, the
+//          first node to visit on the shortest path from one to the other.
+//          The path between any two nodes is found by looking up the next
+//          node until the target is reached, with no search at all.
+//
+//          This is the table CreateAllPairsTable makes, but each entry is
+//          held in 16 bits rather than in an int of a vector per row, so a
+//          table for N nodes takes N*N*2 bytes. That limits it to graphs of
+//          fewer than 65535 nodes, and in practice to a few thousand.
+//
+//          The table keeps a reference to the graph it was built from, which
+//          must outlive it (or the next call to Build or Clear).
+//-----------------------------------------------------------------------------
+#include <vector>
+
+#include "Graph/HandyGraphFunctions.h"
+#include "graph/NodeTypeEnumerations.h"
+
+
+template <class graph_type>
+class NextHopTable
+{
+public:
+
+  typedef typename graph_type::EdgeType  EdgeType;
+
+private:
+
+  //marks a pair of nodes with no path between them
+  enum {no_path = 0xFFFF};
+
+  const graph_type*            m_pGraph;
+
+  int                          m_iNumNodes;
+
+  //the next node from source to target is at [source * m_iNumNodes + target]
+  //(worked out in size_t, as it overflows an int above 46340 nodes)
+  std::vector<unsigned short>  m_NextHop;
+
+public:
+
+  NextHopTable():m_pGraph(NULL), m_iNumNodes(0){}
+
+  //fills in the table for G, running a search from every node spread
+  //across NumThreads threads (0 means one per hardware thread). Returns
+  //false, leaving the table empty, if G has too many nodes
+  bool  Build(const graph_type& G, int NumThreads = 0);
+
+  //fills in the table for G with the entries of a table built earlier for
+  //the same graph (see Entries), rather than searching. Returns false,
+  //leaving the table empty, if G has too many nodes
+  bool  Assign(const graph_type& G, const unsigned short* entries);
+
+  void  Clear();
+
+  bool  isBuilt()const{return m_pGraph != NULL;}
+
+  //the entries of the table, a row of NumNodes per source, or NULL if it
+  //isn't built
+  const unsigned short* Entries()const{return m_NextHop.empty() ? NULL : &m_NextHop[0];}
+
+  //returns the node after source on the shortest path to target (target if
+  //source is target), or invalid_node_index if there's no path
+  int   NextHop(int source, int target)const
+  {
+    unsigned short next = m_NextHop[(size_t)source * m_iNumNodes + target];
+
+    return next == no_path ? invalid_node_index : next;
+  }
+
+  //the edge from source to the next node on the way to target, or NULL
+  const EdgeType* NextEdge(int source, int target)const;
+
+  //the memory used by the table, in bytes
+  size_t SizeInBytes()const{return m_NextHop.size() * sizeof(unsigned short);}
+};
+
+
+//---------------------------------- Build ------------------------------------
+//-----------------------------------------------------------------------------
+template <class graph_type>
+bool NextHopTable<graph_type>::Build(const graph_type& G, int NumThreads)
+{
+  Clear();
+
+  if (G.NumNodes() >= no_path) return false;
+
+  m_iNumNodes = G.NumNodes();
+
+  m_NextHop.assign((size_t)m_iNumNodes * m_iNumNodes, (unsigned short)no_path);
+
+  //each search writes only its own source's row
+  ForEachSourceInParallel(G,
+    [&](const Graph_SingleSourceSearch<graph_type>& search, int source)
+    {
+      std::vector<int> row(m_iNumNodes);
+
+      search.GetFirstSteps(row, no_path);
+
+      unsigned short* pRow = &m_NextHop[(size_t)source * m_iNumNodes];
+
+      for (int target=0; target<m_iNumNodes; ++target)
+      {
+        pRow[target] = (unsigned short)row[target];
+      }
+    },
+    NumThreads);
+
+  m_pGraph = &G;
+
+  return true;
+}
+
+//---------------------------------- Assign -----------------------------------
+//-----------------------------------------------------------------------------
+template <class graph_type>
+bool NextHopTable<graph_type>::Assign(const graph_type& G, const unsigned short* entries)
+{
+  Clear();
+
+  if (G.NumNodes() >= no_path) return false;
+
+  m_iNumNodes = G.NumNodes();
+
+  m_NextHop.assign(entries, entries + (size_t)m_iNumNodes * m_iNumNodes);
+
+  m_pGraph = &G;
+
+  return true;
+}
+
+//---------------------------------- Clear ------------------------------------
+//-----------------------------------------------------------------------------
+template <class graph_type>
+void NextHopTable<graph_type>::Clear()
+{
+  m_pGraph    = NULL;
+  m_iNumNodes = 0;
+
+  std::vector<unsigned short>().swap(m_NextHop);
+}
+
+//-------------------------------- NextEdge -----------------------------------
+//-----------------------------------------------------------------------------
+template <class graph_type>
+const typename NextHopTable<graph_type>::EdgeType*
+NextHopTable<graph_type>::NextEdge(int source, int target)const
+{
+  int next = NextHop(source, target);
+
+  if (next == invalid_node_index || next == source) return NULL;
+
+  //if there's more than one edge to the next node take the cheapest
+  const EdgeType* pBest = NULL;
+
+  graph_type::ConstEdgeIterator ConstEdgeItr(*m_pGraph, source);
+  for (const EdgeType* pE=ConstEdgeItr.begin();
+      !ConstEdgeItr.end();
+       pE=ConstEdgeItr.next())
+  {
+    if (pE->To() == next && (!pBest || pE->Cost() < pBest->Cost()))
+    {
+      pBest = pE;
+    }
+  }
+
+  return pBest;
+}
+
+
+#endif
@@ -0,0 +1,230 @@
+#ifndef NODE_LOOKUP_GRID_H
+#define NODE_LOOKUP_GRID_H
+#pragma warning (disable:4786)
+//-----------------------------------------------------------------------------
+//
+//  Name:   NodeLookupGrid.h
+//
+//  Desc:   a fine grid laid over a graph's nodes for finding the closest
+//          node to a position that an agent can walk to.
+//
+//          Each cell lists, nearest to its centre first, every node that may
+//          lie within the query range of some point in the cell. A query
+//          only looks at the cell the position falls in and tries its nodes
+//          in order of distance, so the first that passes the walk test is
+//          the answer, and usually the first tried passes. The walk test is
+//          made at query time, so walls that move (doors) are handled.
+//-----------------------------------------------------------------------------
+#include <vector>
+#include <algorithm>
+#include <cmath>
+
+#include "2d/Vector2D.h"
+#include "graph/NodeTypeEnumerations.h"
+
+
+template <class graph_type>
+class NodeLookupGrid
+{
+private:
+
+  const graph_type*  m_pGraph;
+
+  int                m_iNumCellsX;
+  int                m_iNumCellsY;
+
+  double             m_dCellSize;
+
+  //only nodes closer than this to a position are returned for it
+  double             m_dRange;
+
+  //the candidates of cell c are m_Candidates[m_CellStart[c]] to
+  //m_Candidates[m_CellStart[c+1]-1]
+  std::vector<int>   m_CellStart;
+  std::vector<int>   m_Candidates;
+
+  int  CellIndex(double pos, int NumCells)const
+  {
+    int idx = (int)floor(pos / m_dCellSize);
+
+    if (idx < 0)         idx = 0;
+    if (idx >= NumCells) idx = NumCells - 1;
+
+    return idx;
+  }
+
+public:
+
+  NodeLookupGrid():m_pGraph(NULL),
+                   m_iNumCellsX(0),
+                   m_iNumCellsY(0),
+                   m_dCellSize(1),
+                   m_dRange(0)
+  {}
+
+  //lays a grid of CellSize cells over a width by height space and lists
+  //the candidates of each. G must outlive the grid
+  void Build(const graph_type& G,
+             double            width,
+             double            height,
+             double            CellSize,
+             double            range);
+
+  void Clear();
+
+  bool isBuilt()const{return m_pGraph != NULL;}
+
+  //returns the index of the closest node within range of pos for which
+  //CanWalk(pos, NodePos) is true, or invalid_node_index if there isn't one
+  template <class walk_test>
+  int  ClosestNode(Vector2D pos, walk_test CanWalk)const;
+
+  int  NumCandidates()const{return (int)m_Candidates.size();}
+};
+
+
+//--------------------------------- Build -------------------------------------
+//-----------------------------------------------------------------------------
+template <class graph_type>
+void NodeLookupGrid<graph_type>::Build(const graph_type& G,
+                                       double            width,
+                                       double            height,
+                                       double            CellSize,
+                                       double            range)
+{
+  Clear();
+
+  m_pGraph     = &G;
+  m_dCellSize  = CellSize;
+  m_dRange     = range;
+  m_iNumCellsX = (std::max)(1, (int)ceil(width  / CellSize));
+  m_iNumCellsY = (std::max)(1, (int)ceil(height / CellSize));
+
+  //a node can be within range of a point in a cell if it is within range
+  //plus half the cell's diagonal of the cell's centre
+  const double reach = range + CellSize * 0.5 * sqrt(2.0);
+
+  //first put each node in the cell it lies in, so that only the cells
+  //within reach need be looked at
+  std::vector<std::vector<int> > NodesInCell(m_iNumCellsX * m_iNumCellsY);
+
+  for (int n=0; n<G.NumNodes(); ++n)
+  {
+    if (G.GetNode(n).Index() == invalid_node_index) continue;
+
+    const Vector2D& NodePos = G.GetNode(n).Pos();
+
+    NodesInCell[CellIndex(NodePos.y, m_iNumCellsY) * m_iNumCellsX +
+                CellIndex(NodePos.x, m_iNumCellsX)].push_back(n);
+  }
+
+  const int CellReach = (int)ceil(reach / CellSize);
+
+  std::vector<std::pair<double, int> > near;
+
+  m_CellStart.reserve(m_iNumCellsX * m_iNumCellsY + 1);
+
+  for (int y=0; y<m_iNumCellsY; ++y)
+  {
+    for (int x=0; x<m_iNumCellsX; ++x)
+    {
+      m_CellStart.push_back((int)m_Candidates.size());
+
+      Vector2D centre((x + 0.5) * CellSize, (y + 0.5) * CellSize);
+
+      near.clear();
+
+      for (int cy=(std::max)(0, y-CellReach); cy<=(std::min)(m_iNumCellsY-1, y+CellReach); ++cy)
+      {
+        for (int cx=(std::max)(0, x-CellReach); cx<=(std::min)(m_iNumCellsX-1, x+CellReach); ++cx)
+        {
+          const std::vector<int>& nodes = NodesInCell[cy * m_iNumCellsX + cx];
+
+          for (unsigned int i=0; i<nodes.size(); ++i)
+          {
+            double DistSq = Vec2DDistanceSq(centre, G.GetNode(nodes[i]).Pos());
+
+            if (DistSq < reach * reach) near.push_back(std::make_pair(DistSq, nodes[i]));
+          }
+        }
+      }
+
+      std::sort(near.begin(), near.end());
+
+      for (unsigned int i=0; i<near.size(); ++i)
+      {
+        m_Candidates.push_back(near[i].second);
+      }
+    }
+  }
+
+  m_CellStart.push_back((int)m_Candidates.size());
+}
+
+//--------------------------------- Clear -------------------------------------
+//-----------------------------------------------------------------------------
+template <class graph_type>
+void NodeLookupGrid<graph_type>::Clear()
+{
+  m_pGraph     = NULL;
+  m_iNumCellsX = 0;
+  m_iNumCellsY = 0;
+
+  std::vector<int>().swap(m_CellStart);
+  std::vector<int>().swap(m_Candidates);
+}
+
+//------------------------------ ClosestNode ----------------------------------
+//
+//  the candidates are tried in order of their distance from pos. Rather
+//  than sorting them each time, each pass picks the closest candidate
+//  not yet tried; there are only a handful in a cell and usually the
+//  first passes the walk test
+//-----------------------------------------------------------------------------
+template <class graph_type>
+template <class walk_test>
+int NodeLookupGrid<graph_type>::ClosestNode(Vector2D pos, walk_test CanWalk)const
+{
+  if (!m_pGraph) return invalid_node_index;
+
+  int cell = CellIndex(pos.y, m_iNumCellsY) * m_iNumCellsX + CellIndex(pos.x, m_iNumCellsX);
+
+  const int first = m_CellStart[cell];
+  const int last  = m_CellStart[cell+1];
+
+  //the last candidate tried, by distance then by position in the cell
+  double TriedDistSq = -1.0;
+  int    TriedIdx    = first - 1;
+
+  for (;;)
+  {
+    double ClosestSoFar = m_dRange * m_dRange;
+    int    ClosestIdx   = -1;
+
+    for (int i=first; i<last; ++i)
+    {
+      double DistSq = Vec2DDistanceSq(pos, m_pGraph->GetNode(m_Candidates[i]).Pos());
+
+      //skip the candidates already tried
+      if (DistSq < TriedDistSq || (DistSq == TriedDistSq && i <= TriedIdx)) continue;
+
+      if (DistSq < ClosestSoFar)
+      {
+        ClosestSoFar = DistSq;
+        ClosestIdx   = i;
+      }
+    }
+
+    if (ClosestIdx < 0) return invalid_node_index;
+
+    const int nd = m_Candidates[ClosestIdx];
+
+    if (CanWalk(pos, m_pGraph->GetNode(nd).Pos())) return nd;
+
+    TriedDistSq = ClosestSoFar;
+    TriedIdx    = ClosestIdx;
+  }
+}
+
+
+#endif
@@ -0,0 +1,429 @@
+#ifndef PATH_COST_TABLE_H
+#define PATH_COST_TABLE_H
+#pragma warning (disable:4786)
+//-----------------------------------------------------------------------------
+//
+//  Name:   PathCostTable.h
+//
+//  Desc:   a lookup table of the cost of the shortest path between every
+//          pair of nodes in a graph. A full table of doubles needs N*N*8
+//          bytes, which is fine for a few hundred nodes but not for a few
+//          thousand, so the table can be held in one of three layouts:
+//
+//            full        every row is stored
+//
+//            triangular  for undirected graphs only. The cost from a to b is
+//                        the same as from b to a, so only the entries with
+//                        a >= b are stored (about half the memory)
+//
+//            on_demand   nothing is computed up front. A row is calculated
+//                        (with one Dijkstra search) the first time a cost
+//                        from its node is asked for, and is kept in a cache
+//                        of least recently used rows no larger than the
+//                        given memory budget
+//
+//          In each layout the costs may be held as doubles or as floats.
+//
+//          The table keeps a reference to the graph it was built from, which
+//          must outlive it (or the next call to Build/Assign).
+//-----------------------------------------------------------------------------
+#include <vector>
+#include <list>
+#include <mutex>
+#include <cstring>
+#include <cassert>
+
+#include "Graph/HandyGraphFunctions.h"
+
+
+template <class graph_type>
+class PathCostTable
+{
+public:
+
+  enum layout    {full, triangular, on_demand};
+  enum precision {double_precision, single_precision};
+
+private:
+
+  const graph_type*       m_pGraph;
+
+  int                     m_iNumNodes;
+
+  layout                  m_Layout;
+  precision               m_Precision;
+
+  //the stored costs. Only the vector matching m_Precision is used. In the
+  //on_demand layout these hold m_iNumSlots rows, one per cache slot (which
+  //are filled in through the const interface, hence mutable)
+  mutable std::vector<double>  m_Doubles;
+  mutable std::vector<float>   m_Floats;
+
+  //on_demand only: the slot holding each node's row (-1 if none), the row
+  //held in each slot, and the slots ordered most recently used first.
+  //m_CacheMutex guards these and the cached rows
+  int                                   m_iNumSlots;
+  mutable std::vector<int>              m_RowSlot;
+  mutable std::vector<int>              m_SlotRow;
+  mutable std::list<int>                m_LRU;
+  mutable std::vector<std::list<int>::iterator> m_SlotPosInLRU;
+  mutable std::mutex                    m_CacheMutex;
+
+  //the number of rows calculated by the on_demand layout so far
+  mutable int                           m_iNumRowsCalculated;
+
+  //on_demand: the search used to calculate rows. It is made when the first
+  //row is needed and kept so that its buffers are reused
+  mutable Graph_SingleSourceSearch<graph_type>* m_pSearch;
+
+
+  //the position of the entry a->b in the stored costs
+  size_t Index(int a, int b)const
+  {
+    if (m_Layout == triangular)
+    {
+      if (a < b) std::swap(a, b);
+
+      return (size_t)a*(a+1)/2 + b;
+    }
+
+    return (size_t)a*m_iNumNodes + b;
+  }
+
+  double Stored(size_t i)const
+  {
+    return (m_Precision == single_precision) ? (double)m_Floats[i] : m_Doubles[i];
+  }
+
+  void   Store(size_t i, double cost)const
+  {
+    if (m_Precision == single_precision) m_Floats[i] = (float)cost;
+    else                                 m_Doubles[i] = cost;
+  }
+
+  //sizes the storage for the current layout, precision and node count
+  void   Allocate(size_t NumEntries)
+  {
+    m_Doubles.clear(); m_Floats.clear();
+
+    if (m_Precision == single_precision) m_Floats.assign(NumEntries, 0.0f);
+    else                                 m_Doubles.assign(NumEntries, 0.0);
+  }
+
+  //the entry a->b of a table of N nodes stored as costs (see StoredCosts)
+  static double ReadStored(const void* costs, layout l, precision p, int N, int a, int b);
+
+  //on_demand: returns the slot holding row nd, calculating the row into the
+  //least recently used slot if it isn't cached
+  int    SlotForRow(int nd)const;
+
+  void   Reset(const graph_type& G, layout l, precision p);
+
+  PathCostTable(const PathCostTable&);
+  PathCostTable& operator=(const PathCostTable&);
+
+public:
+
+  PathCostTable():m_pGraph(NULL),
+                  m_iNumNodes(0),
+                  m_Layout(full),
+                  m_Precision(double_precision),
+                  m_iNumSlots(0),
+                  m_iNumRowsCalculated(0),
+                  m_pSearch(NULL)
+  {}
+
+  ~PathCostTable(){Clear();}
+
+  //builds the table for G. CacheBudget is the maximum number of bytes the
+  //on_demand layout may use for cached rows (at least one row is always
+  //cached). The full and triangular layouts are calculated in parallel (see
+  //ForEachSourceInParallel)
+  void   Build(const graph_type& G,
+               layout            l,
+               precision         p,
+               size_t            CacheBudget = 0);
+
+  //as Build, but the full and triangular layouts are filled from the
+  //stored costs of an earlier complete table (see StoredCosts), held in
+  //CostsLayout and CostsPrecision, instead of being calculated. Costs held
+  //as floats lose nothing if they are stored as floats again
+  void   Assign(const graph_type& G,
+                const void*       costs,
+                layout            CostsLayout,
+                precision         CostsPrecision,
+                layout            l,
+                precision         p,
+                size_t            CacheBudget = 0);
+
+  void   Clear();
+
+  //returns the cost of the shortest path from nd1 to nd2
+  double Cost(int nd1, int nd2)const;
+
+  //true if every row is held (ie the table can be written out in full)
+  bool   isComplete()const{return m_Layout != on_demand;}
+
+  //the costs of a complete table as they are held: every row for the full
+  //layout, or row by row the entries a->b with a >= b for the triangular
+  //one, as doubles or floats. NULL if the table isn't complete
+  const void* StoredCosts()const;
+
+  //the number of bytes of StoredCosts for a complete table of NumNodes nodes
+  static size_t StoredSize(int NumNodes, layout l, precision p)
+  {
+    size_t NumEntries = (l == triangular) ? (size_t)NumNodes*(NumNodes+1)/2 :
+                                            (size_t)NumNodes*NumNodes;
+
+    return NumEntries * ((p == single_precision) ? sizeof(float) : sizeof(double));
+  }
+
+  //the number of bytes used by the table
+  size_t MemoryUsed()const;
+
+  //the number of bytes a full table of doubles would need
+  size_t FullTableMemory()const{return (size_t)m_iNumNodes*m_iNumNodes*sizeof(double);}
+
+  int    NumNodes()const{return m_iNumNodes;}
+  int    NumRowsCalculated()const{return m_iNumRowsCalculated;}
+  layout Layout()const{return m_Layout;}
+  precision Precision()const{return m_Precision;}
+};
+
+
+//--------------------------------- Reset -------------------------------------
+//-----------------------------------------------------------------------------
+template <class graph_type>
+void PathCostTable<graph_type>::Reset(const graph_type& G, layout l, precision p)
+{
+  Clear();
+
+  //only an undirected graph is guaranteed to have symmetrical path costs
+  assert ((l != triangular || !G.isDigraph()) &&
+          "<PathCostTable::Reset>: triangular layout needs an undirected graph");
+
+  m_pGraph    = &G;
+  m_iNumNodes = G.NumNodes();
+  m_Layout    = l;
+  m_Precision = p;
+}
+
+//--------------------------------- Build -------------------------------------
+//-----------------------------------------------------------------------------
+template <class graph_type>
+void PathCostTable<graph_type>::Build(const graph_type& G,
+                                      layout            l,
+                                      precision         p,
+                                      size_t            CacheBudget)
+{
+  Assign(G, NULL, l, p, l, p, CacheBudget);
+}
+
+//--------------------------------- Assign ------------------------------------
+//-----------------------------------------------------------------------------
+template <class graph_type>
+void PathCostTable<graph_type>::Assign(const graph_type& G,
+                                       const void*       costs,
+                                       layout            CostsLayout,
+                                       precision         CostsPrecision,
+                                       layout            l,
+                                       precision         p,
+                                       size_t            CacheBudget)
+{
+  assert ((!costs || CostsLayout != on_demand) &&
+          "<PathCostTable::Assign>: the costs must be from a complete table");
+
+  Reset(G, l, p);
+
+  const int N = m_iNumNodes;
+
+  if (m_Layout == on_demand)
+  {
+    size_t RowSize = N * ((p == single_precision) ? sizeof(float) : sizeof(double));
+
+    m_iNumSlots = (RowSize > 0) ? (int)(CacheBudget / RowSize) : 0;
+
+    if (m_iNumSlots < 1) m_iNumSlots = 1;
+    if (m_iNumSlots > N) m_iNumSlots = N;
+
+    Allocate((size_t)m_iNumSlots * N);
+
+    m_RowSlot.assign(N, -1);
+    m_SlotRow.assign(m_iNumSlots, -1);
+    m_SlotPosInLRU.resize(m_iNumSlots);
+
+    for (int s=0; s<m_iNumSlots; ++s)
+    {
+      m_SlotPosInLRU[s] = m_LRU.insert(m_LRU.end(), s);
+    }
+
+    return;
+  }
+
+  Allocate((m_Layout == triangular) ? (size_t)N*(N+1)/2 : (size_t)N*N);
+
+  //costs held the same way can be copied straight in
+  if (costs && CostsLayout == m_Layout && CostsPrecision == m_Precision)
+  {
+    void* dest = (m_Precision == single_precision) ? (void*)&m_Floats[0] : (void*)&m_Doubles[0];
+
+    if (N > 0) memcpy(dest, costs, StoredSize(N, m_Layout, m_Precision));
+  }
+
+  else if (costs)
+  {
+    for (int a=0; a<N; ++a)
+    {
+      int LastColumn = (m_Layout == triangular) ? a : N-1;
+
+      for (int b=0; b<=LastColumn; ++b)
+      {
+        Store(Index(a, b), ReadStored(costs, CostsLayout, CostsPrecision, N, a, b));
+      }
+    }
+  }
+
+  else
+  {
+    //each source only writes its own row (or, for the triangular layout,
+    //the entries of its row left of the diagonal) so the workers never
+    //share an entry
+    ForEachSourceInParallel(G,
+      [&](const Graph_SingleSourceSearch<graph_type>& search, int source)
+      {
+        int LastColumn = (m_Layout == triangular) ? source : N-1;
+
+        for (int target=0; target<=LastColumn; ++target)
+        {
+          Store(Index(source, target), (source == target) ? 0.0 : search.GetCostToNode(target));
+        }
+      });
+  }
+}
+
+//------------------------------- ReadStored ----------------------------------
+//-----------------------------------------------------------------------------
+template <class graph_type>
+double PathCostTable<graph_type>::ReadStored(const void* costs,
+                                             layout      l,
+                                             precision   p,
+                                             int         N,
+                                             int         a,
+                                             int         b)
+{
+  if (l == triangular && a < b) std::swap(a, b);
+
+  size_t i = (l == triangular) ? (size_t)a*(a+1)/2 + b : (size_t)a*N + b;
+
+  return (p == single_precision) ? (double)((const float*)costs)[i] :
+                                   ((const double*)costs)[i];
+}
+
+//------------------------------ StoredCosts ----------------------------------
+//-----------------------------------------------------------------------------
+template <class graph_type>
+const void* PathCostTable<graph_type>::StoredCosts()const
+{
+  if (!isComplete() || m_iNumNodes == 0) return NULL;
+
+  return (m_Precision == single_precision) ? (const void*)&m_Floats[0] :
+                                             (const void*)&m_Doubles[0];
+}
+
+//--------------------------------- Clear -------------------------------------
+//-----------------------------------------------------------------------------
+template <class graph_type>
+void PathCostTable<graph_type>::Clear()
+{
+  std::lock_guard<std::mutex> lock(m_CacheMutex);
+
+  m_pGraph    = NULL;
+  m_iNumNodes = 0;
+  m_iNumSlots = 0;
+  m_iNumRowsCalculated = 0;
+
+  delete m_pSearch;
+  m_pSearch = NULL;
+
+  std::vector<double>().swap(m_Doubles);
+  std::vector<float>().swap(m_Floats);
+
+  m_RowSlot.clear();
+  m_SlotRow.clear();
+  m_LRU.clear();
+  m_SlotPosInLRU.clear();
+}
+
+//------------------------------- SlotForRow ----------------------------------
+//
+//  must be called with m_CacheMutex held
+//-----------------------------------------------------------------------------
+template <class graph_type>
+int PathCostTable<graph_type>::SlotForRow(int nd)const
+{
+  int slot = m_RowSlot[nd];
+
+  if (slot < 0)
+  {
+    //evict the least recently used row
+    slot = m_LRU.back();
+
+    if (m_SlotRow[slot] >= 0) m_RowSlot[m_SlotRow[slot]] = -1;
+
+    if (!m_pSearch) m_pSearch = new Graph_SingleSourceSearch<graph_type>(*m_pGraph);
+
+    m_pSearch->Search(nd);
+
+    for (int target=0; target<m_iNumNodes; ++target)
+    {
+      Store((size_t)slot*m_iNumNodes + target,
+                  (target == nd) ? 0.0 : m_pSearch->GetCostToNode(target));
+    }
+
+    m_SlotRow[slot] = nd;
+    m_RowSlot[nd]   = slot;
+
+    ++m_iNumRowsCalculated;
+  }
+
+  //move the slot to the front of the LRU list
+  m_LRU.splice(m_LRU.begin(), m_LRU, m_SlotPosInLRU[slot]);
+
+  return slot;
+}
+
+//---------------------------------- Cost -------------------------------------
+//-----------------------------------------------------------------------------
+template <class graph_type>
+double PathCostTable<graph_type>::Cost(int nd1, int nd2)const
+{
+  assert (nd1>=0 && nd1<m_iNumNodes && nd2>=0 && nd2<m_iNumNodes &&
+          "<PathCostTable::Cost>: invalid index");
+
+  if (m_Layout != on_demand) return Stored(Index(nd1, nd2));
+
+  std::lock_guard<std::mutex> lock(m_CacheMutex);
+
+  return Stored((size_t)SlotForRow(nd1)*m_iNumNodes + nd2);
+}
+
+//------------------------------- MemoryUsed ----------------------------------
+//-----------------------------------------------------------------------------
+template <class graph_type>
+size_t PathCostTable<graph_type>::MemoryUsed()const
+{
+  size_t bytes = m_Doubles.capacity() * sizeof(double) +
+                 m_Floats.capacity()  * sizeof(float);
+
+  if (m_Layout == on_demand)
+  {
+    bytes += (m_RowSlot.capacity() + m_SlotRow.capacity()) * sizeof(int) +
+             m_SlotPosInLRU.capacity() * sizeof(std::list<int>::iterator) +
+             m_LRU.size() * (sizeof(int) + 2*sizeof(void*));
+  }
+
+  return bytes;
+}
+
+
+#endif
@@ -95,6 +95,17 @@ public:
   //direction will be automatically added.
   void  AddEdge(EdgeType edge);
 
+  //appends the edge to its from-node's edge list as it is: no reverse edge
+  //is added and uniqueness isn't checked. Use this to rebuild a graph from
+  //edge lists known to be consistent (such as those of a compiled map)
+  void  AppendEdge(const EdgeType& edge)
+  {
+    assert( (edge.From() < m_iNextNodeIndex) && (edge.To() < m_iNextNodeIndex) &&
+            "<SparseGraph::AppendEdge>: invalid node index");
+
+    m_Edges[edge.From()].push_back(edge);
+  }
+
   //removes the edge connecting from and to from the graph (if present). If
   //a digraph then the edge connecting the nodes in the opposite direction 
   //will also be removed.
@@ -4,7 +4,14 @@
 #include "game/EntityManager.h"
 #include "Debug/DebugConsole.h"
 
-using std::set;
+#include <algorithm>
+
+//delayed telegrams falling due on the same update-step are delivered in
+//order of their dispatch time
+static bool EarlierDispatchTime(const Telegram& t1, const Telegram& t2)
+{
+  return t1.DispatchTime < t2.DispatchTime;
+}
 
 //uncomment below to send message info to the debug window
 //#define SHOW_MESSAGING_INFO
@@ -58,6 +65,8 @@ void MessageDispatcher::DispatchMsg(double       delay,
     debug_con << "\nWarning! No Receiver with ID of " << receiver << " found" << "";
     #endif
 
+    ++m_CurrentStats.Dropped;
+
     return;
   }
   
@@ -75,6 +84,8 @@ void MessageDispatcher::DispatchMsg(double       delay,
 
     //send the telegram to the recipient
     Discharge(pReceiver, telegram);
+
+    ++m_CurrentStats.Immediate;
   }
 
   //else calculate the time when the telegram should be dispatched
@@ -84,8 +95,12 @@ void MessageDispatcher::DispatchMsg(double       delay,
 
     telegram.DispatchTime = CurrentTime + delay;
 
-    //and put it in the queue
-    PriorityQ.insert(telegram);   
+    //and put it in the queue. It is delivered on the first update-step
+    //whose time is later than its dispatch time
+    if (PriorityQ.Insert(telegram, (long)floor(telegram.DispatchTime) + 1))
+    {
+      ++m_CurrentStats.Queued;
+    }
 
     #ifdef SHOW_MESSAGING_INFO
     debug_con << "\nDelayed telegram from " << sender << " recorded at time " 
@@ -103,33 +118,53 @@ void MessageDispatcher::DispatchMsg(double       delay,
 void MessageDispatcher::DispatchDelayedMessages()
 { 
   //first get current time
-  double CurrentTime = TickCounter->GetCurrentFrame(); 
-
-  //now peek at the queue to see if any telegrams need dispatching.
-  //remove all telegrams from the front of the queue that have gone
-  //past their sell by date
-  while( !PriorityQ.empty() &&
-	     (PriorityQ.begin()->DispatchTime < CurrentTime) && 
-         (PriorityQ.begin()->DispatchTime > 0) )
+  long CurrentTime = TickCounter->GetCurrentFrame(); 
+
+  //this marks the start of a new update-step as far as the counters are
+  //concerned
+  m_LastStats    = m_CurrentStats;
+  m_CurrentStats = DispatchStats();
+
+  //now advance the queue to the current time, collecting all the telegrams
+  //that have gone past their sell by date
+  m_DueTelegrams.clear();
+
+  PriorityQ.Advance(CurrentTime, m_DueTelegrams);
+
+  std::stable_sort(m_DueTelegrams.begin(), m_DueTelegrams.end(), EarlierDispatchTime);
+
+  std::vector<Telegram>::const_iterator telegram;
+  for (telegram = m_DueTelegrams.begin(); telegram != m_DueTelegrams.end(); ++telegram)
   {
-    //read the telegram from the front of the queue
-    const Telegram& telegram = *PriorityQ.begin();
+    //find the recipient. It may have been removed since the telegram was
+    //sent
+    BaseGameEntity* pReceiver = EntityMgr->TryGetEntityFromID(telegram->Receiver);
 
-    //find the recipient
-    BaseGameEntity* pReceiver = EntityMgr->GetEntityFromID(telegram.Receiver);
+    if (pReceiver == NULL)
+    {
+      ++m_CurrentStats.Dropped;
+
+      continue;
+    }
 
     #ifdef SHOW_MESSAGING_INFO
     debug_con << "\nQueued telegram ready for dispatch: Sent to " 
-         << pReceiver->ID() << ". Msg is "<< telegram.Msg << "";
+         << pReceiver->ID() << ". Msg is "<< telegram->Msg << "";
     #endif
 
     //send the telegram to the recipient
-    Discharge(pReceiver, telegram);
+    Discharge(pReceiver, *telegram);
 
-	//remove it from the queue
-    PriorityQ.erase(PriorityQ.begin());
+    ++m_CurrentStats.Delayed;
   }
 }
 
+//------------------------------- Clear ----------------------------------
+//------------------------------------------------------------------------
+void MessageDispatcher::Clear()
+{
+  PriorityQ.Clear(TickCounter->GetCurrentFrame());
 
-
+  m_CurrentStats = DispatchStats();
+  m_LastStats    = DispatchStats();
+}
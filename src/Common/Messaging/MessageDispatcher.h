@@ -11,11 +11,12 @@
 //  Author: Mat Buckland (fup@ai-junkie.com)
 //
 //------------------------------------------------------------------------
-#include <set>
+#include <vector>
 #include <string>
 
 
 #include "Messaging/Telegram.h"
+#include "Messaging/TelegramWheel.h"
 
 
 class BaseGameEntity;
@@ -30,14 +31,43 @@ const int    NO_ADDITIONAL_INFO   = 0;
 const int    SENDER_ID_IRRELEVANT = -1;
 
 
+//the number of telegrams handled by the dispatcher during one update-step
+struct DispatchStats
+{
+  //telegrams sent with no delay
+  int  Immediate;
+
+  //delayed telegrams that fell due and were delivered
+  int  Delayed;
+
+  //telegrams queued for later delivery
+  int  Queued;
+
+  //telegrams dropped because the receiver no longer exists
+  int  Dropped;
+
+  DispatchStats():Immediate(0), Delayed(0), Queued(0), Dropped(0){}
+
+  int  Dispatched()const{return Immediate + Delayed;}
+};
+
+
 class MessageDispatcher
 {
 private:  
   
-  //a std::set is used as the container for the delayed messages
-  //because of the benefit of automatic sorting and avoidance
-  //of duplicates. Messages are sorted by their dispatch time.
-  std::set<Telegram> PriorityQ;
+  //delayed messages are kept in a timing wheel keyed on the update-step
+  //they fall due. Equivalent telegrams falling due on the same step are
+  //only stored once.
+  TelegramWheel      PriorityQ;
+
+  //scratch buffer receiving the telegrams that fall due each update-step
+  std::vector<Telegram> m_DueTelegrams;
+
+  //the counts for the update-step in progress and the one before it. The
+  //step changes each time DispatchDelayedMessages is called
+  DispatchStats      m_CurrentStats;
+  DispatchStats      m_LastStats;
 
   //this method is utilized by DispatchMsg or DispatchDelayedMessages.
   //This method calls the message handling member function of the receiving
@@ -64,6 +94,12 @@ public:
   //send out any delayed messages. This method is called each time through   
   //the main game loop.
   void DispatchDelayedMessages();
+
+  //the telegram counts for the last completed update-step
+  const DispatchStats& GetStatsForLastUpdate()const{return m_LastStats;}
+
+  //discards any delayed telegrams (call this when the game is reset)
+  void Clear();
 };
 
 
@@ -0,0 +1,198 @@
+#ifndef TELEGRAM_WHEEL_H
+#define TELEGRAM_WHEEL_H
+#pragma warning (disable:4786)
+//------------------------------------------------------------------------
+//
+//  Name:   TelegramWheel.h
+//
+//  Desc:   a hierarchical timing wheel used by the MessageDispatcher to
+//          hold delayed telegrams. Time is measured in whole update-steps
+//          (ticks). Telegrams due within the next 256 ticks sit in the
+//          slot for their tick on the innermost wheel; those further away
+//          sit on coarser wheels and are cascaded inwards as the current
+//          tick reaches their block. Inserting a telegram and expiring
+//          one are both O(1), independent of how many are queued.
+//
+//------------------------------------------------------------------------
+#include <vector>
+
+#include "Messaging/Telegram.h"
+
+
+class TelegramWheel
+{
+private:
+
+  //a telegram together with the tick it falls due on
+  struct Entry
+  {
+    long      DueTick;
+    Telegram  Msg;
+
+    Entry(long due, const Telegram& msg):DueTick(due), Msg(msg){}
+  };
+
+  typedef std::vector<Entry> Slot;
+
+  enum
+  {
+    //the innermost wheel has one slot per tick
+    InnerBits   = 8,
+    InnerSlots  = 1 << InnerBits,
+
+    //each slot on an outer wheel spans a whole revolution of the wheel
+    //inside it
+    OuterBits   = 6,
+    OuterSlots  = 1 << OuterBits,
+
+    NumOuterWheels = 2
+  };
+
+  Slot    m_Inner[InnerSlots];
+  Slot    m_Outer[NumOuterWheels][OuterSlots];
+
+  //telegrams too far in the future for any wheel. These are reconsidered
+  //each time the outermost wheel completes a revolution
+  Slot    m_Overflow;
+
+  //the last tick that has been expired
+  long    m_lCurrentTick;
+
+  //the number of telegrams held
+  int     m_iSize;
+
+
+  //the number of ticks spanned by wheel level (0 is the inner wheel)
+  static long Span(int level)
+  {
+    return 1L << (InnerBits + OuterBits*level);
+  }
+
+  //returns the slot appropriate for a tick's distance from the current tick
+  Slot* SlotFor(long due)
+  {
+    long dist = due - m_lCurrentTick;
+
+    if (dist < Span(0)) return &m_Inner[due & (InnerSlots-1)];
+
+    for (int w=0; w<NumOuterWheels; ++w)
+    {
+      if (dist < Span(w+1))
+      {
+        return &m_Outer[w][(due >> (InnerBits + OuterBits*w)) & (OuterSlots-1)];
+      }
+    }
+
+    return &m_Overflow;
+  }
+
+  //re-places every entry of a slot relative to the current tick
+  void Cascade(Slot& slot)
+  {
+    Slot entries;
+    entries.swap(slot);
+
+    for (unsigned int i=0; i<entries.size(); ++i)
+    {
+      SlotFor(entries[i].DueTick)->push_back(entries[i]);
+    }
+  }
+
+public:
+
+  TelegramWheel(long StartTick = 0):m_lCurrentTick(StartTick), m_iSize(0){}
+
+  //queues the telegram to fall due on the given tick. If an equivalent
+  //telegram (see operator== in Telegram.h) is already queued for that tick
+  //the new one is discarded and false is returned.
+  bool Insert(const Telegram& msg, long DueTick)
+  {
+    //nothing can fall due on a tick that has already been expired
+    if (DueTick <= m_lCurrentTick) DueTick = m_lCurrentTick + 1;
+
+    Slot* slot = SlotFor(DueTick);
+
+    for (Slot::const_iterator it = slot->begin(); it != slot->end(); ++it)
+    {
+      if (it->DueTick == DueTick && it->Msg == msg) return false;
+    }
+
+    slot->push_back(Entry(DueTick, msg));
+
+    ++m_iSize;
+
+    return true;
+  }
+
+  //advances the wheel to tick now, appending every telegram that has fallen
+  //due on or before it to expired (in no particular order)
+  void Advance(long now, std::vector<Telegram>& expired)
+  {
+    //an empty wheel can jump straight to the new tick
+    if (m_iSize == 0)
+    {
+      if (now > m_lCurrentTick) m_lCurrentTick = now;
+
+      return;
+    }
+
+    while (m_lCurrentTick < now)
+    {
+      ++m_lCurrentTick;
+
+      //when a wheel completes a revolution the next slot of the wheel
+      //outside it is cascaded inwards. The outermost wheels go first so
+      //their entries can carry on down in the same tick
+      if ((m_lCurrentTick & (Span(NumOuterWheels)-1)) == 0)
+      {
+        Cascade(m_Overflow);
+      }
+
+      for (int w=NumOuterWheels-1; w>=0; --w)
+      {
+        if ((m_lCurrentTick & (Span(w)-1)) == 0)
+        {
+          Cascade(m_Outer[w][(m_lCurrentTick >> (InnerBits + OuterBits*w)) & (OuterSlots-1)]);
+        }
+      }
+
+      Slot& slot = m_Inner[m_lCurrentTick & (InnerSlots-1)];
+
+      for (unsigned int i=0; i<slot.size(); ++i)
+      {
+        expired.push_back(slot[i].Msg);
+      }
+
+      m_iSize -= (int)slot.size();
+
+      slot.clear();
+
+      if (m_iSize == 0)
+      {
+        m_lCurrentTick = now;
+      }
+    }
+  }
+
+  void Clear(long StartTick = 0)
+  {
+    for (int s=0; s<InnerSlots; ++s) m_Inner[s].clear();
+
+    for (int w=0; w<NumOuterWheels; ++w)
+    {
+      for (int s=0; s<OuterSlots; ++s) m_Outer[w][s].clear();
+    }
+
+    m_Overflow.clear();
+
+    m_lCurrentTick = StartTick;
+    m_iSize        = 0;
+  }
+
+  long CurrentTick()const{return m_lCurrentTick;}
+  int  Size()const{return m_iSize;}
+  bool Empty()const{return m_iSize == 0;}
+};
+
+
+#endif
@@ -38,6 +38,13 @@ public:
   {
     m_dwNextUpdateTime = (DWORD)(timeGetTime()+RandFloat()*1000);
 
+    SetFrequency(NumUpdatesPerSecondRqd);
+  }
+
+  //changes the number of updates per second. The next update is still
+  //allowed at the time already scheduled
+  void SetFrequency(double NumUpdatesPerSecondRqd)
+  {
     if (NumUpdatesPerSecondRqd > 0)
     {
       m_dUpdatePeriod = 1000.0 / NumUpdatesPerSecondRqd; 
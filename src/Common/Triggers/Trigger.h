@@ -38,6 +38,10 @@ private:
   //type of trigger.
   int            m_iGraphNodeIndex;
 
+  //set by the TriggerSystem while the trigger is parked in its sleep queue.
+  //A sleeping trigger is neither updated nor tried against entities
+  bool           m_bSleeping;
+
 protected:
   
   void SetGraphNodeIndex(int idx){m_iGraphNodeIndex = idx;}
@@ -63,6 +67,7 @@ public:
                            m_bRemoveFromGame(false),
                            m_bActive(true),
                            m_iGraphNodeIndex(-1),
+                           m_bSleeping(false),
                            m_pRegionOfInfluence(NULL),
 						   m_sNameTeam("")
                            
@@ -79,9 +84,22 @@ public:
   //state the trigger may have
   virtual void  Update() = 0;
 
+  //an inactive trigger that knows how many update-steps it will stay
+  //inactive for returns that number here so the TriggerSystem can stop
+  //updating it until then. Return 0 to stay awake or a negative value to
+  //sleep indefinitely. Wake is called when the sleep period is over and
+  //must leave the trigger in the state Update would have.
+  virtual int   NumUpdatesToSleep()const{return 0;}
+  virtual void  Wake(){}
+
+  //returns the bounds of the trigger region. False if there is no region
+  bool GetRegionBounds(Vector2D& TopLeft, Vector2D& BottomRight)const;
+
   int  GraphNodeIndex()const{return m_iGraphNodeIndex;}
   bool isToBeRemoved()const{return m_bRemoveFromGame;}
-  bool isActive(){return m_bActive;}
+  bool isActive()const{return m_bActive;}
+  bool isSleeping()const{return m_bSleeping;}
+  void SetSleeping(bool b){m_bSleeping = b;}
 
   void SetNameTeam(std::string newNameTeam) { m_sNameTeam = newNameTeam; } // Dfinie une team  un objet
   std::string GetNameTeam() { return m_sNameTeam; } // Donne le nom de la team de l'objet
@@ -127,5 +145,24 @@ bool Trigger<entity_type>::isTouchingTrigger(Vector2D EntityPos,
   return false;
 }
 
+//--------------------- GetRegionBounds ---------------------------------------
+//-----------------------------------------------------------------------------
+template <class entity_type>
+bool Trigger<entity_type>::GetRegionBounds(Vector2D& TopLeft,
+                                           Vector2D& BottomRight)const
+{
+  if (m_pRegionOfInfluence)
+  {
+    InvertedAABBox2D box = m_pRegionOfInfluence->BoundingBox();
+
+    TopLeft     = box.TopLeft();
+    BottomRight = box.BottomRight();
+
+    return true;
+  }
+
+  return false;
+}
+
 
 #endif
\ No newline at end of file
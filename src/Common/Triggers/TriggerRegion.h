@@ -22,6 +22,10 @@ public:
   //returns true if an entity of the given size and position is intersecting
   //the trigger region.
   virtual bool isTouching(Vector2D EntityPos, double EntityRadius)const = 0;
+
+  //returns the axis aligned box enclosing the region (used by the
+  //TriggerSystem to bucket triggers spatially)
+  virtual InvertedAABBox2D BoundingBox()const = 0;
 };
 
 
@@ -50,6 +54,12 @@ public:
   {
     return Vec2DDistanceSq(m_vPos, pos) < (EntityRadius + m_dRadius)*(EntityRadius + m_dRadius);
   }
+
+  InvertedAABBox2D BoundingBox()const
+  {
+    return InvertedAABBox2D(m_vPos - Vector2D(m_dRadius, m_dRadius),
+                            m_vPos + Vector2D(m_dRadius, m_dRadius));
+  }
 };
 
 
@@ -83,6 +93,8 @@ public:
 
     return Box.isOverlappedWith(*m_pTrigger);
   }
+
+  InvertedAABBox2D BoundingBox()const{return *m_pTrigger;}
 };
 
 
@@ -11,7 +11,25 @@
 //           takes care of updating those triggers and of removing them from
 //           the system if their lifetime has expired.
 //
+//           To keep the cost of TryTriggers down when there are many
+//           triggers, each trigger is hashed into the cells of a coarse grid
+//           covered by its region, and an entity is only tried against the
+//           triggers sharing its cells. Inactive triggers that know how long
+//           they will stay inactive (see Trigger::NumUpdatesToSleep) are put
+//           to sleep: they are taken out of the grid and are neither updated
+//           nor tried until a timer wakes them.
+//
 //-----------------------------------------------------------------------------
+#include <list>
+#include <vector>
+#include <queue>
+#include <algorithm>
+#include <functional>
+#include <cmath>
+
+#include "2d/Vector2D.h"
+
+
 template <class trigger_type>
 class TriggerSystem
 {
@@ -21,21 +39,177 @@ public:
 
 private:
 
+  typedef std::vector<trigger_type*>              TriggerVector;
+
+  //a sleeping trigger and the update-step it is due to wake on
+  typedef std::pair<int, trigger_type*>           SleepRecord;
+
+  typedef std::priority_queue<SleepRecord,
+                              std::vector<SleepRecord>,
+                              std::greater<SleepRecord> > SleepQueue;
+
+  enum {NumBuckets = 256};
+
+  //every trigger registered with the system (asleep or not)
   TriggerList   m_Triggers; 
 
+  //the spatial hash. Bucket i holds every awake trigger whose region
+  //overlaps a grid cell hashing to i
+  TriggerVector m_Buckets[NumBuckets];
+
+  //awake triggers without a region of influence. These are tried against
+  //every entity
+  TriggerVector m_Unbounded;
+
+  //triggers sleeping until a known update-step
+  SleepQueue    m_SleepQueue;
+
+  //triggers that asked to sleep during TryTriggers. They are put to sleep
+  //once all the entities have been tried
+  TriggerVector m_ToSleep;
+
+  //scratch buffer used to collect the candidate triggers for an entity
+  TriggerVector m_Candidates;
+
+  //the side length of a grid cell
+  double        m_dCellSize;
+
+  //the number of times UpdateTriggers has been called
+  int           m_iNumUpdates;
+
+
+  int CellCoord(double val)const{return (int)floor(val / m_dCellSize);}
+
+  int HashCell(int x, int y)const
+  {
+    return ((unsigned int)x * 73856093u ^ (unsigned int)y * 19349663u) & (NumBuckets-1);
+  }
+
+  //adds the trigger to every bucket its region overlaps (or to the unbounded
+  //list if it has no region)
+  void InsertIntoGrid(trigger_type* trigger)
+  {
+    Vector2D TopLeft, BottomRight;
+
+    if (!trigger->GetRegionBounds(TopLeft, BottomRight))
+    {
+      m_Unbounded.push_back(trigger);
+
+      return;
+    }
+
+    for (int y=CellCoord(TopLeft.y); y<=CellCoord(BottomRight.y); ++y)
+    {
+      for (int x=CellCoord(TopLeft.x); x<=CellCoord(BottomRight.x); ++x)
+      {
+        TriggerVector& bucket = m_Buckets[HashCell(x, y)];
+
+        //a large region may cover several cells that share a bucket
+        if (std::find(bucket.begin(), bucket.end(), trigger) == bucket.end())
+        {
+          bucket.push_back(trigger);
+        }
+      }
+    }
+  }
+
+  //removes the trigger from every bucket it was inserted into
+  void RemoveFromGrid(trigger_type* trigger)
+  {
+    Vector2D TopLeft, BottomRight;
+
+    if (!trigger->GetRegionBounds(TopLeft, BottomRight))
+    {
+      m_Unbounded.erase(std::remove(m_Unbounded.begin(), m_Unbounded.end(), trigger),
+                        m_Unbounded.end());
+
+      return;
+    }
+
+    for (int y=CellCoord(TopLeft.y); y<=CellCoord(BottomRight.y); ++y)
+    {
+      for (int x=CellCoord(TopLeft.x); x<=CellCoord(BottomRight.x); ++x)
+      {
+        TriggerVector& bucket = m_Buckets[HashCell(x, y)];
+
+        bucket.erase(std::remove(bucket.begin(), bucket.end(), trigger),
+                     bucket.end());
+      }
+    }
+  }
+
+  //takes the trigger out of the grid. A trigger sleeping for a negative
+  //number of update-steps sleeps until it is removed from the game
+  void PutToSleep(trigger_type* trigger, int NumUpdates)
+  {
+    RemoveFromGrid(trigger);
+
+    trigger->SetSleeping(true);
+
+    if (NumUpdates > 0)
+    {
+      m_SleepQueue.push(SleepRecord(m_iNumUpdates + NumUpdates, trigger));
+    }
+  }
+
+  void WakeUp(trigger_type* trigger)
+  {
+    trigger->SetSleeping(false);
+    trigger->Wake();
+
+    InsertIntoGrid(trigger);
+  }
+
+  //purges a trigger that is about to be deleted from the sleep queue
+  void RemoveFromSleepQueue(trigger_type* trigger)
+  {
+    SleepQueue Remaining;
+
+    while (!m_SleepQueue.empty())
+    {
+      if (m_SleepQueue.top().second != trigger)
+      {
+        Remaining.push(m_SleepQueue.top());
+      }
+
+      m_SleepQueue.pop();
+    }
+
+    m_SleepQueue.swap(Remaining);
+  }
+
 
   //this method iterates through all the triggers present in the system and
   //calls their Update method in order that their internal state can be
   //updated if necessary. It also removes any triggers from the system that
-  //have their m_bRemoveFromGame field set to true.
+  //have their m_bRemoveFromGame field set to true. Sleeping triggers are
+  //not updated; any that are due this update-step are woken instead.
   void UpdateTriggers()
   {
+    ++m_iNumUpdates;
+
+    while (!m_SleepQueue.empty() && m_SleepQueue.top().first <= m_iNumUpdates)
+    {
+      WakeUp(m_SleepQueue.top().second);
+
+      m_SleepQueue.pop();
+    }
+
     TriggerList::iterator curTrg = m_Triggers.begin();
     while (curTrg != m_Triggers.end())
     {
       //remove trigger if dead
       if ((*curTrg)->isToBeRemoved())
       {
+        if ((*curTrg)->isSleeping())
+        {
+          RemoveFromSleepQueue(*curTrg);
+        }
+        else
+        {
+          RemoveFromGrid(*curTrg);
+        }
+
         delete *curTrg;
 
         curTrg = m_Triggers.erase(curTrg);
@@ -43,16 +217,40 @@ private:
       else
       {
         //update this trigger
-        (*curTrg)->Update();
+        if (!(*curTrg)->isSleeping())
+        {
+          (*curTrg)->Update();
+        }
 
         ++curTrg;
       }
     }
   }
 
+  //tries the entity against a single trigger and notes whether the trigger
+  //wants to go to sleep as a result
+  template <class entity_type>
+  void TryTrigger(trigger_type* trigger, entity_type* entity)
+  {
+    //the trigger may already have asked to sleep this update-step
+    if (trigger->isSleeping()) return;
+
+    trigger->Try(entity);
+
+    if (trigger->NumUpdatesToSleep() != 0)
+    {
+      //mark it now so it isn't tried again. It stays in the grid until
+      //TryTriggers has finished iterating
+      trigger->SetSleeping(true);
+
+      m_ToSleep.push_back(trigger);
+    }
+  }
+
   //this method iterates through the container of entities passed as a
-  //parameter and passes each one to the Try method of each trigger *provided*
-  //the entity is alive and provided the entity is ready for a trigger update.
+  //parameter and passes each one to the Try method of each trigger sharing
+  //a grid cell with it, *provided* the entity is alive and provided the
+  //entity is ready for a trigger update.
   template <class ContainerOfEntities>
   void TryTriggers(ContainerOfEntities& entities)
   {
@@ -64,18 +262,57 @@ private:
       //alive before it is tested against each trigger.
       if ((*curEnt)->isReadyForTriggerUpdate() && (*curEnt)->isAlive())
       {
-        TriggerList::const_iterator curTrg;
-        for (curTrg = m_Triggers.begin(); curTrg != m_Triggers.end(); ++curTrg)
+        //gather the triggers from each cell the entity's bounding box covers
+        Vector2D pos    = (*curEnt)->Pos();
+        double   radius = (*curEnt)->BRadius();
+
+        m_Candidates.clear();
+
+        for (int y=CellCoord(pos.y-radius); y<=CellCoord(pos.y+radius); ++y)
+        {
+          for (int x=CellCoord(pos.x-radius); x<=CellCoord(pos.x+radius); ++x)
+          {
+            const TriggerVector& bucket = m_Buckets[HashCell(x, y)];
+
+            m_Candidates.insert(m_Candidates.end(), bucket.begin(), bucket.end());
+          }
+        }
+
+        //a trigger spanning several cells will have been gathered more than once
+        std::sort(m_Candidates.begin(), m_Candidates.end());
+        m_Candidates.erase(std::unique(m_Candidates.begin(), m_Candidates.end()),
+                           m_Candidates.end());
+
+        TriggerVector::iterator curTrg;
+        for (curTrg = m_Candidates.begin(); curTrg != m_Candidates.end(); ++curTrg)
         {
-          (*curTrg)->Try(*curEnt);
+          TryTrigger(*curTrg, *curEnt);
+        }
+
+        for (curTrg = m_Unbounded.begin(); curTrg != m_Unbounded.end(); ++curTrg)
+        {
+          TryTrigger(*curTrg, *curEnt);
         }
       }
     }
+
+    //now it's safe to take the triggers that asked to sleep out of the grid
+    TriggerVector::iterator curTrg;
+    for (curTrg = m_ToSleep.begin(); curTrg != m_ToSleep.end(); ++curTrg)
+    {
+      PutToSleep(*curTrg, (*curTrg)->NumUpdatesToSleep());
+    }
+
+    m_ToSleep.clear();
   }
   
 
 public:
 
+  TriggerSystem(double CellSize = 50.0):m_dCellSize(CellSize),
+                                        m_iNumUpdates(0)
+  {}
+
   ~TriggerSystem()
   {
     Clear();
@@ -91,6 +328,12 @@ public:
     }
 
     m_Triggers.clear();
+
+    for (int b=0; b<NumBuckets; ++b) m_Buckets[b].clear();
+
+    m_Unbounded.clear();
+    m_ToSleep.clear();
+    m_SleepQueue = SleepQueue();
   }
 
   //This method should be called each update-step of the game. It will first
@@ -104,10 +347,13 @@ public:
   }
 
   //this is used to register triggers with the TriggerSystem (the TriggerSystem
-  //will take care of tidying up memory used by a trigger)
+  //will take care of tidying up memory used by a trigger). The trigger's
+  //region of influence must be in place by the time it is registered.
   void Register(trigger_type* trigger)
   {
     m_Triggers.push_back(trigger);
+
+    InsertIntoGrid(trigger);
   }
 
   //some triggers are required to be rendered (like giver-triggers for example)
@@ -60,6 +60,24 @@ public:
     }
   }
   
+  //an inactive respawning trigger has nothing to do until its respawn
+  //counter runs out (or ever, if it doesn't respawn)
+  virtual int NumUpdatesToSleep()const
+  {
+    if (isActive()) return 0;
+
+    if (!m_bIsSpawning) return -1;
+
+    return m_iNumUpdatesRemainingUntilRespawn > 1 ? m_iNumUpdatesRemainingUntilRespawn : 1;
+  }
+
+  virtual void Wake()
+  {
+    m_iNumUpdatesRemainingUntilRespawn = 0;
+
+    SetActive();
+  }
+
   void SetRespawnDelay(unsigned int numTicks)
   {m_iNumUpdatesBetweenRespawns = numTicks;}
 };
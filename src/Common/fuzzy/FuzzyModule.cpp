@@ -7,6 +7,12 @@
 
 //------------------------------ dtor -----------------------------------------
 FuzzyModule::~FuzzyModule()
+{
+  Clear();
+}
+
+//------------------------------ Clear ----------------------------------------
+void FuzzyModule::Clear()
 {
   VarMap::iterator curVar = m_Variables.begin();
   for (curVar; curVar != m_Variables.end(); ++curVar)
@@ -19,6 +25,9 @@ FuzzyModule::~FuzzyModule()
   {
     delete *curRule;
   }
+
+  m_Variables.clear();
+  m_Rules.clear();
 }
 
 //----------------------------- AddRule ---------------------------------------
@@ -58,6 +58,9 @@ public:
 
   ~FuzzyModule();
 
+  //deletes all the variables and rules
+  void            Clear();
+
   //creates a new 'empty' fuzzy variable and returns a reference to it.
   FuzzyVariable&  CreateFLV(const std::string& VarName);
   
@@ -7,19 +7,27 @@
 //  Author: Mat Buckland (www.ai-junkie.com)
 //
 //  Desc:   class to divide a 2D space into a grid of cells each of which
-//          may contain a number of entities. Once created and initialized 
+//          may contain a number of entities. Once created and initialized
 //          with entities, fast proximity querys can be made by calling the
-//          CalculateNeighbors method with a position and proximity radius.
+//          CalculateNeighbors method with a position and proximity radius,
+//          or ForEachNeighbor with a position, radius and visitor.
 //
 //          If an entity is capable of moving, and therefore capable of moving
 //          between cells, the Update method should be called each update-cycle
 //          to sychronize the entity and the cell space it occupies
 //
+//          A query only visits the cells the query box covers, and each
+//          cell keeps its members in a vector, so emptying and refilling the
+//          cells every update doesn't allocate once they have grown to size.
+//          The position of each entity in its cell's vector is recorded, so
+//          moving one to another cell doesn't search for it.
+//
 //-----------------------------------------------------------------------------
 #pragma warning (disable:4786)
 
 #include <vector>
-#include <list>
+#include <unordered_map>
+#include <cmath>
 #include <cassert>
 
 #include "2d/Vector2D.h"
@@ -36,7 +44,7 @@ template <class entity>
 struct Cell
 {
   //all the entities inhabiting this cell
-  std::list<entity>    Members;
+  std::vector<entity>  Members;
 
   //the cell's bounding box (it's inverted because the Window's default
   //co-ordinate system has a y axis that increases as it descends)
@@ -47,7 +55,30 @@ struct Cell
   {}
 };
 
-/////////// //////////////////////////////////////////////////////////////////
+//--------------------- ChooseCellSpaceDimensions ------------------------
+//
+//  picks the number of cells across and down for a width by height space
+//  so that each cell is about CellSize across. A good CellSize is the
+//  radius of the typical query, which then covers no more than a 3x3
+//  block of cells. No more than MaxCells are used in either direction
+//------------------------------------------------------------------------
+inline void ChooseCellSpaceDimensions(double width,
+                                      double height,
+                                      double CellSize,
+                                      int&   cellsX,
+                                      int&   cellsY,
+                                      int    MaxCells = 64)
+{
+  assert (CellSize > 0 && "<ChooseCellSpaceDimensions>: bad cell size");
+
+  cellsX = (int)ceil(width  / CellSize);
+  cellsY = (int)ceil(height / CellSize);
+
+  if (cellsX < 1) cellsX = 1; else if (cellsX > MaxCells) cellsX = MaxCells;
+  if (cellsY < 1) cellsY = 1; else if (cellsY > MaxCells) cellsY = MaxCells;
+}
+
+///////////////////////////////////////////////////////////////////////////////
 //  the subdivision class
 ///////////////////////////////////////////////////////////////////////////////
 
@@ -59,8 +90,12 @@ private:
   //the required amount of cells in the space
   std::vector<Cell<entity> >               m_Cells;
 
+  //the index of each entity in its cell's Members
+  std::unordered_map<entity, int>          m_Slot;
+
   //this is used to store any valid neighbors when an agent searches
-  //its neighboring space
+  //its neighboring space. The neighbors are followed by a zero, which
+  //marks the end for the begin/next/end iteration
   std::vector<entity>                      m_Neighbors;
 
   //this iterator will be used by the methods next and begin to traverse
@@ -79,7 +114,19 @@ private:
   double  m_dCellSizeY;
 
 
-  //given a position in the game space this method determines the           
+  //the column or row of a coordinate, clamped to the grid
+  static int ClampCell(int idx, int NumCells)
+  {
+    if (idx < 0)         return 0;
+    if (idx >= NumCells) return NumCells - 1;
+
+    return idx;
+  }
+
+  int  CellX(double x)const{return ClampCell((int)floor(x / m_dCellSizeX), m_iNumCellsX);}
+  int  CellY(double y)const{return ClampCell((int)floor(y / m_dCellSizeY), m_iNumCellsY);}
+
+  //given a position in the game space this method determines the
   //relevant cell's index
   inline int  PositionToIndex(const Vector2D& pos)const;
 
@@ -89,19 +136,29 @@ public:
                      double height,       //height ...
                      int   cellsX,       //number of cells horizontally
                      int   cellsY,       //number of cells vertically
-                     int   MaxEntitys);  //maximum number of entities to add
+                     int   MaxEntitys);  //expected number of entities to add
 
   //adds entities to the class by allocating them to the appropriate cell
   inline void AddEntity(const entity& ent);
 
-  //update an entity's cell by calling this from your entity's Update method 
+  //update an entity's cell by calling this from your entity's Update method
   inline void UpdateEntity(const entity& ent, Vector2D OldPos);
 
   //this method calculates all a target's neighbors and stores them in
-  //the neighbor vector. After you have called this method use the begin, 
-  //next and end methods to iterate through the vector.
+  //the neighbor vector. After you have called this method use the begin,
+  //next and end methods (or Neighbors and NumNeighbors) to iterate through
+  //the vector.
   inline void CalculateNeighbors(Vector2D TargetPos, double QueryRadius);
 
+  //calls Visit(entity) for each entity within QueryRadius of TargetPos,
+  //without copying them anywhere
+  template <class visitor>
+  inline void ForEachNeighbor(Vector2D TargetPos, double QueryRadius, visitor Visit)const;
+
+  //the neighbors found by the last call to CalculateNeighbors
+  const entity* Neighbors()const{return &m_Neighbors[0];}
+  int           NumNeighbors()const{return (int)m_Neighbors.size() - 1;}
+
   //returns a reference to the entity at the front of the neighbor vector
   inline entity& begin(){m_curNeighbor = m_Neighbors.begin(); return *m_curNeighbor;}
 
@@ -109,11 +166,14 @@ public:
   inline entity& next(){++m_curNeighbor; return *m_curNeighbor;}
 
   //returns true if the end of the vector is found (a zero value marks the end)
-  inline bool   end(){return (m_curNeighbor == m_Neighbors.end()) || (*m_curNeighbor == 0);}   
-   
+  inline bool   end(){return (m_curNeighbor == m_Neighbors.end()) || (*m_curNeighbor == 0);}
+
   //empties the cells of entities
   void        EmptyCells();
 
+  int         NumCellsX()const{return m_iNumCellsX;}
+  int         NumCellsY()const{return m_iNumCellsY;}
+
   //call this to use the gdi to render the cell edges
   inline void RenderCells()const;
 };
@@ -127,18 +187,22 @@ CellSpacePartition<entity>::CellSpacePartition(double  width,        //width of
                                                double  height,       //height...
                                                int    cellsX,       //number of divisions horizontally
                                                int    cellsY,       //and vertically
-                                               int    MaxEntitys):  //maximum number of entities to partition
+                                               int    MaxEntitys):  //expected number of entities to partition
                   m_dSpaceWidth(width),
                   m_dSpaceHeight(height),
                   m_iNumCellsX(cellsX),
                   m_iNumCellsY(cellsY),
-                  m_Neighbors(MaxEntitys, entity())
+                  m_Neighbors(1, entity())
 {
+  assert (cellsX > 0 && cellsY > 0 && "<CellSpacePartition>: bad cell count");
+
+  m_Neighbors.reserve(MaxEntitys+1);
+
   //calculate bounds of each cell
   m_dCellSizeX = width  / cellsX;
   m_dCellSizeY = height / cellsY;
 
-  
+
   //create the cells
   for (int y=0; y<m_iNumCellsY; ++y)
   {
@@ -156,8 +220,8 @@ CellSpacePartition<entity>::CellSpacePartition(double  width,        //width of
 
 //----------------------- CalculateNeighbors ----------------------------
 //
-//  This must be called to create the vector of neighbors.This method 
-//  examines each cell within range of the target, If the 
+//  This must be called to create the vector of neighbors.This method
+//  examines each cell within range of the target, If the
 //  cells contain entities then they are tested to see if they are situated
 //  within the target's neighborhood region. If they are they are added to
 //  neighbor list
@@ -166,40 +230,49 @@ template<class entity>
 void CellSpacePartition<entity>::CalculateNeighbors(Vector2D TargetPos,
                                                     double   QueryRadius)
 {
-  //create an iterator and set it to the beginning of the neighbor vector
-  std::vector<entity>::iterator curNbor = m_Neighbors.begin();
-  
-  //create the query box that is the bounding box of the target's query
-  //area
-  InvertedAABBox2D QueryBox(TargetPos - Vector2D(QueryRadius, QueryRadius),
-                            TargetPos + Vector2D(QueryRadius, QueryRadius));
-
-  //iterate through each cell and test to see if its bounding box overlaps
-  //with the query box. If it does and it also contains entities then
-  //make further proximity tests.
-  std::vector<Cell<entity> >::iterator curCell; 
-  for (curCell=m_Cells.begin(); curCell!=m_Cells.end(); ++curCell)
+  m_Neighbors.clear();
+
+  ForEachNeighbor(TargetPos,
+                  QueryRadius,
+                  [this](const entity& ent){m_Neighbors.push_back(ent);});
+
+  //mark the end of the list with a zero.
+  m_Neighbors.push_back(entity());
+}
+
+//------------------------- ForEachNeighbor ------------------------------
+//
+//  only the cells overlapped by the bounding box of the query area are
+//  examined
+//------------------------------------------------------------------------
+template<class entity>
+template<class visitor>
+void CellSpacePartition<entity>::ForEachNeighbor(Vector2D TargetPos,
+                                                 double   QueryRadius,
+                                                 visitor  Visit)const
+{
+  const int left  = CellX(TargetPos.x - QueryRadius);
+  const int right = CellX(TargetPos.x + QueryRadius);
+  const int top   = CellY(TargetPos.y - QueryRadius);
+  const int bot   = CellY(TargetPos.y + QueryRadius);
+
+  const double RadiusSq = QueryRadius * QueryRadius;
+
+  for (int y=top; y<=bot; ++y)
   {
-    //test to see if this cell contains members and if it overlaps the
-    //query box
-    if (curCell->BBox.isOverlappedWith(QueryBox) &&
-       !curCell->Members.empty())
+    for (int x=left; x<=right; ++x)
     {
-      //add any entities found within query radius to the neighbor list
-      std::list<entity>::iterator it = curCell->Members.begin();
-      for (it; it!=curCell->Members.end(); ++it)
-      {     
-        if (Vec2DDistanceSq((*it)->Pos(), TargetPos) <
-            QueryRadius*QueryRadius)
+      const std::vector<entity>& members = m_Cells[y*m_iNumCellsX + x].Members;
+
+      for (unsigned int i=0; i<members.size(); ++i)
+      {
+        if (Vec2DDistanceSq(members[i]->Pos(), TargetPos) < RadiusSq)
         {
-          *curNbor++ = *it;
+          Visit(members[i]);
         }
-      }    
+      }
     }
-  }//next cell
-
-  //mark the end of the list with a zero.
-  *curNbor = 0;
+  }
 }
 
 
@@ -210,30 +283,26 @@ void CellSpacePartition<entity>::CalculateNeighbors(Vector2D TargetPos,
 template<class entity>
 void CellSpacePartition<entity>::EmptyCells()
 {
-  std::vector<Cell<entity> >::iterator it = m_Cells.begin();
+  typename std::vector<Cell<entity> >::iterator it = m_Cells.begin();
 
   for (it; it!=m_Cells.end(); ++it)
   {
     it->Members.clear();
   }
+
+  m_Slot.clear();
 }
 
 //--------------------- PositionToIndex ----------------------------------
 //
 //  Given a 2D vector representing a position within the game world, this
-//  method calculates an index into its appropriate cell
+//  method calculates an index into its appropriate cell. Positions outside
+//  the space are put in the closest cell
 //------------------------------------------------------------------------
 template<class entity>
 inline int CellSpacePartition<entity>::PositionToIndex(const Vector2D& pos)const
 {
-  int idx = (int)(m_iNumCellsX * pos.x / m_dSpaceWidth) + 
-            ((int)((m_iNumCellsY) * pos.y / m_dSpaceHeight) * m_iNumCellsX);
-
-  //if the entity's position is equal to vector2d(m_dSpaceWidth, m_dSpaceHeight)
-  //then the index will overshoot. We need to check for this and adjust
-  if (idx > (int)m_Cells.size()-1) idx = (int)m_Cells.size()-1;
-
-  return idx;
+  return CellY(pos.y) * m_iNumCellsX + CellX(pos.x);
 }
 
 //----------------------- AddEntity --------------------------------------
@@ -242,13 +311,14 @@ inline int CellSpacePartition<entity>::PositionToIndex(const Vector2D& pos)const
 //------------------------------------------------------------------------
 template<class entity>
 inline void CellSpacePartition<entity>::AddEntity(const entity& ent)
-{ 
+{
   assert (ent);
 
-  int sz = m_Cells.size();
-  int idx = PositionToIndex(ent->Pos());
-  
-  m_Cells[idx].Members.push_back(ent);
+  std::vector<entity>& members = m_Cells[PositionToIndex(ent->Pos())].Members;
+
+  m_Slot[ent] = (int)members.size();
+
+  members.push_back(ent);
 }
 
 //----------------------- UpdateEntity -----------------------------------
@@ -268,9 +338,33 @@ inline void CellSpacePartition<entity>::UpdateEntity(const entity&  ent,
   if (NewIdx == OldIdx) return;
 
   //the entity has moved into another cell so delete from current cell
-  //and add to new one
-  m_Cells[OldIdx].Members.remove(ent);
-  m_Cells[NewIdx].Members.push_back(ent);
+  //(by swapping it with the last member) and add to new one
+  std::vector<entity>& members = m_Cells[OldIdx].Members;
+
+  typename std::unordered_map<entity, int>::iterator slot = m_Slot.find(ent);
+
+  if (slot != m_Slot.end())
+  {
+    int idx = slot->second;
+
+    assert (idx < (int)members.size() && members[idx] == ent &&
+            "<CellSpacePartition::UpdateEntity>: OldPos is not in the entity's cell");
+
+    members[idx] = members.back();
+    m_Slot[members[idx]] = idx;
+
+    members.pop_back();
+  }
+  else
+  {
+    slot = m_Slot.insert(std::make_pair(ent, 0)).first;
+  }
+
+  std::vector<entity>& NewMembers = m_Cells[NewIdx].Members;
+
+  slot->second = (int)NewMembers.size();
+
+  NewMembers.push_back(ent);
 }
 
 //-------------------------- RenderCells -----------------------------------
@@ -278,11 +372,11 @@ inline void CellSpacePartition<entity>::UpdateEntity(const entity&  ent,
 template<class entity>
 inline void CellSpacePartition<entity>::RenderCells()const
 {
-  std::vector<Cell<entity> >::const_iterator curCell;
+  typename std::vector<Cell<entity> >::const_iterator curCell;
   for (curCell=m_Cells.begin(); curCell!=m_Cells.end(); ++curCell)
   {
     curCell->BBox.Render(false);
   }
 }
 
-#endif
\ No newline at end of file
+#endif
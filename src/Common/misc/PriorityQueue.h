@@ -361,6 +361,9 @@ public:
 
   bool empty()const{return (m_iSize==0);}
 
+  //empties the queue (the keys are left untouched)
+  void clear(){m_iSize = 0;}
+
   //to insert an item into the queue it gets added to the end of the heap
   //and then the heap is reordered from the bottom up.
   void insert(const int idx)
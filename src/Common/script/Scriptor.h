@@ -3,58 +3,149 @@
 #include <iostream>
 #include <fstream>
 #include <unordered_map>
+#include <vector>
 #include <string>
 #include <stdexcept>
-#include <regex>
-#include <algorithm>
+#include <cstdlib>
+#include <cctype>
 
+// Reads "name = value" parameters from a text file. Lines starting with '#'
+// or '[' are ignored, a value is either a quoted string or a run of word
+// characters (anything after it on the line is ignored).
+//
+// The file is parsed once, and each value is converted to every type it can
+// be read as at that point. A parameter can be read by name or, for code
+// that reads it often, through the integer handle returned by GetHandle,
+// which is a plain array access.
 class Scriptor {
 private:
-    std::unordered_map<std::string, std::string> params;
+    struct Value {
+        std::string String;
+        double      Double;
+        int         Int;
+        bool        Bool;
+    };
+
+    std::unordered_map<std::string, int> handles;
+    std::vector<Value>                   values;
+
+    static bool isWordChar(char c) {
+        return std::isalnum((unsigned char)c) || c == '_';
+    }
+
+    // parses a single line, adding its parameter if it holds one
+    void ParseLine(const std::string& line) {
+        std::string::size_type i = 0, end = line.size();
+
+        while (i < end && std::isspace((unsigned char)line[i])) ++i;
+
+        if (i == end || line[i] == '#' || line[i] == '[') return;
+
+        std::string::size_type nameStart = i;
+        while (i < end && isWordChar(line[i])) ++i;
+        if (i == nameStart) return;
+
+        std::string name(line, nameStart, i - nameStart);
+
+        while (i < end && std::isspace((unsigned char)line[i])) ++i;
+        if (i == end || line[i] != '=') return;
+        ++i;
+        while (i < end && std::isspace((unsigned char)line[i])) ++i;
+        if (i == end) return;
+
+        std::string value;
+
+        if (line[i] == '"') {
+            std::string::size_type close = line.rfind('"');
+            if (close == i) return;
+            value.assign(line, i + 1, close - i - 1);
+        }
+        else {
+            std::string::size_type valueStart = i;
+            if (line[i] == '-') ++i;
+            while (i < end && (isWordChar(line[i]) || line[i] == '.')) ++i;
+            if (i == valueStart) return;
+            value.assign(line, valueStart, i - valueStart);
+        }
+
+        Set(name, value);
+    }
+
+    const Value& Lookup(const std::string& name) const {
+        std::unordered_map<std::string, int>::const_iterator it = handles.find(name);
+        if (it == handles.end()) {
+            throw std::runtime_error("Unknown parameter: " + name);
+        }
+        return values[it->second];
+    }
+
+protected:
+    // adds the parameter or overwrites its value
+    void Set(const std::string& name, const std::string& str) {
+        Value v;
+        v.String = str;
+        v.Double = std::atof(str.c_str());
+        v.Int    = std::atoi(str.c_str());
+        v.Bool   = (str == "true") || v.Int != 0;
+
+        std::unordered_map<std::string, int>::const_iterator it = handles.find(name);
+        if (it == handles.end()) {
+            handles[name] = (int)values.size();
+            values.push_back(v);
+        }
+        else {
+            values[it->second] = v;
+        }
+    }
 
 public:
-    Scriptor(std::string fileName) {
-        std::ifstream file(fileName, std::ios::app);
+    Scriptor(const std::string& fileName) {
+        std::ifstream file(fileName.c_str());
         if (!file.is_open()) {
             throw std::runtime_error("Parameters' file not open.");
         }
 
         std::string line;
         while (std::getline(file, line)) {
-            const std::string s(line);
-            const std::regex param("(\\w+)\\s*=\\s*(?:([\\w\\.]+)|\\\"(.+)\\\")");
-            std::smatch match;
-            if (std::regex_search(s.begin(), s.end(), match, param)) {
-                if (std::string(match[2]).size() > 0) {
-                    params[match[1]] = match[2];
-                }
-                else {
-                    params[match[1]] = match[3];
-                }
-            }
+            ParseLine(line);
         }
 
         file.close();
     }
 
-    int GetInt(std::string name) {
-        return std::atoi(params[name].c_str());
+    // returns the handle of the named parameter, or -1 if there isn't one
+    int GetHandle(const std::string& name) const {
+        std::unordered_map<std::string, int>::const_iterator it = handles.find(name);
+        return it == handles.end() ? -1 : it->second;
+    }
+
+    bool HasParam(const std::string& name) const {
+        return GetHandle(name) >= 0;
+    }
+
+    int         GetInt(int handle) const             { return values[handle].Int; }
+    float       GetFloat(int handle) const           { return (float)values[handle].Double; }
+    double      GetDouble(int handle) const          { return values[handle].Double; }
+    const std::string& GetString(int handle) const   { return values[handle].String; }
+    bool        GetBool(int handle) const            { return values[handle].Bool; }
+
+    int GetInt(const std::string& name) const {
+        return Lookup(name).Int;
     }
 
-    float GetFloat(std::string name) {
-        return std::stof(params[name].c_str());
+    float GetFloat(const std::string& name) const {
+        return (float)Lookup(name).Double;
     }
 
-    double GetDouble(std::string name) {
-        return std::stod(params[name].c_str());
+    double GetDouble(const std::string& name) const {
+        return Lookup(name).Double;
     }
 
-    std::string GetString(std::string name) {
-        return params[name];
+    std::string GetString(const std::string& name) const {
+        return Lookup(name).String;
     }
 
-    bool GetBool(std::string name) {
-        std::string t("true");
-        return t.compare(params[name]) == 0 || std::atoi(params[name].c_str());
+    bool GetBool(const std::string& name) const {
+        return Lookup(name).Bool;
     }
 };